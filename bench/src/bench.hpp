@@ -0,0 +1,29 @@
+#pragma once
+// === HEADER ONLY ===
+
+#include <chrono>
+#include <cstddef>
+
+namespace bench {
+
+    // Hides `value` from the optimiser, so the work producing it is kept.
+    template <typename T>
+    inline void keep(const T& value) { asm volatile("" : : "g"(&value) : "memory"); }
+
+    /**
+     * Nanoseconds per operation.
+     * Repeats `body`, which performs `ops` operations per call, for at least `min_time`.
+     */
+    template <typename Body>
+    double ns_per_op(const std::size_t ops, Body&& body,
+                     const std::chrono::milliseconds min_time = std::chrono::milliseconds(200)) {
+        using clock = std::chrono::steady_clock;
+        body(); // Warm-up
+        std::size_t calls = 0;
+        const auto start = clock::now();
+        auto elapsed = clock::duration::zero();
+        do { body(); ++calls; elapsed = clock::now() - start; } while (elapsed < min_time);
+        return std::chrono::duration<double, std::nano>(elapsed).count() / double(calls * ops);
+    }
+
+}; // namespace bench
@@ -0,0 +1,87 @@
+#include <vector>
+#include <random>
+#include <fstream>
+#include <cstdio>
+
+#include "debug.hpp"
+#include "column_file.hpp"
+#include "bench.hpp"
+
+static constexpr auto src = "column_file:BENCH";
+using namespace std;
+using namespace dattatypes;
+
+enum class State : uint32_t {};
+
+
+// Benchmark: loading prec32 and Flags columns value by value, in bulk, and through the mapping
+int main() {
+    LOG_INFO("=== Benchmarking column files ===");
+
+    constexpr size_t n = size_t(1) << 24, page = 4096;
+    const string path = "column_file_bench.cols", archive = "column_file_bench.bin";
+    mt19937_64 rng(1);
+    vector<prec32> prices(n);
+    vector<Flags<State>> states(n);
+    for (size_t i = 0; i < n; ++i) {
+        prices[i]._data = int32_t(rng());
+        states[i] = State(uint32_t(rng()));
+    }
+    {
+        ColumnWriter writer(path);
+        writer.column<prec32>("price");
+        for (size_t first = 0; first < n; first += n / 16) writer.append<prec32>(span(prices).subspan(first, n / 16));
+        writer.column<Flags<State>>("state");
+        writer.append<Flags<State>>(states);
+        ofstream out(archive, ios::binary);
+        for (const auto& p : prices) out.write(reinterpret_cast<const char*>(&p._data), sizeof(p._data));
+        for (const auto& s : states) { const auto raw = s.underlying(); out.write(reinterpret_cast<const char*>(&raw), sizeof(raw)); }
+    }
+    const size_t bytes = n * (sizeof(prec32) + sizeof(Flags<State>));
+
+    // Like a binary archive: one read per value
+    const double per_value = bench::ns_per_op(bytes, [&] {
+        ifstream in(archive, ios::binary);
+        vector<prec32> p(n);
+        vector<Flags<State>> s(n);
+        for (auto& v : p) in.read(reinterpret_cast<char*>(&v._data), sizeof(v._data));
+        for (auto& v : s) { uint32_t raw; in.read(reinterpret_cast<char*>(&raw), sizeof(raw)); v = State(raw); }
+        bench::keep(p); bench::keep(s);
+    });
+    const double bulk = bench::ns_per_op(bytes, [&] {
+        ifstream in(archive, ios::binary);
+        vector<prec32> p(n);
+        vector<Flags<State>> s(n);
+        in.read(reinterpret_cast<char*>(p.data()), streamsize(n * sizeof(prec32)));
+        in.read(reinterpret_cast<char*>(s.data()), streamsize(n * sizeof(Flags<State>)));
+        bench::keep(p); bench::keep(s);
+    });
+    // Opening, then touching every page of both columns
+    const double mapped = bench::ns_per_op(bytes, [&] {
+        ColumnFile file(path);
+        const auto p = file.prec<prec32>("price");
+        const auto s = file.flags<State>("state");
+        int64_t touched = 0;
+        for (size_t i = 0; i < n; i += page / sizeof(prec32)) touched += p[i]._data + int64_t(s[i].underlying());
+        bench::keep(touched);
+    });
+    const double populated = bench::ns_per_op(bytes, [&] {
+        ColumnFile file(path, true);
+        bench::keep(file.prec<prec32>("price"));
+    });
+    const double open_only = bench::ns_per_op(1, [&] {
+        ColumnFile file(path);
+        bench::keep(file.prec<prec32>("price"));
+    });
+
+    LOG_INFO("{} MB of prec32 and Flags<State> columns, from the page cache", bytes >> 20);
+    LOG_INFO("one read per value:          {} GB/s", 1 / per_value);
+    LOG_INFO("bulk read into vectors:      {} GB/s", 1 / bulk);
+    LOG_INFO("ColumnFile, touching pages:  {} GB/s", 1 / mapped);
+    LOG_INFO("ColumnFile, MAP_POPULATE:    {} GB/s", 1 / populated);
+    LOG_INFO("ColumnFile, open only:       {} us", open_only / 1e3);
+
+    remove(path.c_str());
+    remove(archive.c_str());
+    return 0;
+}
@@ -0,0 +1,72 @@
+#include <vector>
+#include <random>
+#include <thread>
+#include <mutex>
+#include <atomic>
+#include <chrono>
+
+#include "debug.hpp"
+#include "concurrent_unlock_map.hpp"
+#include "bench.hpp"
+
+static constexpr auto src = "concurrent_unlock_map:BENCH";
+using namespace std;
+using namespace dattatypes;
+
+enum class Item : int32_t {};
+
+constexpr size_t checks = size_t(1) << 20;
+
+
+// Millions of checks per second over `readers` threads of `checks` each, while a writer grants and revokes an item every 100 us
+template <typename Check, typename Write>
+double mchecks_per_s(const size_t readers, const vector<int32_t>& keys, Check&& check, Write&& write) {
+    atomic<bool> done{false};
+    atomic<size_t> running{readers};
+    thread writer([&] {
+        for (int32_t k = 0; running.load() > 0; ++k) {
+            write(k);
+            this_thread::sleep_for(chrono::microseconds(100));
+        }
+    });
+    const auto start = chrono::steady_clock::now();
+    vector<thread> threads;
+    for (size_t r = 0; r < readers; ++r)
+        threads.emplace_back([&, r] {
+            size_t found = 0;
+            for (size_t i = 0; i < checks; ++i) found += check(Item(keys[(i + r * 4099) % keys.size()]));
+            bench::keep(found);
+            --running;
+        });
+    for (auto& t : threads) t.join();
+    const double seconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+    writer.join();
+    return double(readers * checks) / seconds / 1e6;
+}
+
+
+// Benchmark: read scaling of the lock-free snapshots against an unlock_map behind a mutex
+int main() {
+    LOG_INFO("=== Benchmarking concurrent_unlock_map ===");
+    mt19937_64 rng(1);
+    unlock_map<Item> base;
+    for (int32_t i = 0; i < 2048; ++i) base.insert(Item(64 * i), Item(64 * i + 31));
+    vector<int32_t> keys(1 << 16);
+    for (auto& k : keys) k = int32_t(rng() % (64 * 2048));
+
+    concurrent_unlock_map<Item> shared(base);
+    unlock_map<Item> locked = base;
+    mutex lock;
+    const size_t most = std::max(4u, thread::hardware_concurrency());
+    LOG_INFO("{} hardware threads", thread::hardware_concurrency());
+    for (size_t readers = 1; readers <= most; readers *= 2) {
+        const double lock_free = mchecks_per_s(readers, keys,
+            [&](Item item) { return shared.check(item); },
+            [&](int32_t k) { shared.update([k](auto& map) { map.insert(Item(64 * k + 40)); map.erase(Item(64 * k + 40)); }); });
+        const double mutexed = mchecks_per_s(readers, keys,
+            [&](Item item) { lock_guard guard(lock); return locked.check(item); },
+            [&](int32_t k) { lock_guard guard(lock); locked.insert(Item(64 * k + 40)); locked.erase(Item(64 * k + 40)); });
+        LOG_INFO("{} readers: snapshots {} M checks/s, mutex {} M checks/s", readers, lock_free, mutexed);
+    }
+    return 0;
+}
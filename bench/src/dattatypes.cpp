@@ -0,0 +1,391 @@
+#include <vector>
+#include <random>
+#include <string>
+#include <string_view>
+#include <fstream>
+#include <iostream>
+#include <charconv>
+#include <cmath>
+#include <map>
+#include <memory_resource>
+#include <memory>
+#include <algorithm>
+#include <span>
+
+#include "debug.hpp"
+#include "prec_utils.hpp"
+#include "unlock_map.hpp"
+#include "internal_ptr.hpp"
+#include "enum_flags.hpp"
+#include "bench.hpp"
+
+static constexpr auto src = "dattatypes:BENCH";
+using namespace std;
+using namespace dattatypes;
+
+/**
+ * The benchmark suite: every Prec alias against float, double and int, unlock_map, internal_ptr and Flags.
+ *
+ * Usage: dattatypes_bench [--format json|csv] [--output FILE] [--baseline FILE]
+ *                         [--threshold PERCENT] [--min-time MS] [--filter TEXT]
+ *
+ * Writes one result per case, in nanoseconds per operation, to FILE or stdout.
+ * With a baseline (a previous output, in either format), every case also gets its change against the
+ * baseline, and the exit code is 1 if any case got slower by more than the threshold (10% by default).
+ */
+
+constexpr size_t n = 4096;  // Values per call of a timed body
+
+struct Suite {
+    chrono::milliseconds min_time{50};
+    string filter;
+    vector<pair<string, double>> results;
+
+    // Times `body`, which performs `ops` operations, unless the name does not match the filter
+    template <typename Body>
+    void run(const string& name, const size_t ops, Body&& body) {
+        if (!filter.empty() && name.find(filter) == string::npos) return;
+        results.emplace_back(name, bench::ns_per_op(ops, body, min_time));
+    }
+};
+
+
+// Random values of T in a quarter of its range, so sums and differences never overflow; positive and non-zero for divisors
+template <typename T>
+T random_value(mt19937_64& rng, const bool positive) {
+    if constexpr (is_floating_point_v<T>) {
+        const T value = T(uniform_real_distribution<double>(0.5, 1000)(rng));
+        return (positive || (rng() & 1)) ? value : -value;
+    }
+    else if constexpr (is_integral_v<T>) {
+        constexpr int bits = 8 * sizeof(T);
+        T value = is_signed_v<T> ? T(int64_t(rng()) >> (66 - bits)) : T(rng() >> (66 - bits));
+        if constexpr (is_signed_v<T>) if (positive && value < 0) value = T(-value);
+        return positive ? T(value | 1) : value;
+    }
+    else {
+        T value;
+        value._data = random_value<typename T::value_type>(rng, positive);
+        return value;
+    }
+}
+
+template <typename T>
+vector<T> random_values(mt19937_64& rng, const bool positive = false) {
+    vector<T> values(n);
+    for (auto& v : values) v = random_value<T>(rng, positive);
+    return values;
+}
+
+// Square roots, where T has one
+template <typename T>
+T root(const T value) {
+    if constexpr (is_floating_point_v<T>) return std::sqrt(value);
+    else return dattatypes::sqrt(value);
+}
+
+// Operators, conversions to and from double, and the square root where T has one
+template <typename T>
+void arithmetic(Suite& suite, const string& name, mt19937_64& rng) {
+    const vector<T> a = random_values<T>(rng), b = random_values<T>(rng, true);
+    vector<T> c(n);
+    vector<double> d(n);
+    for (size_t i = 0; i < n; ++i) d[i] = double(a[i]);
+
+    suite.run(name + "/add", n, [&] { for (size_t i = 0; i < n; ++i) c[i] = a[i] + b[i]; bench::keep(c); });
+    suite.run(name + "/sub", n, [&] { for (size_t i = 0; i < n; ++i) c[i] = a[i] - b[i]; bench::keep(c); });
+    suite.run(name + "/mul", n, [&] { for (size_t i = 0; i < n; ++i) c[i] = a[i] * b[i]; bench::keep(c); });
+    suite.run(name + "/div", n, [&] { for (size_t i = 0; i < n; ++i) c[i] = a[i] / b[i]; bench::keep(c); });
+    suite.run(name + "/from_double", n, [&] { for (size_t i = 0; i < n; ++i) c[i] = T(d[i]); bench::keep(c); });
+    suite.run(name + "/to_double", n, [&] { for (size_t i = 0; i < n; ++i) d[i] = double(b[i]); bench::keep(d); });
+    if constexpr (!is_integral_v<T>)
+        suite.run(name + "/sqrt", n, [&] { for (size_t i = 0; i < n; ++i) c[i] = root(b[i]); bench::keep(c); });
+}
+
+
+enum class Key : int32_t {};
+
+/**
+ * Check, one by one and in batches, rank and select, and an erase splitting an interval with the insert joining it again, against maps of `intervals` intervals
+ * [stride * i, stride * i + stride / 2), and their union with another such map.
+ * Stride 8 is fragmented enough for the bitmap, stride 1024 keeps the intervals.
+ */
+void unlock_map_cases(Suite& suite, const string& name, const int32_t stride, const size_t intervals, mt19937_64& rng) {
+    unlock_map<Key> map;
+    for (size_t i = 0; i < intervals; ++i) map.insert(Key(stride * int32_t(i)), Key(stride * int32_t(i) + stride / 2 - 1));
+    vector<int32_t> keys(n), inner(n);
+    uniform_int_distribution<int32_t> dist(0, int32_t(stride * int32_t(intervals) - 1));
+    for (auto& k : keys) k = dist(rng);
+    for (auto& k : inner) k = (dist(rng) & ~(stride - 1)) | 1;
+
+    const string size = "/" + to_string(intervals);
+    suite.run(name + "/check" + size, n, [&] {
+        size_t found = 0;
+        for (const auto k : keys) found += map.check(Key(k));
+        bench::keep(found);
+    });
+    // Batch checks on the search layout, after which check uses it too
+    vector<Key> items(keys.size());
+    std::transform(keys.begin(), keys.end(), items.begin(), [](const int32_t k) { return Key(k); });
+    unique_ptr<bool[]> results(new bool[n]);
+    suite.run(name + "/check_batch" + size, n, [&] { map.check_batch(items, span<bool>(results.get(), n)); bench::keep(results); });
+    suite.run(name + "/check_after_batch" + size, n, [&] {
+        size_t found = 0;
+        for (const auto k : keys) found += map.check(Key(k));
+        bench::keep(found);
+    });
+    suite.run(name + "/rank" + size, n, [&] {
+        size_t sum = 0;
+        for (const auto k : keys) sum += map.rank(Key(k));
+        bench::keep(sum);
+    });
+    suite.run(name + "/select" + size, n, [&] {
+        int64_t sum = 0;
+        for (const auto k : keys) sum += int32_t(map.select(size_t(k) % map.size()));
+        bench::keep(sum);
+    });
+    suite.run(name + "/erase_insert" + size, 2 * n, [&] {
+        for (const auto k : inner) { map.erase(Key(k)); map.insert(Key(k)); }
+        bench::keep(map);
+    });
+
+    // Union with the intervals shifted by a quarter stride, merged against inserted one by one
+    if (intervals > 4096) return;
+    unlock_map<Key> other;
+    for (size_t i = 0; i < intervals; ++i) other.insert(Key(stride * int32_t(i) + stride / 4), Key(stride * int32_t(i) + stride * 3 / 4));
+    const vector<int32_t> other_intervals = other.intervals();
+    suite.run(name + "/union" + size, intervals, [&] { bench::keep(map | other); });
+    suite.run(name + "/union_by_insert" + size, intervals, [&] {
+        unlock_map<Key> result = map;
+        for (size_t i = 0; i + 1 < other_intervals.size(); i += 2) result.insert(Key(other_intervals[i]), Key(other_intervals[i + 1] - 1));
+        bench::keep(result);
+    });
+}
+
+// Loading a saved list of `items` unlocked keys in random order: from_unsorted against one insert per key
+void unlock_map_load(Suite& suite, const size_t items, mt19937_64& rng) {
+    vector<Key> saved(items);
+    for (auto& k : saved) k = Key(int32_t(rng() >> 34));
+    const string size = "/" + to_string(items);
+    suite.run("unlock_map/from_unsorted" + size, items, [&] { bench::keep(unlock_map<Key>::from_unsorted(saved)); });
+    suite.run("unlock_map/insert_each" + size, items, [&] {
+        unlock_map<Key> map;
+        for (const Key k : saved) map.insert(k);
+        bench::keep(map);
+    });
+}
+
+// Building, and checking across, `worlds` maps of three intervals each: on the heap, inline, and inline over an arena
+template <typename Map, typename... Args>
+void unlock_map_worlds(Suite& suite, const string& name, const size_t worlds, const vector<int32_t>& keys, Args&&... args) {
+    const string size = "/" + to_string(worlds);
+    vector<Map> maps;
+    auto build = [&] {
+        maps.clear();
+        maps.reserve(worlds);
+        for (size_t w = 0; w < worlds; ++w) {
+            Map& map = maps.emplace_back(args...);
+            const int32_t base = int32_t(w % 64);
+            for (int32_t i = 0; i < 3; ++i) map.insert(Key(base + 400 * i), Key(base + 400 * i + 99));
+        }
+        bench::keep(maps);
+    };
+    build();
+    suite.run("unlock_map/worlds/" + name + "/build" + size, worlds, build);
+    suite.run("unlock_map/worlds/" + name + "/check" + size, keys.size(), [&] {
+        size_t found = 0;
+        for (size_t i = 0; i < keys.size(); ++i) found += maps[i % worlds].check(Key(keys[i]));
+        bench::keep(found);
+    });
+}
+
+void unlock_map_worlds(Suite& suite, const size_t worlds, mt19937_64& rng) {
+    vector<int32_t> keys(n);
+    for (auto& k : keys) k = int32_t(rng() % 1200);
+    unlock_map_worlds<unlock_map<Key>>(suite, "heap", worlds, keys);
+    unlock_map_worlds<unlock_map<Key, 6>>(suite, "inline", worlds, keys);
+    std::pmr::monotonic_buffer_resource arena;
+    unlock_map_worlds<dattatypes::pmr::unlock_map<Key>>(suite, "arena", worlds, keys, &arena);
+}
+
+// Saving and loading `intervals` close intervals with the compact encoding, and walking them without copies
+void unlock_map_codec(Suite& suite, const size_t intervals, mt19937_64& rng) {
+    unlock_map<Key> map;
+    for (int32_t i = 0, start = 0; i < int32_t(intervals); ++i, start += 100 + int32_t(rng() % 400)) map.insert(Key(start), Key(start + int32_t(rng() % 50)));
+    const string size = "/" + to_string(intervals);
+    vector<uint8_t> bytes = map.encode();
+    suite.run("unlock_map/encode" + size, intervals, [&] { bytes.clear(); map.encode(bytes); bench::keep(bytes); });
+    LOG_INFO("{} intervals: {} bytes encoded, {} as endpoints", intervals, bytes.size(), map.intervals().size() * sizeof(int32_t));
+    unlock_map<Key> loaded;
+    suite.run("unlock_map/decode" + size, intervals, [&] { loaded.decode(bytes); bench::keep(loaded); });
+    suite.run("unlock_map/covered_values" + size, map.size(), [&] {
+        int64_t sum = 0;
+        for (const Key k : map.covered_values()) sum += int32_t(k);
+        bench::keep(sum);
+    });
+    suite.run("unlock_map/intervals_copy" + size, map.size(), [&] {
+        int64_t sum = 0;
+        const vector<int32_t> endpoints = map.intervals();
+        for (size_t i = 0; i < endpoints.size(); i += 2)
+            for (int32_t k = endpoints[i]; k < endpoints[i + 1]; ++k) sum += k;
+        bench::keep(sum);
+    });
+}
+
+
+struct Node {
+    internal_ref<Node> _ref;
+    int _value = 0;
+};
+
+// Swapping two targets of pointers, with `registry` pointers alive, half of them to the swapped targets
+void internal_ptr_cases(Suite& suite, const size_t registry) {
+    Node a, b;
+    vector<internal_ptr<Node>> pointers(registry);
+    for (size_t i = 0; i < registry; ++i)
+        if (i % 4 == 0) pointers[i].set_target(&a._ref);
+        else if (i % 4 == 1) pointers[i].set_target(&b._ref);
+    suite.run("internal_ptr/swap/" + to_string(registry), 1, [&] { std::swap(a, b); bench::keep(a); });
+}
+
+
+enum class Bits : uint32_t {};
+
+void flags_cases(Suite& suite, mt19937_64& rng) {
+    vector<Flags<Bits>> flags(n);
+    vector<Bits> masks(n);
+    for (auto& m : masks) m = Bits(uint32_t(rng()));
+    suite.run("flags/set", n, [&] { for (size_t i = 0; i < n; ++i) flags[i].set(masks[i]); bench::keep(flags); });
+    suite.run("flags/unset", n, [&] { for (size_t i = 0; i < n; ++i) flags[i].unset(masks[i]); bench::keep(flags); });
+    suite.run("flags/flip", n, [&] { for (size_t i = 0; i < n; ++i) flags[i].flip(masks[i]); bench::keep(flags); });
+    suite.run("flags/check", n, [&] {
+        size_t set = 0;
+        for (size_t i = 0; i < n; ++i) set += flags[i].check(masks[i]);
+        bench::keep(set);
+    });
+}
+
+
+// Results of a previous run, from JSON or CSV as written below
+map<string, double> read_results(const string& path) {
+    ifstream file(path);
+    if (!file) throw runtime_error("baseline should be a readable file: " + path);
+    map<string, double> results;
+    for (string line; getline(file, line); ) {
+        string_view name, value;
+        if (const size_t key = line.find("\"name\": \""); key != string::npos) {
+            const size_t first = key + 9, last = line.find('"', first), number = line.find("\"ns_per_op\": ");
+            if (last == string::npos || number == string::npos) continue;
+            name = string_view(line).substr(first, last - first);
+            value = string_view(line).substr(number + 13);
+        }
+        else if (const size_t comma = line.find(','); comma != string::npos) {
+            name = string_view(line).substr(0, comma);
+            value = string_view(line).substr(comma + 1);
+        }
+        double ns;
+        if (!name.empty() && from_chars(value.data(), value.data() + value.size(), ns).ec == errc())
+            results.emplace(string(name), ns);
+    }
+    return results;
+}
+
+void write_results(ostream& out, const string& format, const Suite& suite, const map<string, double>& baseline) {
+    const bool compare = !baseline.empty();
+    if (format == "csv") out << "name,ns_per_op" << (compare ? ",baseline_ns_per_op,change" : "") << '\n';
+    else out << "{\n  \"compiler\": \"" << __VERSION__ << "\",\n  \"results\": [\n";
+    for (size_t i = 0; i < suite.results.size(); ++i) {
+        const auto& [name, ns] = suite.results[i];
+        const auto old = baseline.find(name);
+        const bool known = (old != baseline.end());
+        if (format == "csv") {
+            out << name << ',' << ns;
+            if (compare) {
+                if (known) out << ',' << old->second << ',' << ns / old->second - 1;
+                else out << ",,";
+            }
+        }
+        else {
+            out << "    {\"name\": \"" << name << "\", \"ns_per_op\": " << ns;
+            if (known) out << ", \"baseline_ns_per_op\": " << old->second << ", \"change\": " << ns / old->second - 1;
+            out << '}' << (i + 1 < suite.results.size() ? "," : "");
+        }
+        out << '\n';
+    }
+    if (format != "csv") out << "  ]\n}\n";
+}
+
+
+int main(int argc, char** argv) {
+    Suite suite;
+    string format = "json", output = "-", baseline_path;
+    double threshold = 10;
+    for (int i = 1; i + 1 < argc; i += 2) {
+        const string_view option = argv[i];
+        const string value = argv[i + 1];
+        if (option == "--format") format = value;
+        else if (option == "--output") output = value;
+        else if (option == "--baseline") baseline_path = value;
+        else if (option == "--threshold") threshold = stod(value);
+        else if (option == "--min-time") suite.min_time = chrono::milliseconds(stoi(value));
+        else if (option == "--filter") suite.filter = value;
+        else { LOG_ERROR("Unknown option {}", option); return 2; }
+    }
+    if ((argc % 2) == 0 || (format != "json" && format != "csv")) {
+        LOG_ERROR("Usage: {} [--format json|csv] [--output FILE] [--baseline FILE] [--threshold PERCENT] [--min-time MS] [--filter TEXT]", argv[0]);
+        return 2;
+    }
+    const map<string, double> baseline = baseline_path.empty() ? map<string, double>{} : read_results(baseline_path);
+
+    mt19937_64 rng(1);
+    arithmetic<prec8>(suite, "prec8", rng);
+    arithmetic<prec16>(suite, "prec16", rng);
+    arithmetic<prec32>(suite, "prec32", rng);
+    arithmetic<prec64>(suite, "prec64", rng);
+    arithmetic<u_prec8>(suite, "u_prec8", rng);
+    arithmetic<u_prec16>(suite, "u_prec16", rng);
+    arithmetic<u_prec32>(suite, "u_prec32", rng);
+    arithmetic<u_prec64>(suite, "u_prec64", rng);
+    arithmetic<unit8>(suite, "unit8", rng);
+    arithmetic<unit16>(suite, "unit16", rng);
+    arithmetic<unit32>(suite, "unit32", rng);
+    arithmetic<unit64>(suite, "unit64", rng);
+    arithmetic<u_unit8>(suite, "u_unit8", rng);
+    arithmetic<u_unit16>(suite, "u_unit16", rng);
+    arithmetic<u_unit32>(suite, "u_unit32", rng);
+    arithmetic<u_unit64>(suite, "u_unit64", rng);
+    arithmetic<angle8>(suite, "angle8", rng);
+    arithmetic<angle16>(suite, "angle16", rng);
+    arithmetic<angle32>(suite, "angle32", rng);
+    arithmetic<angle64>(suite, "angle64", rng);
+    arithmetic<prob8>(suite, "prob8", rng);
+    arithmetic<prob16>(suite, "prob16", rng);
+    arithmetic<prob32>(suite, "prob32", rng);
+    arithmetic<prob64>(suite, "prob64", rng);
+    arithmetic<float>(suite, "float", rng);
+    arithmetic<double>(suite, "double", rng);
+    arithmetic<int32_t>(suite, "int32", rng);
+    arithmetic<int64_t>(suite, "int64", rng);
+
+    for (size_t intervals : {16, 256, 4096, 65536}) unlock_map_cases(suite, "unlock_map", 8, intervals, rng);
+    for (size_t intervals : {16, 256, 4096, 65536}) unlock_map_cases(suite, "unlock_map/sparse", 1024, intervals, rng);
+    for (size_t items : {1024, 16384}) unlock_map_load(suite, items, rng);
+    unlock_map_worlds(suite, 4096, rng);
+    unlock_map_codec(suite, 4096, rng);
+    for (size_t registry : {16, 256, 4096, 16384}) internal_ptr_cases(suite, registry);
+    flags_cases(suite, rng);
+
+    if (output == "-") write_results(cout, format, suite, baseline);
+    else {
+        ofstream file(output);
+        write_results(file, format, suite, baseline);
+    }
+
+    size_t regressions = 0;
+    for (const auto& [name, ns] : suite.results)
+        if (const auto old = baseline.find(name); old != baseline.end() && ns > old->second * (1 + threshold / 100)) {
+            LOG_ERROR("Regression: {} takes {} ns, was {} ns", name, ns, old->second);
+            ++regressions;
+        }
+    return regressions ? 1 : 0;
+}
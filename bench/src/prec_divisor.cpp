@@ -0,0 +1,48 @@
+#include <vector>
+#include <random>
+#include <ratio>
+
+#include "debug.hpp"
+#include "prec_divisor.hpp"
+#include "bench.hpp"
+
+static constexpr auto src = "prec_divisor:BENCH";
+using namespace std;
+using namespace dattatypes;
+
+
+// x / divisor and x * 3 / 5 with the operators, against div_by and mul_by in scalar and batch
+template <PrecType P>
+void bench_type(const string& name, mt19937_64& rng) {
+    using T = typename P::value_type;
+    constexpr size_t n = 1 << 14;
+    vector<P> x(n), y(n);
+    for (auto& v : x) v._data = T(rng() >> 2);
+    volatile int runtime_divisor = 10, runtime_denominator = 5;  // Constants the compiler cannot see, like a tick rate read at startup
+    const int divisor = runtime_divisor, denominator = runtime_denominator;
+
+    const double op_div = bench::ns_per_op(n, [&] { for (size_t i = 0; i < n; ++i) y[i] = x[i] / divisor; bench::keep(y); });
+    const double scalar_div = bench::ns_per_op(n, [&] { for (size_t i = 0; i < n; ++i) y[i] = div_by<10>(x[i]); bench::keep(y); });
+    const double batch_div = bench::ns_per_op(n, [&] { div_by<10, P>(x, y); bench::keep(y); });
+    const double op_ratio = bench::ns_per_op(n, [&] {
+        for (size_t i = 0; i < n; ++i) y[i] = P::narrow(typename P::product_type(x[i]._data) * 3 / denominator);
+        bench::keep(y);
+    });
+    const double scalar_ratio = bench::ns_per_op(n, [&] { for (size_t i = 0; i < n; ++i) y[i] = mul_by<ratio<3, 5>>(x[i]); bench::keep(y); });
+    const double batch_ratio = bench::ns_per_op(n, [&] { mul_by<ratio<3, 5>, P>(x, y); bench::keep(y); });
+
+    LOG_INFO("{}: x / 10 at runtime {} ns, div_by<10> {} ns, batch {} ns; x * 3 / 5 at runtime {} ns, mul_by<3/5> {} ns, batch {} ns",
+             name, op_div, scalar_div, batch_div, op_ratio, scalar_ratio, batch_ratio);
+}
+
+
+// Benchmark: division by constants
+int main() {
+    LOG_INFO("=== Benchmarking constant divisors for Prec ===");
+    mt19937_64 rng(1);
+    bench_type<unit16>("unit16", rng);
+    bench_type<prec32>("prec32", rng);
+    bench_type<u_prec32>("u_prec32", rng);
+    bench_type<prec64>("prec64", rng);
+    return 0;
+}
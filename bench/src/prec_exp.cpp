@@ -0,0 +1,84 @@
+#include <vector>
+#include <random>
+#include <cmath>
+
+#include "debug.hpp"
+#include "prec_batch.hpp"
+#include "bench.hpp"
+
+static constexpr auto src = "prec_exp:BENCH";
+using namespace std;
+using namespace dattatypes;
+
+
+// Benchmark: integer exponentials and logarithms against libm on float and double
+int main() {
+    LOG_INFO("=== Benchmarking exponentials for Prec ===");
+
+    constexpr size_t n = 4096;
+    mt19937_64 rng(1);
+    uniform_real_distribution<double> dist(-16, 16);
+    vector<prec32> p32(n), pos32(n), out32(n);
+    vector<prec64> p64(n), out64(n);
+    vector<float> f(n), out_f(n);
+    vector<double> d(n), out_d(n);
+    for (size_t i = 0; i < n; ++i) {
+        d[i] = dist(rng);
+        f[i] = float(d[i]);
+        p32[i] = prec32(d[i]); p64[i] = prec64(d[i]);
+        pos32[i] = prec32(std::exp2(d[i]));
+    }
+
+    const double libm_exp2_f = bench::ns_per_op(n, [&] {
+        for (size_t i = 0; i < n; ++i) out_f[i] = std::exp2(f[i]);
+        bench::keep(out_f);
+    });
+    const double libm_exp2_d = bench::ns_per_op(n, [&] {
+        for (size_t i = 0; i < n; ++i) out_d[i] = std::exp2(d[i]);
+        bench::keep(out_d);
+    });
+    const double libm_log2_f = bench::ns_per_op(n, [&] {
+        for (size_t i = 0; i < n; ++i) out_f[i] = std::log2(out_f[i] + 1.0f);
+        bench::keep(out_f);
+    });
+    const double libm_pow_d = bench::ns_per_op(n, [&] {
+        for (size_t i = 0; i < n; ++i) out_d[i] = std::pow(std::fabs(d[i]), 1.7);
+        bench::keep(out_d);
+    });
+    const double exp2_32 = bench::ns_per_op(n, [&] {
+        exp2<prec32, prec32>(p32, out32);
+        bench::keep(out32);
+    });
+    const double exp2_64 = bench::ns_per_op(n, [&] {
+        exp2<prec64, prec64>(p64, out64);
+        bench::keep(out64);
+    });
+    const double exp_32 = bench::ns_per_op(n, [&] {
+        exp<prec32, prec32>(p32, out32);
+        bench::keep(out32);
+    });
+    const double log2_32 = bench::ns_per_op(n, [&] {
+        log2<prec32, prec32>(pos32, out32);
+        bench::keep(out32);
+    });
+    const double log_32 = bench::ns_per_op(n, [&] {
+        log<prec32, prec32>(pos32, out32);
+        bench::keep(out32);
+    });
+    const double pow_32 = bench::ns_per_op(n, [&] {
+        for (size_t i = 0; i < n; ++i) out32[i] = pow(pos32[i], prec32(1.7));
+        bench::keep(out32);
+    });
+
+    LOG_INFO("std::exp2(float):                 {} ns/op", libm_exp2_f);
+    LOG_INFO("std::exp2(double):                {} ns/op", libm_exp2_d);
+    LOG_INFO("std::log2(float):                 {} ns/op", libm_log2_f);
+    LOG_INFO("std::pow(double):                 {} ns/op", libm_pow_d);
+    LOG_INFO("exp2(span<prec32>):               {} ns/op", exp2_32);
+    LOG_INFO("exp2(span<prec64>):               {} ns/op", exp2_64);
+    LOG_INFO("exp(span<prec32>):                {} ns/op", exp_32);
+    LOG_INFO("log2(span<prec32>):               {} ns/op", log2_32);
+    LOG_INFO("log(span<prec32>):                {} ns/op", log_32);
+    LOG_INFO("pow(prec32):                      {} ns/op", pow_32);
+    return 0;
+}
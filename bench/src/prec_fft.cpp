@@ -0,0 +1,69 @@
+#include <vector>
+#include <random>
+#include <cmath>
+#include <complex>
+#include <numbers>
+
+#include "debug.hpp"
+#include "prec_fft.hpp"
+#include "bench.hpp"
+
+static constexpr auto src = "prec_fft:BENCH";
+using namespace std;
+using namespace dattatypes;
+
+
+// Naive O(n^2) DFT with a precomputed table of roots of unity
+static void naive_dft(const vector<std::complex<double>>& roots, const vector<std::complex<double>>& in, vector<std::complex<double>>& out) {
+    const size_t n = in.size();
+    for (size_t k = 0; k < n; ++k) {
+        std::complex<double> sum = 0;
+        for (size_t j = 0; j < n; ++j) sum += in[j] * roots[(j * k) % n];
+        out[k] = sum;
+    }
+}
+
+// Benchmark: fixed-point FFT against a naive double DFT
+int main() {
+    LOG_INFO("=== Benchmarking the FFT for Prec ===");
+
+    constexpr size_t n = 1024;
+    mt19937_64 rng(1);
+    uniform_real_distribution<double> dist(-0.7, 0.7);
+
+    vector<std::complex<double>> d(n), out_d(n), roots(n);
+    vector<dattatypes::complex<unit16>> x16(n), work16(n);
+    vector<dattatypes::complex<unit32>> x32(n), work32(n);
+    for (size_t i = 0; i < n; ++i) {
+        d[i] = {dist(rng), dist(rng)};
+        roots[i] = std::polar(1.0, -2 * std::numbers::pi * double(i) / double(n));
+        x16[i] = {unit16(d[i].real()), unit16(d[i].imag())};
+        x32[i] = {unit32(d[i].real()), unit32(d[i].imag())};
+    }
+    const FFT<unit16> fft16(n);
+    const FFT<unit32> fft32(n), floating32(n, FFTScaling::block_floating);
+
+    const double dft = bench::ns_per_op(1, [&] {
+        naive_dft(roots, d, out_d);
+        bench::keep(out_d);
+    });
+    const double transform16 = bench::ns_per_op(1, [&] {
+        work16 = x16;
+        bench::keep(fft16.forward(work16));
+    });
+    const double transform32 = bench::ns_per_op(1, [&] {
+        work32 = x32;
+        bench::keep(fft32.forward(work32));
+    });
+    const double floating = bench::ns_per_op(1, [&] {
+        work32 = x32;
+        bench::keep(floating32.forward(work32));
+    });
+
+    LOG_INFO("Transforms of {} points", n);
+    LOG_INFO("naive DFT, complex<double>:       {} us", dft / 1e3);
+    LOG_INFO("FFT<unit16>, per stage:           {} us", transform16 / 1e3);
+    LOG_INFO("FFT<unit32>, per stage:           {} us", transform32 / 1e3);
+    LOG_INFO("FFT<unit32>, block floating:      {} us", floating / 1e3);
+    return 0;
+}
@@ -0,0 +1,58 @@
+#include <vector>
+#include <random>
+#include <cmath>
+
+#include "debug.hpp"
+#include "prec_filter.hpp"
+#include "bench.hpp"
+
+static constexpr auto src = "prec_filter:BENCH";
+using namespace std;
+using namespace dattatypes;
+
+
+// Millions of samples per second on one core, from nanoseconds per sample
+double msamples_per_s(const double ns_per_sample) { return 1e3 / ns_per_sample; }
+
+
+// Benchmark: streaming filters on unit16 samples, against a FIR of Prec::operator* per tap
+int main() {
+    LOG_INFO("=== Benchmarking filters for Prec ===");
+
+    constexpr size_t n = 1 << 16, taps = 64;
+    mt19937_64 rng(1);
+    vector<unit16> x(n), y(n), h(taps), wide(taps), up(4 * n);
+    for (auto& v : x) v._data = int16_t(rng());
+    for (auto& v : h) v._data = int16_t(int64_t(rng()) >> 54);  // Magnitudes adding up to below 1.0
+    for (auto& v : wide) v._data = int16_t(rng());
+    const BiquadSection<Prec<int32_t, -30>> section = {0.0976, 0.1953, 0.0976, -0.9428, 0.3333};
+    const vector<BiquadSection<Prec<int32_t, -30>>> sections(4, section);
+
+    FIR<unit16> fir(h), fir_wide(wide);
+    Decimator<unit16> decimator(4, h);
+    Interpolator<unit16> interpolator(4, h);
+    Biquad<unit16, Prec<int32_t, -30>> biquad(sections);
+
+    const double fir_operator = bench::ns_per_op(n - taps, [&] {
+        for (size_t i = taps - 1; i < n; ++i) {
+            unit16 sum(0);
+            for (size_t k = 0; k < taps; ++k) sum += h[k] * x[i - k];
+            y[i] = sum;
+        }
+        bench::keep(y);
+    });
+    const double fir_narrow = bench::ns_per_op(n, [&] { fir.process(x, y); bench::keep(y); });
+    const double fir_wide64 = bench::ns_per_op(n, [&] { fir_wide.process(x, y); bench::keep(y); });
+    const double decimate = bench::ns_per_op(n, [&] { decimator.process(x, y); bench::keep(y); });
+    const double interpolate = bench::ns_per_op(n, [&] { interpolator.process(x, up); bench::keep(up); });
+    const double iir = bench::ns_per_op(n, [&] { biquad.process(x, y); bench::keep(y); });
+
+    LOG_INFO("Input samples per second on one core, {}-tap FIRs of unit16", taps);
+    LOG_INFO("FIR of unit16 operator* per tap:  {} M/s", msamples_per_s(fir_operator));
+    LOG_INFO("FIR, 32-bit sums:                 {} M/s", msamples_per_s(fir_narrow));
+    LOG_INFO("FIR, 64-bit sums:                 {} M/s", msamples_per_s(fir_wide64));
+    LOG_INFO("Decimator by 4:                   {} M/s", msamples_per_s(decimate));
+    LOG_INFO("Interpolator by 4:                {} M/s", msamples_per_s(interpolate));
+    LOG_INFO("Biquad, 4 sections:               {} M/s", msamples_per_s(iir));
+    return 0;
+}
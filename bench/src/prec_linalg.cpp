@@ -0,0 +1,58 @@
+#include <vector>
+#include <array>
+#include <random>
+
+#include "debug.hpp"
+#include "prec_linalg.hpp"
+#include "bench.hpp"
+
+static constexpr auto src = "prec_linalg:BENCH";
+using namespace std;
+using namespace dattatypes;
+
+
+// Benchmark: affine transform of many points, SoA bulk against per-vector scalar and double
+int main() {
+    LOG_INFO("=== Benchmarking linear algebra for Prec ===");
+
+    constexpr size_t n = 4096;
+    mt19937_64 rng(1);
+    uniform_real_distribution<double> dist(-1000.0, 1000.0), entry(-1.0, 1.0);
+
+    Mat4<prec32> m = Mat4<prec32>::identity();
+    array<array<double, 4>, 3> md{};
+    for (size_t i = 0; i < 3; ++i)
+        for (size_t j = 0; j < 4; ++j) { m[i][j] = prec32(j < 3 ? entry(rng) : dist(rng)); md[i][j] = double(m[i][j]); }
+
+    SoAVec3<prec32> soa;
+    vector<Vec3<prec32>> aos;
+    vector<array<double, 3>> d(n);
+    for (size_t i = 0; i < n; ++i) {
+        const Vec3<prec32> v(prec32(dist(rng)), prec32(dist(rng)), prec32(dist(rng)));
+        soa.push_back(v);
+        aos.push_back(v);
+        d[i] = {double(v[0]), double(v[1]), double(v[2])};
+    }
+
+    const double transform_double = bench::ns_per_op(n, [&] {
+        for (auto& p : d) {
+            const array<double, 3> q = p;
+            for (size_t r = 0; r < 3; ++r) p[r] = md[r][0] * q[0] + md[r][1] * q[1] + md[r][2] * q[2] + md[r][3];
+        }
+        bench::keep(d);
+    });
+    const double transform_aos = bench::ns_per_op(n, [&] {
+        for (auto& p : aos) p = transform_point(m, p);
+        bench::keep(aos);
+    });
+    const double transform_soa = bench::ns_per_op(n, [&] {
+        soa.transform(m);
+        bench::keep(soa.x);
+    });
+
+    LOG_INFO("transform double[3]:              {} ns/vector", transform_double);
+    LOG_INFO("transform_point(Vec3<prec32>):    {} ns/vector", transform_aos);
+    LOG_INFO("SoAVec3<prec32>::transform:       {} ns/vector", transform_soa);
+    LOG_INFO("SoAVec3<prec32>::transform:       {} M vectors/s", 1e3 / transform_soa);
+    return 0;
+}
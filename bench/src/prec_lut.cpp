@@ -0,0 +1,42 @@
+#include <vector>
+#include <random>
+#include <cmath>
+
+#include "debug.hpp"
+#include "prec_lut.hpp"
+#include "bench.hpp"
+
+static constexpr auto src = "prec_lut:BENCH";
+using namespace std;
+using namespace dattatypes;
+
+
+// A gamma curve through doubles per sample, against its LUT in scalar and batch
+template <Interpolation interpolation, size_t bits>
+void bench_lut(const string& name, const vector<u_unit16>& x, vector<u_unit16>& y) {
+    static constexpr auto curve = [](double v) { return std::pow(v, 2.2); };
+    static constexpr auto lut = make_lut<u_unit16, u_unit16, bits, interpolation>(curve);
+    const size_t n = x.size();
+
+    const double direct = bench::ns_per_op(n, [&] {
+        for (size_t i = 0; i < n; ++i) y[i] = u_unit16(std::pow(double(x[i]), 2.2));
+        bench::keep(y);
+    });
+    const double scalar = bench::ns_per_op(n, [&] { for (size_t i = 0; i < n; ++i) y[i] = lut(x[i]); bench::keep(y); });
+    const double batch = bench::ns_per_op(n, [&] { lut(x, y); bench::keep(y); });
+    LOG_INFO("{} with 2^{} segments: through double {} ns, LUT {} ns, batch {} ns, max error {} ulp",
+             name, bits, direct, scalar, batch, lut.max_error());
+}
+
+
+// Benchmark: lookup-table curves
+int main() {
+    LOG_INFO("=== Benchmarking lookup tables for Prec ===");
+    mt19937_64 rng(1);
+    vector<u_unit16> x(1 << 14), y(x.size());
+    for (auto& v : x) v._data = uint16_t(rng());
+    bench_lut<Interpolation::linear, 6>("linear", x, y);
+    bench_lut<Interpolation::linear, 8>("linear", x, y);
+    bench_lut<Interpolation::quadratic, 6>("quadratic", x, y);
+    return 0;
+}
@@ -0,0 +1,64 @@
+#include <vector>
+#include <array>
+#include <random>
+#include <cmath>
+
+#include "debug.hpp"
+#include "prec_quat.hpp"
+#include "bench.hpp"
+
+static constexpr auto src = "prec_quat:BENCH";
+using namespace std;
+using namespace dattatypes;
+
+
+// Benchmark: rotating a point cloud by a quaternion, against double
+int main() {
+    LOG_INFO("=== Benchmarking quaternions for Prec ===");
+
+    constexpr size_t n = 4096;
+    mt19937_64 rng(1);
+    uniform_real_distribution<double> dist(-1000.0, 1000.0);
+
+    const quat<unit32> q = normalize<unit32>(quat<prec32>(prec32(0.5), prec32(-0.25), prec32(0.75), prec32(0.125)));
+    const array<double, 4> qd = {double(q.w()), double(q.x()), double(q.y()), double(q.z())};
+    const quat<unit32> r = normalize<unit32>(quat<prec32>(prec32(0.25), prec32(0.5), prec32(-0.5), prec32(0.75)));
+
+    SoAVec3<prec32> soa;
+    vector<Vec3<prec32>> aos(n);
+    vector<array<double, 3>> d(n);
+    for (size_t i = 0; i < n; ++i) {
+        aos[i] = Vec3<prec32>(prec32(dist(rng)), prec32(dist(rng)), prec32(dist(rng)));
+        soa.push_back(aos[i]);
+        d[i] = {double(aos[i][0]), double(aos[i][1]), double(aos[i][2])};
+    }
+
+    const double rotate_double = bench::ns_per_op(n, [&] {
+        const auto [w, x, y, z] = qd;
+        for (auto& p : d) {
+            // v + 2 w (u x v) + 2 u x (u x v)
+            const double tx = 2 * (y * p[2] - z * p[1]), ty = 2 * (z * p[0] - x * p[2]), tz = 2 * (x * p[1] - y * p[0]);
+            p = {p[0] + w * tx + (y * tz - z * ty), p[1] + w * ty + (z * tx - x * tz), p[2] + w * tz + (x * ty - y * tx)};
+        }
+        bench::keep(d);
+    });
+    const double rotate_span = bench::ns_per_op(n, [&] {
+        rotate<prec32>(q, aos, aos);
+        bench::keep(aos);
+    });
+    const double rotate_soa = bench::ns_per_op(n, [&] {
+        rotate(q, soa);
+        bench::keep(soa.x);
+    });
+    const double hamilton = bench::ns_per_op(n, [&] {
+        quat<unit32> p = q;
+        for (size_t i = 0; i < n; ++i) p = p * r;
+        bench::keep(p);
+    });
+
+    LOG_INFO("rotate double[3]:                 {} ns/point", rotate_double);
+    LOG_INFO("rotate span<Vec3<prec32>>:        {} ns/point", rotate_span);
+    LOG_INFO("rotate SoAVec3<prec32>:           {} ns/point", rotate_soa);
+    LOG_INFO("quat<unit32> * quat<unit32>:      {} ns/op", hamilton);
+    return 0;
+}
@@ -0,0 +1,64 @@
+#include <vector>
+#include <random>
+
+#include "debug.hpp"
+#include "prec_random.hpp"
+#include "bench.hpp"
+
+static constexpr auto src = "prec_random:BENCH";
+using namespace std;
+using namespace dattatypes;
+
+
+// Benchmark: fixed-point sampling against std distributions converted through float
+int main() {
+    LOG_INFO("=== Benchmarking random numbers for Prec ===");
+
+    constexpr size_t n = 4096;
+    mt19937 mt(1);
+    Philox gen(1);
+    vector<uint32_t> words(n);
+    vector<prob32> p(n);
+    vector<uint8_t> trials(n);
+    vector<prec32> z(n);
+
+    const double std_uniform = bench::ns_per_op(n, [&] {
+        uniform_real_distribution<float> dist(0.0f, 1.0f);
+        for (auto& v : p) v = prob32(dist(mt));
+        bench::keep(p);
+    });
+    const double std_normal = bench::ns_per_op(n, [&] {
+        normal_distribution<float> dist;
+        for (auto& v : z) v = prec32(dist(mt));
+        bench::keep(z);
+    });
+    const double philox_scalar = bench::ns_per_op(n, [&] {
+        for (auto& w : words) w = gen();
+        bench::keep(words);
+    });
+    const double philox_fill = bench::ns_per_op(n, [&] {
+        gen.fill(words);
+        bench::keep(words);
+    });
+    const double prec_uniform = bench::ns_per_op(n, [&] {
+        uniform<prob32>(gen, p, prob32(0), prob32(1));
+        bench::keep(p);
+    });
+    const double prec_bernoulli = bench::ns_per_op(n, [&] {
+        bernoulli(gen, prob32(0.3), trials);
+        bench::keep(trials);
+    });
+    const double prec_normal = bench::ns_per_op(n, [&] {
+        normal<prec32>(gen, z);
+        bench::keep(z);
+    });
+
+    LOG_INFO("mt19937 + uniform float -> prob32:   {} ns/sample", std_uniform);
+    LOG_INFO("mt19937 + normal float -> prec32:    {} ns/sample", std_normal);
+    LOG_INFO("Philox, word by word:                {} ns/word", philox_scalar);
+    LOG_INFO("Philox::fill:                        {} ns/word", philox_fill);
+    LOG_INFO("uniform<prob32> in [0, 1):           {} ns/sample", prec_uniform);
+    LOG_INFO("bernoulli(prob32):                   {} ns/sample", prec_bernoulli);
+    LOG_INFO("normal<prec32>:                      {} ns/sample", prec_normal);
+    return 0;
+}
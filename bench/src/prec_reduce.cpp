@@ -0,0 +1,65 @@
+#include <vector>
+#include <random>
+#include <thread>
+
+#include "debug.hpp"
+#include "prec_reduce.hpp"
+#include "bench.hpp"
+
+static constexpr auto src = "prec_reduce:BENCH";
+using namespace std;
+using namespace dattatypes;
+
+
+// Benchmark: wide reductions against plain loops over the operators and over double
+int main() {
+    LOG_INFO("=== Benchmarking reductions for Prec ===");
+
+    constexpr size_t n = size_t(1) << 22;
+    mt19937_64 rng(1);
+    uniform_int_distribution<int32_t> dist(-(1 << 20), 1 << 20);
+    vector<prec32> a(n), b(n);
+    vector<double> da(n), db(n);
+    for (size_t i = 0; i < n; ++i) {
+        a[i]._data = dist(rng);
+        b[i]._data = dist(rng);
+        da[i] = double(a[i]._data) / 256;
+        db[i] = double(b[i]._data) / 256;
+    }
+    vector<uint64_t> counts(64);
+
+    const double loop_operator = bench::ns_per_op(n, [&] {
+        prec32 total(0);
+        for (const auto& v : a) total += v;
+        bench::keep(total);
+    });
+    const double loop_double = bench::ns_per_op(n, [&] {
+        double total = 0;
+        for (const auto& v : da) total += v;
+        bench::keep(total);
+    });
+    const double sum_one = bench::ns_per_op(n, [&] { bench::keep(sum<prec32, prec64>(a, 1)); });
+    const double sum_all = bench::ns_per_op(n, [&] { bench::keep(sum<prec32, prec64>(a)); });
+    const double dot_double = bench::ns_per_op(n, [&] {
+        double total = 0;
+        for (size_t i = 0; i < n; ++i) total += da[i] * db[i];
+        bench::keep(total);
+    });
+    const double dot_one = bench::ns_per_op(n, [&] { bench::keep(dot<prec32, prec64>(a, b, 1)); });
+    const double minmax_one = bench::ns_per_op(n, [&] { bench::keep(minmax<prec32>(a, 1)); });
+    const double histogram_one = bench::ns_per_op(n, [&] {
+        histogram(a, prec32(-4096), prec32(4096), counts, 1);
+        bench::keep(counts);
+    });
+
+    LOG_INFO("{} values, {} hardware threads", n, thread::hardware_concurrency());
+    LOG_INFO("loop of prec32 +=, wrapping:      {} ns/value", loop_operator);
+    LOG_INFO("loop of double +=:                {} ns/value", loop_double);
+    LOG_INFO("sum<prec32, prec64>, 1 thread:    {} ns/value", sum_one);
+    LOG_INFO("sum<prec32, prec64>, all threads: {} ns/value", sum_all);
+    LOG_INFO("loop of double dot:               {} ns/value", dot_double);
+    LOG_INFO("dot<prec32, prec64>, 1 thread:    {} ns/value", dot_one);
+    LOG_INFO("minmax<prec32>, 1 thread:         {} ns/value", minmax_one);
+    LOG_INFO("histogram<prec32>, 1 thread:      {} ns/value", histogram_one);
+    return 0;
+}
@@ -0,0 +1,65 @@
+#include <vector>
+#include <random>
+#include <cmath>
+
+#include "debug.hpp"
+#include "prec_batch.hpp"
+#include "bench.hpp"
+
+static constexpr auto src = "prec_roots:BENCH";
+using namespace std;
+using namespace dattatypes;
+
+
+// Benchmark: integer roots against libm on double
+int main() {
+    LOG_INFO("=== Benchmarking roots for Prec ===");
+
+    constexpr size_t n = 4096;
+    mt19937_64 rng(1);
+    vector<prec16> p16(n);
+    vector<prec32> p32(n), q32(n), out32(n);
+    vector<prec64> p64(n);
+    vector<double> d(n), out_d(n);
+    for (size_t i = 0; i < n; ++i) {
+        p16[i]._data = int16_t(rng() >> 49); p32[i]._data = int32_t(rng() >> 33); q32[i]._data = int32_t(rng() >> 33);
+        p64[i]._data = int64_t(rng() >> 1);
+        d[i] = double(p32[i]);
+    }
+
+    const double libm_sqrt = bench::ns_per_op(n, [&] {
+        for (size_t i = 0; i < n; ++i) out_d[i] = std::sqrt(d[i]);
+        bench::keep(out_d);
+    });
+    const double libm_round_trip = bench::ns_per_op(n, [&] {
+        for (size_t i = 0; i < n; ++i) out32[i] = prec32(std::sqrt(double(p32[i])));
+        bench::keep(out32);
+    });
+    const double sqrt16 = bench::ns_per_op(n, [&] {
+        for (size_t i = 0; i < n; ++i) bench::keep(sqrt(p16[i]));
+    });
+    const double sqrt32 = bench::ns_per_op(n, [&] {
+        sqrt<prec32>(p32, out32);
+        bench::keep(out32);
+    });
+    const double sqrt64 = bench::ns_per_op(n, [&] {
+        for (size_t i = 0; i < n; ++i) bench::keep(sqrt(p64[i]));
+    });
+    const double rsqrt32 = bench::ns_per_op(n, [&] {
+        rsqrt<prec32>(p32, out32);
+        bench::keep(out32);
+    });
+    const double hypot32 = bench::ns_per_op(n, [&] {
+        hypot<prec32>(p32, q32, out32);
+        bench::keep(out32);
+    });
+
+    LOG_INFO("std::sqrt(double):                {} ns/op", libm_sqrt);
+    LOG_INFO("prec32 -> double -> std::sqrt:    {} ns/op", libm_round_trip);
+    LOG_INFO("sqrt(prec16):                     {} ns/op", sqrt16);
+    LOG_INFO("sqrt(span<prec32>):               {} ns/op", sqrt32);
+    LOG_INFO("sqrt(prec64):                     {} ns/op", sqrt64);
+    LOG_INFO("rsqrt(span<prec32>):              {} ns/op", rsqrt32);
+    LOG_INFO("hypot(span<prec32>):              {} ns/op", hypot32);
+    return 0;
+}
@@ -0,0 +1,85 @@
+#include <vector>
+#include <string>
+#include <random>
+#include <cstdio>
+#include <cstdlib>
+#include <cmath>
+
+#include "debug.hpp"
+#include "prec_text.hpp"
+#include "bench.hpp"
+
+static constexpr auto src = "prec_text:BENCH";
+using namespace std;
+using namespace dattatypes;
+
+
+// A CSV column of `rows` values with 1/256 resolution, as written by printf
+string make_column(const size_t rows, mt19937_64& rng) {
+    uniform_int_distribution<int32_t> dist(-(1 << 24), 1 << 24);
+    string text;
+    char line[64];
+    for (size_t i = 0; i < rows; ++i) {
+        snprintf(line, sizeof(line), "%.8g\n", std::ldexp(double(dist(rng)), -8));
+        text += line;
+    }
+    return text;
+}
+
+// Megabytes per second, from nanoseconds per byte
+double mb_per_s(const double ns_per_byte) { return 1e3 / ns_per_byte; }
+
+
+// Benchmark: parsing and formatting against strtod and snprintf through double
+int main() {
+    LOG_INFO("=== Benchmarking text conversion for Prec ===");
+
+    constexpr size_t rows = 100000;
+    mt19937_64 rng(1);
+    const string text = make_column(rows, rng);
+    vector<prec32> values;
+    vector<prec64> wide;
+    values.reserve(rows);
+    wide.reserve(rows);
+
+    const double parse_strtod = bench::ns_per_op(text.size(), [&] {
+        values.clear();
+        const char* p = text.data();
+        char* end;
+        for (size_t i = 0; i < rows; ++i, p = end + 1) values.push_back(prec32(std::strtod(p, &end)));
+        bench::keep(values);
+    });
+    const double parse_prec32 = bench::ns_per_op(text.size(), [&] {
+        values.clear();
+        parse_column<prec32>(text, values);
+        bench::keep(values);
+    });
+    const double parse_prec64 = bench::ns_per_op(text.size(), [&] {
+        wide.clear();
+        parse_column<prec64>(text, wide);
+        bench::keep(wide);
+    });
+
+    string out(rows * 24, '\0');
+    size_t written = 0;
+    const double format_snprintf = bench::ns_per_op(text.size(), [&] {
+        char* p = out.data();
+        for (const auto& v : values) p += snprintf(p, 24, "%.8g\n", double(v));
+        written = size_t(p - out.data());
+        bench::keep(out);
+    });
+    const double format_prec32 = bench::ns_per_op(text.size(), [&] {
+        char* p = out.data();
+        for (const auto& v : values) { p = to_chars(p, p + 24, v).ptr; *p++ = '\n'; }
+        written = size_t(p - out.data());
+        bench::keep(out);
+    });
+
+    LOG_INFO("Column of {} rows, {} bytes ({} bytes written back)", rows, text.size(), written);
+    LOG_INFO("strtod + prec32(double):          {} MB/s", mb_per_s(parse_strtod));
+    LOG_INFO("parse_column<prec32>:             {} MB/s", mb_per_s(parse_prec32));
+    LOG_INFO("parse_column<prec64>:             {} MB/s", mb_per_s(parse_prec64));
+    LOG_INFO("snprintf(double(prec32)):         {} MB/s", mb_per_s(format_snprintf));
+    LOG_INFO("to_chars(prec32):                 {} MB/s", mb_per_s(format_prec32));
+    return 0;
+}
@@ -0,0 +1,71 @@
+#include <vector>
+#include <random>
+#include <cmath>
+
+#include "debug.hpp"
+#include "prec_batch.hpp"
+#include "bench.hpp"
+
+static constexpr auto src = "prec_trig:BENCH";
+using namespace std;
+using namespace dattatypes;
+
+
+// Benchmark: integer trigonometry against libm on double
+int main() {
+    LOG_INFO("=== Benchmarking trigonometry for Prec ===");
+
+    constexpr size_t n = 4096;
+    mt19937_64 rng(1);
+    vector<angle16> a16(n);
+    vector<angle32> a32(n), out32(n);
+    vector<angle64> a64(n);
+    vector<prec32> ys(n), xs(n);
+    vector<double> rad(n), out_d(n);
+    for (size_t i = 0; i < n; ++i) {
+        a16[i]._data = int16_t(rng()); a32[i]._data = int32_t(rng()); a64[i]._data = int64_t(rng());
+        ys[i]._data = int32_t(rng()); xs[i]._data = int32_t(rng());
+        rad[i] = double(a32[i]) * M_PI;
+    }
+
+    const double libm_sin = bench::ns_per_op(n, [&] {
+        for (size_t i = 0; i < n; ++i) out_d[i] = std::sin(rad[i]);
+        bench::keep(out_d);
+    });
+    const double libm_round_trip = bench::ns_per_op(n, [&] {
+        for (size_t i = 0; i < n; ++i) out32[i] = angle32(std::sin(double(a32[i]) * M_PI));
+        bench::keep(out32);
+    });
+    const double sin16 = bench::ns_per_op(n, [&] {
+        for (size_t i = 0; i < n; ++i) bench::keep(sin(a16[i]));
+    });
+    const double sin32 = bench::ns_per_op(n, [&] {
+        for (size_t i = 0; i < n; ++i) out32[i] = sin(a32[i]);
+        bench::keep(out32);
+    });
+    const double sin32_batch = bench::ns_per_op(n, [&] {
+        sin<angle32, angle32>(a32, out32);
+        bench::keep(out32);
+    });
+    const double sin64 = bench::ns_per_op(n, [&] {
+        for (size_t i = 0; i < n; ++i) bench::keep(sin(a64[i]));
+    });
+    const double libm_atan2 = bench::ns_per_op(n, [&] {
+        for (size_t i = 0; i < n; ++i) out_d[i] = std::atan2(double(ys[i]), double(xs[i]));
+        bench::keep(out_d);
+    });
+    const double atan2_32 = bench::ns_per_op(n, [&] {
+        for (size_t i = 0; i < n; ++i) out32[i] = atan2(ys[i], xs[i]);
+        bench::keep(out32);
+    });
+
+    LOG_INFO("std::sin(double):                 {} ns/op", libm_sin);
+    LOG_INFO("angle32 -> double -> std::sin:    {} ns/op", libm_round_trip);
+    LOG_INFO("sin(angle16):                     {} ns/op", sin16);
+    LOG_INFO("sin(angle32):                     {} ns/op", sin32);
+    LOG_INFO("sin(span<angle32>):               {} ns/op", sin32_batch);
+    LOG_INFO("sin(angle64):                     {} ns/op", sin64);
+    LOG_INFO("std::atan2(double):               {} ns/op", libm_atan2);
+    LOG_INFO("atan2(prec32) -> angle32:         {} ns/op", atan2_32);
+    return 0;
+}
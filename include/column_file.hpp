@@ -0,0 +1,283 @@
+#pragma once
+// === HEADER ONLY ===
+
+#include <span>
+#include <string>
+#include <string_view>
+#include <vector>
+#include <array>
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <cerrno>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+#include "prec_utils.hpp"
+#include "enum_flags.hpp"
+
+/**
+ * Columnar files of Prec and Flags arrays, read through mmap without copying (Linux/POSIX).
+ *
+ * Layout, in native byte order:
+ *   header     64 bytes: magic, version, byte order mark, directory offset, column count
+ *   columns    raw values, each column starting at a multiple of `column_alignment`
+ *   directory  one 64-byte `ColumnInfo` per column: name, offset, count, and the type of the values
+ *
+ * The directory goes last, so a `ColumnWriter` can stream every column in chunks of any size.
+ */
+namespace dattatypes {
+
+    inline constexpr std::size_t column_alignment = 64;
+
+    enum class ColumnKind : uint8_t { prec = 1, flags = 2 };
+
+    // Directory entry of one column. The values are `count` elements of `width` bytes, at `offset` in the file.
+    struct ColumnInfo {
+        std::array<char, 32> name{};    // NUL-terminated
+        uint64_t offset = 0;
+        uint64_t count = 0;
+        ColumnKind kind{};
+        uint8_t width = 0;              // Bytes per value: of the Prec's T, or of the enum
+        uint8_t is_signed = 0;
+        uint8_t reserved = 0;
+        int32_t order = 0;              // The Prec's n, 0 for Flags
+        std::array<uint8_t, 8> padding{};
+
+        std::string_view get_name() const { return std::string_view(name.data(), strnlen(name.data(), name.size())); }
+    };
+    static_assert(sizeof(ColumnInfo) == 64 && std::is_trivially_copyable_v<ColumnInfo>);
+
+
+    namespace detail {
+
+        inline constexpr std::array<char, 8> column_magic = {'D', 'T', 'C', 'O', 'L', 'S', '\0', '\0'};
+        inline constexpr uint32_t column_version = 1;
+        inline constexpr uint32_t column_byte_order = 0x01020304;
+
+        struct ColumnHeader {
+            std::array<char, 8> magic = column_magic;
+            uint32_t version = column_version;
+            uint32_t byte_order = column_byte_order;
+            uint64_t directory = 0;
+            uint64_t columns = 0;
+            std::array<uint8_t, 32> padding{};
+        };
+        static_assert(sizeof(ColumnHeader) == 64 && std::is_trivially_copyable_v<ColumnHeader>);
+
+        // The enum of a Flags type
+        template <typename F> struct flags_enum;
+        template <typename E> struct flags_enum<Flags<E>> { using type = E; };
+        template <typename E> struct flags_enum<FlagsOrValue<E>> { using type = E; };
+
+        inline std::runtime_error column_error(const std::string& what) {
+            return std::runtime_error(what + ": " + std::strerror(errno));
+        }
+
+        // The directory entry describing values of type V, without name, offset and count
+        template <typename V>
+        ColumnInfo column_type() {
+            ColumnInfo info;
+            if constexpr (PrecType<V>) {
+                using T = typename V::value_type;
+                static_assert(sizeof(V) == sizeof(T), "Prec should be stored as its raw value");
+                info.kind = ColumnKind::prec;
+                info.width = sizeof(T);
+                info.is_signed = std::is_signed_v<T>;
+                info.order = V::_n;
+            }
+            else {
+                using E = typename flags_enum<V>::type;
+                static_assert(sizeof(V) == sizeof(E), "Flags should be stored as its enum");
+                info.kind = ColumnKind::flags;
+                info.width = sizeof(E);
+                info.is_signed = std::is_signed_v<std::underlying_type_t<E>>;
+            }
+            return info;
+        }
+
+        inline bool same_type(const ColumnInfo& a, const ColumnInfo& b) {
+            return a.kind == b.kind && a.width == b.width && a.is_signed == b.is_signed && a.order == b.order;
+        }
+
+    }; // namespace detail
+
+
+    /**
+     * Writes a column file, one column after the other, each in chunks of any size.
+     * `close` (or the destructor) writes the directory; a file that was not closed has no columns.
+     *
+     *     ColumnWriter writer("state.cols");
+     *     writer.column<prec32>("price");
+     *     for (auto chunk : chunks) writer.append<prec32>(chunk);
+     *     writer.close();
+     */
+    class ColumnWriter {
+    public:
+        explicit ColumnWriter(const std::string& path) : _fd(::open(path.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644)) {
+            if (_fd < 0) throw detail::column_error("column file should be writable: " + path);
+            write_all(&_header, sizeof(_header));
+        }
+        ColumnWriter(const ColumnWriter&) = delete;
+        ColumnWriter& operator=(const ColumnWriter&) = delete;
+        ~ColumnWriter() {
+            try { close(); } catch (const std::exception&) {}
+        }
+
+        // Starts a new column of values V, a Prec or a Flags type
+        template <typename V>
+        void column(const std::string_view name) {
+            if (_fd < 0) throw std::runtime_error("column file should be open");
+            if (name.empty() || name.size() >= ColumnInfo{}.name.size())
+                throw std::runtime_error("column name should have 1 to 31 characters");
+            for (const auto& info : _directory)
+                if (info.get_name() == name) throw std::runtime_error("column names should be unique");
+
+            pad_to(column_alignment);
+            ColumnInfo info = detail::column_type<V>();
+            std::copy(name.begin(), name.end(), info.name.begin());
+            info.offset = _position;
+            _directory.push_back(info);
+        }
+
+        // Appends values to the current column, which should hold V
+        template <typename V>
+        void append(std::span<const std::type_identity_t<V>> values) {
+            if (_directory.empty() || !detail::same_type(_directory.back(), detail::column_type<V>()))
+                throw std::runtime_error("appended values should match the type of the current column");
+            write_all(values.data(), values.size_bytes());
+            _directory.back().count += values.size();
+        }
+
+        // Writes the directory and the header, and closes the file
+        void close() {
+            if (_fd < 0) return;
+            pad_to(column_alignment);
+            _header.directory = _position;
+            _header.columns = _directory.size();
+            write_all(_directory.data(), _directory.size() * sizeof(ColumnInfo));
+            const bool written = ::pwrite(_fd, &_header, sizeof(_header), 0) == ssize_t(sizeof(_header));
+            const bool closed = ::close(_fd) == 0;
+            _fd = -1;
+            if (!written || !closed) throw detail::column_error("column file should be written");
+        }
+
+    private:
+        int _fd;
+        uint64_t _position = 0;
+        detail::ColumnHeader _header;
+        std::vector<ColumnInfo> _directory;
+
+        void write_all(const void* data, std::size_t size) {
+            const char* bytes = static_cast<const char*>(data);
+            while (size > 0) {
+                const ssize_t written = ::write(_fd, bytes, size);
+                if (written < 0 && errno == EINTR) continue;
+                if (written <= 0) throw detail::column_error("column file should be written");
+                bytes += written;
+                size -= std::size_t(written);
+                _position += uint64_t(written);
+            }
+        }
+
+        void pad_to(const std::size_t alignment) {
+            static constexpr std::array<char, column_alignment> zeros{};
+            write_all(zeros.data(), (alignment - _position % alignment) % alignment);
+        }
+    };
+
+
+    /**
+     * A column file mapped into memory. The spans it returns view the mapping directly and live as long as the ColumnFile.
+     * Pages are read on first access; `populate` reads the whole file up front instead (MAP_POPULATE).
+     *
+     *     ColumnFile file("state.cols");
+     *     std::span<const prec32> prices = file.prec<prec32>("price");
+     *     std::span<const Flags<Permission>> permissions = file.flags<Permission>("permission");
+     */
+    class ColumnFile {
+    public:
+        explicit ColumnFile(const std::string& path, const bool populate = false) {
+            const int fd = ::open(path.c_str(), O_RDONLY);
+            if (fd < 0) throw detail::column_error("column file should be readable: " + path);
+            struct stat status;
+            if (::fstat(fd, &status) != 0) { ::close(fd); throw detail::column_error("column file should be readable: " + path); }
+            _size = std::size_t(status.st_size);
+            if (_size >= sizeof(detail::ColumnHeader))
+                _data = ::mmap(nullptr, _size, PROT_READ, MAP_PRIVATE | (populate ? MAP_POPULATE : 0), fd, 0);
+            ::close(fd);
+            if (_size < sizeof(detail::ColumnHeader)) throw std::runtime_error("column file should have a header: " + path);
+            if (_data == MAP_FAILED) { _data = nullptr; throw detail::column_error("column file should be mappable: " + path); }
+            try { validate(); } catch (...) { unmap(); throw; }
+        }
+        ColumnFile(ColumnFile&& other) noexcept
+            : _data(std::exchange(other._data, nullptr)), _size(std::exchange(other._size, 0)), _directory(other._directory) {}
+        ColumnFile& operator=(ColumnFile&& other) noexcept {
+            if (this == &other) return *this;
+            unmap();
+            _data = std::exchange(other._data, nullptr);
+            _size = std::exchange(other._size, 0);
+            _directory = other._directory;
+            return *this;
+        }
+        ColumnFile(const ColumnFile&) = delete;
+        ColumnFile& operator=(const ColumnFile&) = delete;
+        ~ColumnFile() { unmap(); }
+
+        // The directory
+        std::span<const ColumnInfo> columns() const { return _directory; }
+
+        // The values of a Prec column, whose T and n should be those of P; the rounding and overflow policies are free
+        template <PrecType P>
+        std::span<const P> prec(const std::string_view name) const { return values<P>(name); }
+
+        // The values of a Flags column, whose enum should have the width and signedness of E; also as `FlagsOrValue<E>`
+        template <typename E, typename F = Flags<E>>
+        std::span<const F> flags(const std::string_view name) const { return values<F>(name); }
+
+    private:
+        void* _data = nullptr;
+        std::size_t _size = 0;
+        std::span<const ColumnInfo> _directory;
+
+        const std::byte* bytes() const { return static_cast<const std::byte*>(_data); }
+
+        void unmap() {
+            if (_data) ::munmap(_data, _size);
+            _data = nullptr;
+        }
+
+        void validate() {
+            detail::ColumnHeader header;
+            std::memcpy(&header, bytes(), sizeof(header));
+            if (header.magic != detail::column_magic) throw std::runtime_error("column file should start with its magic");
+            if (header.version != detail::column_version) throw std::runtime_error("column file should be of version 1");
+            if (header.byte_order != detail::column_byte_order) throw std::runtime_error("column file should be in native byte order");
+            if (header.directory % column_alignment != 0 || header.directory > _size ||
+                header.columns > (_size - header.directory) / sizeof(ColumnInfo))
+                throw std::runtime_error("column file directory should be within the file");
+            _directory = {reinterpret_cast<const ColumnInfo*>(bytes() + header.directory), std::size_t(header.columns)};
+            for (const auto& info : _directory)
+                if (info.offset % column_alignment != 0 || info.offset > header.directory ||
+                    info.width == 0 || info.count > (header.directory - info.offset) / info.width)
+                    throw std::runtime_error("column file columns should be aligned and within the file");
+        }
+
+        template <typename V>
+        std::span<const V> values(const std::string_view name) const {
+            const auto it = std::find_if(_directory.begin(), _directory.end(), [&](const ColumnInfo& info) { return info.get_name() == name; });
+            if (it == _directory.end()) throw std::runtime_error("column should exist: " + std::string(name));
+            if (!detail::same_type(*it, detail::column_type<V>()))
+                throw std::runtime_error("column should hold the requested type: " + std::string(name));
+            return {reinterpret_cast<const V*>(bytes() + it->offset), std::size_t(it->count)};
+        }
+    };
+
+}; // namespace dattatypes
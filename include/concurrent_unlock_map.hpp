@@ -0,0 +1,213 @@
+#pragma once
+// === HEADER ONLY ===
+
+#include <algorithm>
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include <span>
+#include <utility>
+#include <cstddef>
+#include <cstdint>
+
+#include "unlock_map.hpp"
+
+namespace dattatypes {
+
+    namespace detail {
+
+        // Hands every thread its own starting slot in the reader tables
+        inline std::atomic<std::size_t> next_reader{0};
+
+        inline std::size_t reader_hint() {
+            static thread_local const std::size_t hint = next_reader.fetch_add(1, std::memory_order_relaxed);
+            return hint;
+        }
+
+    }; // namespace detail
+
+
+    /**
+     * An unlock_map for many reader threads and occasional writers.
+     *
+     * Readers never lock: they pin the current epoch in a slot, load the current version through an atomic pointer, and read it.
+     * Writers are serialized by a mutex. Each write copies the current version, changes the copy and publishes it,
+     * so every version is immutable once readers can see it. Replaced versions are retired, and freed once no slot pinned
+     * an epoch from before they were replaced (epoch-based reclamation).
+     *
+     * A write is O(n) for the copy; group changes with `update(f)` to pay it once.
+     * Each reader takes the slot it was handed, probing on while that one is pinned. The first table has a few slots per
+     * hardware thread; a reader that finds every slot pinned appends another table, so any number of readers and
+     * snapshots pin in a bounded number of probes. Tables are only freed with the map.
+     * A `Snapshot` keeps its version alive, and its replacements unreclaimed, until destroyed.
+     * Versions are published with their rank index and search layout built, so `rank`, `select` and `check_batch`
+     * on a snapshot write nothing either.
+     *
+     *     concurrent_unlock_map<Item> unlocks;
+     *     unlocks.insert(Item::Sword);                                  // Writer
+     *     if (unlocks.check(Item::Sword)) ...                           // Any thread
+     *     unlocks.update([](auto& map) { map.erase(a); map.insert(b); });
+     */
+    template <typename T, std::size_t N = 0, typename Alloc = std::allocator<std::underlying_type_t<T>>>
+    class concurrent_unlock_map {
+    public:
+        using map_type = unlock_map<T, N, Alloc>;
+
+        // Pins one version for reading; movable, not copyable
+        class Snapshot {
+        public:
+            Snapshot(Snapshot&& other) noexcept : _slot(std::exchange(other._slot, nullptr)), _map(other._map) {}
+            Snapshot& operator=(Snapshot&& other) noexcept {
+                if (this != &other) { unpin(); _slot = std::exchange(other._slot, nullptr); _map = other._map; }
+                return *this;
+            }
+            ~Snapshot() { unpin(); }
+
+            const map_type& operator*() const { return *_map; }
+            const map_type* operator->() const { return _map; }
+
+        private:
+            friend class concurrent_unlock_map;
+            Snapshot(std::atomic<uint64_t>* slot, const map_type* map) : _slot(slot), _map(map) {}
+            void unpin() { if (_slot) _slot->store(0, std::memory_order_release); }
+
+            std::atomic<uint64_t>* _slot;
+            const map_type* _map;
+        };
+
+        explicit concurrent_unlock_map(const Alloc& alloc = Alloc()) : _alloc(alloc), _current(new map_type(alloc)) {}
+        explicit concurrent_unlock_map(map_type map) : _alloc(map.get_allocator()), _current(new map_type(std::move(map))) {}
+        concurrent_unlock_map(const concurrent_unlock_map&) = delete;
+        concurrent_unlock_map& operator=(const concurrent_unlock_map&) = delete;
+        // Without readers left
+        ~concurrent_unlock_map() {
+            delete _current.load();
+            for (Table* table = _readers.next.load(); table; ) delete std::exchange(table, table->next.load());
+        }
+
+        // Readers, from any thread, lock-free
+
+        Snapshot snapshot() const {
+            std::atomic<uint64_t>* slot = pin();
+            return Snapshot(slot, _current.load());
+        }
+        bool check(const T item) const { return snapshot()->check(item); }
+        std::size_t size() const { return snapshot()->size(); }
+        bool empty() const { return snapshot()->empty(); }
+        // A copy of the current version
+        map_type load() const { return *snapshot(); }
+
+        // Writers, serialized
+
+        // Publishes f(copy of the current version), the one copy for any number of changes. O(n)
+        template <typename F>
+        void update(F&& f) {
+            std::lock_guard lock(_writer);
+            auto next = std::make_unique<map_type>(_alloc);
+            *next = *_current.load();
+            f(*next);
+            publish(std::move(next));
+        }
+        // Publishes map as the next version
+        void store(map_type map) {
+            std::lock_guard lock(_writer);
+            publish(std::make_unique<map_type>(std::move(map)));
+        }
+
+        void insert(const T item) { update([&](map_type& map) { map.insert(item); }); }
+        void insert(const T lower_value, const T upper_value) { update([&](map_type& map) { map.insert(lower_value, upper_value); }); }
+        void erase(const T item) { update([&](map_type& map) { map.erase(item); }); }
+        void erase(const T lower_value, const T upper_value) { update([&](map_type& map) { map.erase(lower_value, upper_value); }); }
+        void insert_batch(std::span<const T> items) { update([&](map_type& map) { map.insert_batch(items); }); }
+        void erase_batch(std::span<const T> items) { update([&](map_type& map) { map.erase_batch(items); }); }
+        void clear() { update([](map_type& map) { map.clear(); }); }
+
+        // Frees the retired versions no reader can still hold; also done by every write
+        void reclaim() {
+            std::lock_guard lock(_writer);
+            collect();
+        }
+
+        // Versions retired and not yet freed
+        std::size_t retired() const {
+            std::lock_guard lock(_writer);
+            return _retired.size();
+        }
+
+        // Reader slots in all tables, which grow with the readers and snapshots pinned at once
+        std::size_t reader_slots() const {
+            std::size_t slots = 0;
+            for (const Table* table = &_readers; table; table = table->next.load()) slots += table->size;
+            return slots;
+        }
+
+    private:
+        struct alignas(64) Slot {
+            std::atomic<uint64_t> epoch{0};  // Pinned epoch, 0 when free
+        };
+        // Reader slots, chained once all are pinned
+        struct Table {
+            explicit Table(const std::size_t size) : slots(new Slot[size]), size(size) {}
+            std::unique_ptr<Slot[]> slots;
+            std::size_t size;
+            std::atomic<Table*> next{nullptr};
+        };
+        struct Retired {
+            std::unique_ptr<const map_type> map;
+            uint64_t epoch;  // First epoch in which no reader can load it
+        };
+
+        Alloc _alloc;
+        std::atomic<const map_type*> _current;
+        std::atomic<uint64_t> _epoch{1};
+        mutable Table _readers{std::max<std::size_t>(64, 4 * std::size_t(std::thread::hardware_concurrency()))};
+        mutable std::mutex _writer;
+        std::vector<Retired> _retired;
+
+        /**
+         * Claims a free slot with the current epoch, before the version is loaded.
+         * Probes each table once from the thread's own slot, appending a table past the last one if all are pinned.
+         * All sequentially consistent: a reader that loads a version before it is replaced has stored its epoch before the
+         * replacement, so the writer's scan sees it; one whose epoch is newer loads the newer version.
+         */
+        std::atomic<uint64_t>* pin() const {
+            const std::size_t hint = detail::reader_hint();
+            for (Table* table = &_readers; ; ) {
+                for (std::size_t i = 0; i < table->size; ++i) {
+                    std::atomic<uint64_t>& slot = table->slots[(hint + i) % table->size].epoch;
+                    uint64_t expected = 0;
+                    if (slot.load(std::memory_order_relaxed) == 0 && slot.compare_exchange_strong(expected, _epoch.load()))
+                        return &slot;
+                }
+                Table* next = table->next.load();
+                if (!next) {
+                    auto appended = std::make_unique<Table>(table->size);
+                    if (table->next.compare_exchange_strong(next, appended.get())) next = appended.release();
+                }
+                table = next;
+            }
+        }
+
+        void publish(std::unique_ptr<map_type> next) {
+            next->index();
+            next->search();
+            const map_type* previous = _current.exchange(next.release());
+            _retired.push_back({std::unique_ptr<const map_type>(previous), _epoch.fetch_add(1) + 1});
+            collect();
+        }
+
+        // Frees the versions retired before the oldest pinned epoch
+        void collect() {
+            uint64_t oldest = _epoch.load();
+            for (const Table* table = &_readers; table; table = table->next.load())
+                for (std::size_t i = 0; i < table->size; ++i) {
+                    const uint64_t pinned = table->slots[i].epoch.load();
+                    if (pinned && pinned < oldest) oldest = pinned;
+                }
+            std::erase_if(_retired, [&](const Retired& retired) { return retired.epoch <= oldest; });
+        }
+    };
+
+}; // namespace dattatypes
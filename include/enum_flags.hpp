@@ -7,8 +7,12 @@
 
 namespace dattatypes {
 
+    // False for every non-enum, without naming its underlying type, so the operators below drop out of overload sets
     template <typename T>
-    constexpr bool is_scoped_enum_v = std::is_enum_v<T> && !std::is_convertible_v<T, std::underlying_type_t<T>>;
+    constexpr bool is_scoped_enum_v = false;
+    template <typename T>
+        requires std::is_enum_v<T>
+    constexpr bool is_scoped_enum_v<T> = !std::is_convertible_v<T, std::underlying_type_t<T>>;
 
     // Bitwise Enum Operators
     template <typename T>
@@ -1,11 +1,66 @@
 #pragma once
 // === HEADER ONLY ===
 
+#include <algorithm>
 #include <concepts>
 #include <cmath>
+#include <cstdint>
+#include <limits>
+#include <stdexcept>
+#include <type_traits>
 
 namespace dattatypes {
 
+    /**
+     * Rounding of the right shifts that drop fractional bits, e.g. in `Prec::operator*`.
+     * Every mode is integer only and branch-free, so results are identical on every platform and vectorize.
+     */
+    enum class Rounding {
+        toward_zero,    // Truncation, like integer division and float-to-integer casts
+        floor,          // Toward negative infinity; a bare arithmetic shift, the cheapest
+        nearest,        // To nearest, ties toward positive infinity
+    };
+
+    /**
+     * Behaviour of `Prec` arithmetic whose result does not fit the underlying type.
+     * - wrap      : Two's complement wrap-around, at no extra cost (default).
+     * - saturate  : Clamp to the nearest representable value, computed in widened intermediates.
+     * - trap      : Throw std::overflow_error in debug builds; identical to wrap when NDEBUG is defined.
+     */
+    enum class Overflow {
+        wrap,
+        saturate,
+        trap,
+    };
+
+    namespace detail {
+
+        __extension__ typedef __int128 int128_t;
+        __extension__ typedef unsigned __int128 uint128_t;
+
+        /**
+         * value /= 2^shift, rounded as given.
+         * E is the element type, which lets V also be a SIMD vector of E (see simd.hpp), or a 128-bit integer.
+         * Works in place, since returning wide vectors by value changes the ABI.
+         */
+        template <Rounding rounding, int shift, typename E, typename V>
+        constexpr void shift_right(V& value) {
+            constexpr int bits = 8 * sizeof(E);
+            if constexpr (shift <= 0)
+                return;
+            else if constexpr (shift >= bits)
+                value = V{}; // Nothing is left, and the shift would be undefined
+            else if constexpr (rounding == Rounding::floor || (rounding == Rounding::toward_zero && E(-1) > E(0)))
+                value >>= shift;
+            else if constexpr (rounding == Rounding::toward_zero)
+                value = (value + ((value >> (bits - 1)) & (((E(1) << (shift - 1)) - 1) * 2 + 1))) >> shift; // Bias negative values by 2^shift - 1
+            else
+                value = (value + (E(1) << (shift - 1))) >> shift;
+        }
+
+    }; // namespace detail
+
+
     /**
      * Fixed Precision Integers : Template class Prec
      *
@@ -20,6 +75,8 @@ namespace dattatypes {
      *           - A positive `order` defines fractional precision, where the fractional unit is (1 / 2^order).
      *           - A negative `order` implies left-shifting the input value, effectively scaling integers up.
      *             This can be used for unit multipliers or handling larger ranges at the cost of fractional precision.
+     * - rounding : How fractional bits are dropped, see `Rounding`. Defaults to truncation toward zero.
+     * - overflow : What happens when a result does not fit T, see `Overflow`. Defaults to wrap-around.
      *
      * Concept:
      * - Internally stores a scaled integer (`_data`) representing the fixed-point number.
@@ -49,47 +106,130 @@ namespace dattatypes {
      * Limitations:
      * - Precision loss can occur during divisions or repeated multiplications without appropriate scaling.
      * - Overflow risks depend on the size of T and the value of `order`. Higher `order` reduces effective numeric range.
+     *   Choose `Overflow::saturate` or `Overflow::trap` where wrap-around is not acceptable.
      * - Negative `order` shifts can increase numeric range but sacrifice precision at low values.
      * - Logical misuse of operators (e.g., increment on unit types) is not type-enforced by the class and requires
      *   usage discipline.
      */
-    template <typename T, int order>
+    template <typename T, int order, Rounding rounding = Rounding::toward_zero, Overflow overflow = Overflow::wrap>
         requires std::integral<T>
     class Prec {
     public:
         using value_type = T;
-        static constexpr T _n = order;
+        // Integer wide enough for the product of two values of up to 32 bits
+        using wide_type = std::conditional_t<std::is_signed_v<T>, int64_t, uint64_t>;
+        // Integers that hold any sum or product of two values exactly
+        using sum_type = std::conditional_t<(sizeof(T) < 8), int64_t, detail::int128_t>;
+        using product_type = std::conditional_t<(sizeof(T) < 4 || (sizeof(T) == 4 && std::is_signed_v<T>)), int64_t,
+                             std::conditional_t<(sizeof(T) == 8 && std::is_unsigned_v<T>), detail::uint128_t, detail::int128_t>>;
+        static constexpr int _n = order;
+        static constexpr Rounding _rounding = rounding;
+#ifdef NDEBUG
+        static constexpr Overflow _overflow = (overflow == Overflow::trap) ? Overflow::wrap : overflow;
+#else
+        static constexpr Overflow _overflow = overflow;
+#endif
     private:
-        // Factor for converting incoming floats or negative numbers.
-        static constexpr float _f = (_n >= 0) ? 1.0f / float(T(1) << _n) : float(T(1) << -_n);
+        // Factor for converting incoming floats.
+        static constexpr float _f = [] {
+            float f = 1;
+            for (int i = 0; i < ((_n >= 0) ? _n : -_n); ++i) f *= 2;
+            return (_n >= 0) ? 1 / f : f;
+        }();
         static constexpr float _if = 1/_f;
 
         constexpr Prec(T raw_data, bool is_raw) : _data(raw_data) {}
 
     public:
         T _data;
+        // Narrow an exact intermediate into T, following the overflow policy
+        template <typename I>
+        static constexpr T narrow(const I value) {
+            if constexpr (_overflow == Overflow::wrap)
+                return T(value);
+            else {
+                constexpr I lo = I(std::numeric_limits<T>::min()), hi = I(std::numeric_limits<T>::max());
+                if constexpr (_overflow == Overflow::trap) {
+                    if (value < lo || value > hi) throw std::overflow_error("Prec arithmetic overflowed");
+                    return T(value);
+                }
+                else return T((value < lo) ? lo : ((value > hi) ? hi : value));
+            }
+        }
+        // Raw sum, difference and product, following the overflow policy
+        template <typename I>
+        static constexpr T add(const T a, const I b) {
+            if constexpr (_overflow == Overflow::wrap) return T(uint64_t(a) + uint64_t(b));
+            else return narrow(sum_type(a) + sum_type(b));
+        }
+        template <typename I>
+        static constexpr T sub(const T a, const I b) {
+            if constexpr (_overflow == Overflow::wrap) return T(uint64_t(a) - uint64_t(b));
+            else return narrow(sum_type(a) - sum_type(b));
+        }
+        // The product is exact in product_type, so wrap truncates the rescaled product rather than overflowing it
+        static constexpr T mul(const T a, const T b) {
+            product_type product = product_type(a) * product_type(b);
+            if constexpr (_n >= 0) product <<= _n;
+            else detail::shift_right<rounding, -_n, product_type>(product);
+            return narrow(product);
+        }
+
         // Scale from integer space to data space
-        constexpr int64_t scale(const int64_t value) const {
-            if constexpr (_n >= 0)
-                return (value >= 0) ? value >> _n : value * _f;
+        static constexpr int64_t scale(const int64_t value) {
+            if constexpr (_n >= 0) {
+                int64_t scaled = value;
+                detail::shift_right<rounding, _n, int64_t>(scaled);
+                return scaled;
+            }
+            else if constexpr (-_n >= 64)
+                return 0;
             else
-                return (value >= 0) ? value << -_n : value * _f;
+                return value << -_n;
         }
         // Scale from data space to integer space
-        constexpr int64_t iscale(const int64_t value) const {
+        template <std::integral I = int64_t>
+        static constexpr I iscale(I value) {
             if constexpr (_n >= 0)
-                return (value >= 0) ? value << _n : value * _if;
+                value <<= _n;
             else
-                return (value >= 0) ? value >> -_n : value * _if;
+                detail::shift_right<rounding, -_n, I>(value);
+            return value;
+        }
+        // Scale from float space to data space, saturating past +-2^62 (+-2^126 for 64-bit T), and NaN to 0.
+        // Sums of T with the result never overflow sum_type, and values out of that range are out of the range of T.
+        static constexpr sum_type fscale(const double value) { return clamp_scaled(value * _f); }
+        // As fscale, for arithmetic: past that range the trap policy throws
+        static constexpr sum_type fscale_checked(const double value) {
+            if constexpr (_overflow == Overflow::trap)
+                if (!(value * _f > -scaled_limit && value * _f < scaled_limit)) throw std::overflow_error("Prec arithmetic overflowed");
+            return fscale(value);
+        }
+        static constexpr double scaled_limit = (sizeof(T) < 8) ? 0x1p62 : 0x1p126;
+        // Truncates to sum_type, saturating instead of the undefined conversion, and NaN to 0
+        static constexpr sum_type clamp_scaled(const double value) {
+            if (value > -scaled_limit && value < scaled_limit) return sum_type(value);
+            if (value != value) return 0;
+            return sum_type((value < 0) ? -scaled_limit : scaled_limit);
+        }
+        // Narrow a raw value computed in floating point into T, following the overflow policy; wrap truncates as fscale does
+        static constexpr T fnarrow(const double value) {
+            if constexpr (_overflow == Overflow::wrap) return T(clamp_scaled(value));
+            else {
+                constexpr double half = double(uint64_t(1) << (8 * sizeof(T) - 1));
+                constexpr double lo = std::is_signed_v<T> ? -half : 0.0, hi = std::is_signed_v<T> ? half : 2 * half;
+                if (value >= lo && value < hi) return T(value);
+                if constexpr (_overflow == Overflow::trap) throw std::overflow_error("Prec arithmetic overflowed");
+                else if (value != value) return T(0);
+                else return (value < lo) ? std::numeric_limits<T>::min() : std::numeric_limits<T>::max();
+            }
         }
-        // Scale from float space to data space
-        constexpr int64_t fscale(const double value) const { return int64_t(value * _f); }
 
 
         constexpr Prec() = default;
         constexpr ~Prec() = default;
-        constexpr Prec(const std::integral auto value) : _data(scale(value)) {}
-        constexpr Prec(const std::floating_point auto value) : _data(fscale(value)) {}
+        constexpr Prec(const std::integral auto value) : _data(narrow(scale(value))) {}
+        constexpr Prec(const std::floating_point auto value) : _data(narrow(fscale_checked(value))) {}
         constexpr Prec(const Prec& copy_from) : _data(copy_from._data) {}
         constexpr Prec(Prec&& move_from) : _data(move_from._data) { move_from._data = 0; }
 
@@ -114,26 +254,26 @@ namespace dattatypes {
         constexpr bool operator>=(const Prec other) const { return _data >= other._data; }
 
         // Direct Assignment Operators: ( = )
-        constexpr Prec& operator=(const std::integral auto value) { _data = scale(value); return *this; }
-        constexpr Prec& operator=(const std::floating_point auto value) { _data = fscale(value); return *this; }
+        constexpr Prec& operator=(const std::integral auto value) { _data = narrow(scale(value)); return *this; }
+        constexpr Prec& operator=(const std::floating_point auto value) { _data = narrow(fscale_checked(value)); return *this; }
 
         // Move and Copy Operators: ( = )
         constexpr Prec& operator=(const Prec& other) { _data = other._data; return *this; }
         constexpr Prec& operator=(Prec&& other) { _data = other._data; other._data=0; return *this; }
 
         // Aritmetic Assignment Operators: ( +=, -=, *=, /= )
-        constexpr Prec& operator+=(const std::integral auto value) { _data += scale(value); return *this; }
-        constexpr Prec& operator-=(const std::integral auto value) { _data -= scale(value); return *this; }
-        constexpr Prec& operator*=(const std::integral auto value) { _data *= value; return *this; }
+        constexpr Prec& operator+=(const std::integral auto value) { _data = add(_data, scale(value)); return *this; }
+        constexpr Prec& operator-=(const std::integral auto value) { _data = sub(_data, scale(value)); return *this; }
+        constexpr Prec& operator*=(const std::integral auto value) { _data = narrow(product_type(_data) * value); return *this; }
         constexpr Prec& operator/=(const std::integral auto value) { _data /= value; return *this; }
-        constexpr Prec& operator+=(const std::floating_point auto value) { _data += fscale(value); return *this; }
-        constexpr Prec& operator-=(const std::floating_point auto value) { _data -= fscale(value); return *this; }
-        constexpr Prec& operator*=(const std::floating_point auto value) { _data *= value; return *this; }
-        constexpr Prec& operator/=(const std::floating_point auto value) { _data /= value; return *this; }
-        constexpr Prec& operator+=(const Prec other) { _data += other._data; return *this; }
-        constexpr Prec& operator-=(const Prec other) { _data -= other._data; return *this; }
-        constexpr Prec& operator*=(const Prec other) { (_data *= other._data) <<= (_n); return *this; }
-        constexpr Prec& operator/=(const Prec other) { ((_data >>= _n) /= other._data); return *this; }
+        constexpr Prec& operator+=(const std::floating_point auto value) { _data = add(_data, fscale_checked(value)); return *this; }
+        constexpr Prec& operator-=(const std::floating_point auto value) { _data = sub(_data, fscale_checked(value)); return *this; }
+        constexpr Prec& operator*=(const std::floating_point auto value) { _data = fnarrow(double(_data) * value); return *this; }
+        constexpr Prec& operator/=(const std::floating_point auto value) { _data = fnarrow(double(_data) / value); return *this; }
+        constexpr Prec& operator+=(const Prec other) { _data = add(_data, other._data); return *this; }
+        constexpr Prec& operator-=(const Prec other) { _data = sub(_data, other._data); return *this; }
+        constexpr Prec& operator*=(const Prec other) { _data = mul(_data, other._data); return *this; }
+        constexpr Prec& operator/=(const Prec other) { _data = narrow(scale(_data / other._data)); return *this; }
 
         // Bitwise Assignment Operators: ( >>=, <<=, &=, ^=, |= )
         constexpr Prec& operator>>=(const unsigned value) { _data >>= value; return *this; }
@@ -146,24 +286,24 @@ namespace dattatypes {
         constexpr Prec& operator|=(const Prec other) { _data |= other._data; return *this; }
 
         // Aritmetic Operators:         ( +, -, *, / )
-        constexpr Prec operator+(const std::integral auto value) const { return Prec(_data + scale(value), true); }
-        constexpr Prec operator-(const std::integral auto value) const { return Prec(_data - scale(value), true); }
-        constexpr Prec operator*(const std::integral auto value) const { return Prec(_data * value, true); }
+        constexpr Prec operator+(const std::integral auto value) const { return Prec(add(_data, scale(value)), true); }
+        constexpr Prec operator-(const std::integral auto value) const { return Prec(sub(_data, scale(value)), true); }
+        constexpr Prec operator*(const std::integral auto value) const { return Prec(narrow(product_type(_data) * value), true); }
         constexpr Prec operator/(const std::integral auto value) const { return Prec(_data / value, true); }
-        constexpr Prec operator+(const std::floating_point auto value) const { return Prec(_data + fscale(value), true); }
-        constexpr Prec operator-(const std::floating_point auto value) const { return Prec(_data - fscale(value), true); }
-        constexpr Prec operator*(const std::floating_point auto value) const { return Prec(_data * value, true); }
-        constexpr Prec operator/(const std::floating_point auto value) const { return Prec(_data / value, true); }
-        constexpr Prec operator+(const Prec other) const { return Prec(_data + other._data, true); }
-        constexpr Prec operator-(const Prec other) const { return Prec(_data - other._data, true); }
-        constexpr Prec operator*(const Prec other) const { return Prec(iscale(_data * other._data), true); }
-        constexpr Prec operator/(const Prec other) const { return Prec(scale(_data / other._data), true); }
+        constexpr Prec operator+(const std::floating_point auto value) const { return Prec(add(_data, fscale_checked(value)), true); }
+        constexpr Prec operator-(const std::floating_point auto value) const { return Prec(sub(_data, fscale_checked(value)), true); }
+        constexpr Prec operator*(const std::floating_point auto value) const { return Prec(fnarrow(double(_data) * value), true); }
+        constexpr Prec operator/(const std::floating_point auto value) const { return Prec(fnarrow(double(_data) / value), true); }
+        constexpr Prec operator+(const Prec other) const { return Prec(add(_data, other._data), true); }
+        constexpr Prec operator-(const Prec other) const { return Prec(sub(_data, other._data), true); }
+        constexpr Prec operator*(const Prec other) const { return Prec(mul(_data, other._data), true); }
+        constexpr Prec operator/(const Prec other) const { return Prec(narrow(scale(_data / other._data)), true); }
 
         // Unary Operators: ( !, ++, --, -, ~ )
         constexpr bool operator!() const { return bool(!_data); }
-        constexpr Prec& operator++() { _data += scale(1); return *this; }
-        constexpr Prec& operator--() { _data -= scale(1); return *this; }
-        constexpr Prec operator-() const { return Prec(-_data, true); }
+        constexpr Prec& operator++() { _data = add(_data, scale(1)); return *this; }
+        constexpr Prec& operator--() { _data = sub(_data, scale(1)); return *this; }
+        constexpr Prec operator-() const { return Prec(sub(T(0), _data), true); }
         constexpr Prec operator~() const { return Prec(~_data, true); }
 
         // Bitwise  Operators:          ( >>=, <<=, &=, ^=, |= )
@@ -177,7 +317,7 @@ namespace dattatypes {
         constexpr Prec operator|(const Prec other) const { return Prec(_data | other._data, true); }
 
         // Conversion Operators:        (int, bool, double, Prec)
-        constexpr operator int() const { return iscale(_data); }
+        constexpr operator int() const { return int(iscale(int64_t(_data))); }
         constexpr operator bool() const { return _data != 0; }
         constexpr operator double() const { return double(_data * _if); }
 
@@ -212,6 +352,27 @@ namespace dattatypes {
             return (_data > scaled - 1) && (_data < scaled + 1);
         }
 
+        /**
+         * 1 / C, rounded with the rounding policy and narrowed with the overflow policy.
+         * Turns a division by a constant into a multiplication: `x * prec32::reciprocal<3>()`.
+         * The product rounds twice; `div_by<C>(x)` (prec_divisor.hpp) gives the exact `x / C`.
+         */
+        template <auto C>
+            requires std::integral<decltype(C)>
+        static constexpr Prec reciprocal() {
+            static_assert(C != 0, "reciprocal of zero");
+            using I = detail::int128_t;
+            // 2^-order / C = num / den
+            I num = 1, den = I(C);
+            if constexpr (_n < 0) num <<= -_n;
+            else den <<= _n;
+            if constexpr (rounding == Rounding::nearest) { num = 2 * num + den; den *= 2; }
+            I quotient = num / den;
+            if constexpr (rounding != Rounding::toward_zero)
+                if ((num % den != 0) && ((num < 0) != (den < 0))) --quotient;
+            return Prec(narrow(quotient), true);
+        }
+
         // (De)Serialization
         template <class Archive>
         void serialize(Archive &ar) { ar(_data); }
@@ -0,0 +1,367 @@
+#pragma once
+// === HEADER ONLY ===
+
+#include <algorithm>
+#include <span>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <stdexcept>
+#include <type_traits>
+#include <tuple>
+
+#include "simd.hpp"
+#include "prec_utils.hpp"
+
+namespace dattatypes {
+
+    /**
+     * Batch arithmetic for spans of Prec numbers.
+     *
+     * Every function applies the matching scalar operator element-wise and writes into `out`,
+     * which may alias an input. Results are bit-identical to the scalar operators:
+     * whole registers go through the vector kernels, and the remainder through the scalar operators.
+     *
+     * The element type is deduced from `out`, or given explicitly: `add<prec32>(a, b, out)`.
+     * Saturating types use saturating kernels; trapping types run the scalar operators to keep their checks.
+     */
+    namespace detail {
+
+        template <PrecType P>
+        using raw_t = typename P::value_type;
+
+        template <PrecType P>
+        const raw_t<P>* raw(std::span<const P> values) {
+            static_assert(sizeof(P) == sizeof(raw_t<P>) && std::is_standard_layout_v<P>);
+            return reinterpret_cast<const raw_t<P>*>(values.data());
+        }
+        template <PrecType P>
+        raw_t<P>* raw(std::span<P> values) {
+            static_assert(sizeof(P) == sizeof(raw_t<P>) && std::is_standard_layout_v<P>);
+            return reinterpret_cast<raw_t<P>*>(values.data());
+        }
+
+        inline void check_sizes(std::size_t expected, std::size_t size) {
+            if (expected != size)
+                throw std::runtime_error("batch spans should be of equal size");
+        }
+
+        // Runs `vector_body(i)` for every whole register of `lanes` values, and `scalar_body(i)` for the rest.
+        template <std::size_t lanes, typename VectorBody, typename ScalarBody>
+        inline void for_lanes(std::size_t n, VectorBody&& vector_body, ScalarBody&& scalar_body) {
+            std::size_t i = 0;
+            if constexpr (simd::enabled && lanes > 1)
+                for (; i + lanes <= n; i += lanes) vector_body(i);
+            for (; i < n; ++i) scalar_body(i);
+        }
+
+        // Whether `Prec::operator+` and `operator-` have vector kernels for P. Trapping needs the scalar checks.
+        template <PrecType P>
+        inline constexpr bool vector_add = simd::enabled && (P::_overflow != Overflow::trap);
+
+        // Whether `Prec::operator*` has a vector kernel for P. The product must be exact in 64-bit lanes, so 64-bit types
+        // stay scalar and saturation also excludes uint32_t.
+        template <PrecType P>
+        inline constexpr bool vector_mul = simd::enabled && (P::_n < 0) && (sizeof(raw_t<P>) <= 4) &&
+            ((P::_overflow == Overflow::wrap) || (P::_overflow == Overflow::saturate && sizeof(typename P::product_type) == 8));
+
+        /**
+         * One register of `Prec::operator+`, or `operator-` if `subtract`.
+         * Works on unsigned lanes, where wrap-around is defined.
+         * Saturation replaces the overflowed lanes by the limit they crossed, found from the sign bits.
+         */
+        template <PrecType P, bool subtract>
+        inline void add_lanes(const raw_t<P>* a, const raw_t<P>* b, raw_t<P>* out) {
+            using T = raw_t<P>;
+            using U = std::make_unsigned_t<T>;
+            constexpr std::size_t L = simd::lanes<T>;
+
+            using VT = simd::vec<T, L>;
+            using VU = simd::vec<U, L>;
+
+            const VU ua = (VU)simd::load<VT>(a), ub = (VU)simd::load<VT>(b);
+            VU result;
+            if constexpr (subtract) result = ua - ub;
+            else result = ua + ub;
+
+            if constexpr (P::_overflow == Overflow::saturate) {
+                if constexpr (std::is_signed_v<T>) {
+                    VU crossed;
+                    if constexpr (subtract) crossed = (ua ^ ub) & (ua ^ result);
+                    else crossed = (ua ^ result) & (ub ^ result);
+                    const VU limit = (ua >> (8 * sizeof(T) - 1)) + U(std::numeric_limits<T>::max()); // min for negative a
+                    result = ((VT)crossed < 0) ? limit : result;
+                }
+                else if constexpr (subtract) result = (ua < ub) ? VU{} : result;
+                else result = (result < ua) ? ~VU{} : result;
+            }
+            simd::store(out, (VT)result);
+        }
+
+        /**
+         * One register of `Prec::operator*`.
+         * Mirrors `Prec::mul` on the widened product, with the same rounding and overflow policy.
+         */
+        template <PrecType P>
+        inline void mul_lanes(const raw_t<P>* a, const raw_t<P>* b, raw_t<P>* out) {
+            using T = raw_t<P>;
+            using Wide = std::conditional_t<(P::_overflow == Overflow::saturate), typename P::product_type, typename P::wide_type>;
+            constexpr std::size_t L = simd::lanes<T>;
+
+            using VT = simd::vec<T, L>;
+            using VW = simd::vec<Wide, L>;
+
+            VW product = __builtin_convertvector(simd::load<VT>(a), VW) * __builtin_convertvector(simd::load<VT>(b), VW);
+            detail::shift_right<P::_rounding, -P::_n, Wide>(product);
+            if constexpr (P::_overflow == Overflow::saturate) {
+                const VW lo = VW{} + Wide(std::numeric_limits<T>::min()), hi = VW{} + Wide(std::numeric_limits<T>::max());
+                product = (product < lo) ? lo : ((product > hi) ? hi : product);
+            }
+            simd::store(out, __builtin_convertvector(product, VT));
+        }
+
+    }; // namespace detail
+
+
+    // Element-wise sum: out = a + b
+    template <PrecType P>
+    void add(std::span<const std::type_identity_t<P>> a, std::span<const std::type_identity_t<P>> b, std::span<P> out) {
+        detail::check_sizes(out.size(), a.size());
+        detail::check_sizes(out.size(), b.size());
+        using T = detail::raw_t<P>;
+        constexpr std::size_t L = detail::vector_add<P> ? simd::lanes<T> : 1;
+        const T *pa = detail::raw(a), *pb = detail::raw(b);
+        T* po = detail::raw(out);
+
+        detail::for_lanes<L>(out.size(),
+            [&](std::size_t i) { if constexpr (L > 1) detail::add_lanes<P, false>(pa + i, pb + i, po + i); },
+            [&](std::size_t i) { out[i] = a[i] + b[i]; });
+    }
+
+    // Sum with one value: out = a + b, broadcasting b to every lane
+    template <PrecType P>
+    void add(std::span<const std::type_identity_t<P>> a, const std::type_identity_t<P> b, std::span<P> out) {
+        detail::check_sizes(out.size(), a.size());
+        using T = detail::raw_t<P>;
+        constexpr std::size_t L = detail::vector_add<P> ? simd::lanes<T> : 1;
+        T lanes[L];
+        std::fill_n(lanes, L, b._data);
+        const T* pa = detail::raw(a);
+        T* po = detail::raw(out);
+
+        detail::for_lanes<L>(out.size(),
+            [&](std::size_t i) { if constexpr (L > 1) detail::add_lanes<P, false>(pa + i, lanes, po + i); },
+            [&](std::size_t i) { out[i] = a[i] + b; });
+    }
+
+    // Element-wise difference: out = a - b
+    template <PrecType P>
+    void sub(std::span<const std::type_identity_t<P>> a, std::span<const std::type_identity_t<P>> b, std::span<P> out) {
+        detail::check_sizes(out.size(), a.size());
+        detail::check_sizes(out.size(), b.size());
+        using T = detail::raw_t<P>;
+        constexpr std::size_t L = detail::vector_add<P> ? simd::lanes<T> : 1;
+        const T *pa = detail::raw(a), *pb = detail::raw(b);
+        T* po = detail::raw(out);
+
+        detail::for_lanes<L>(out.size(),
+            [&](std::size_t i) { if constexpr (L > 1) detail::add_lanes<P, true>(pa + i, pb + i, po + i); },
+            [&](std::size_t i) { out[i] = a[i] - b[i]; });
+    }
+
+    // Element-wise product: out = a * b
+    template <PrecType P>
+    void mul(std::span<const std::type_identity_t<P>> a, std::span<const std::type_identity_t<P>> b, std::span<P> out) {
+        detail::check_sizes(out.size(), a.size());
+        detail::check_sizes(out.size(), b.size());
+        using T = detail::raw_t<P>;
+        constexpr std::size_t L = detail::vector_mul<P> ? simd::lanes<T> : 1;
+        const T *pa = detail::raw(a), *pb = detail::raw(b);
+        T* po = detail::raw(out);
+
+        detail::for_lanes<L>(out.size(),
+            [&](std::size_t i) { if constexpr (L > 1) detail::mul_lanes<P>(pa + i, pb + i, po + i); },
+            [&](std::size_t i) { out[i] = a[i] * b[i]; });
+    }
+
+    // Element-wise quotient: out = a / b
+    // Integer division has no vector instruction, so this is a plain loop over the scalar operator.
+    template <PrecType P>
+    void div(std::span<const std::type_identity_t<P>> a, std::span<const std::type_identity_t<P>> b, std::span<P> out) {
+        detail::check_sizes(out.size(), a.size());
+        detail::check_sizes(out.size(), b.size());
+        for (std::size_t i = 0; i < out.size(); ++i)
+            out[i] = a[i] / b[i];
+    }
+
+    // Element-wise multiply-add: out = a * b + c
+    template <PrecType P>
+    void fma(std::span<const std::type_identity_t<P>> a, std::span<const std::type_identity_t<P>> b,
+             std::span<const std::type_identity_t<P>> c, std::span<P> out) {
+        detail::check_sizes(out.size(), a.size());
+        detail::check_sizes(out.size(), b.size());
+        detail::check_sizes(out.size(), c.size());
+        using T = detail::raw_t<P>;
+        constexpr std::size_t L = detail::vector_mul<P> ? simd::lanes<T> : 1;
+        const T *pa = detail::raw(a), *pb = detail::raw(b), *pc = detail::raw(c);
+        T* po = detail::raw(out);
+
+        detail::for_lanes<L>(out.size(),
+            [&](std::size_t i) {
+                if constexpr (L > 1) {
+                    T product[L];
+                    detail::mul_lanes<P>(pa + i, pb + i, product);
+                    detail::add_lanes<P, false>(product, pc + i, po + i);
+                }
+            },
+            [&](std::size_t i) { out[i] = a[i] * b[i] + c[i]; });
+    }
+
+    // Element-wise clamp into [lo, hi]
+    template <PrecType P>
+    void clamp(std::span<const std::type_identity_t<P>> values, const P lo, const P hi, std::span<P> out) {
+        detail::check_sizes(out.size(), values.size());
+        using T = detail::raw_t<P>;
+        constexpr std::size_t L = simd::lanes<T>;
+        const T* pv = detail::raw(values);
+        T* po = detail::raw(out);
+
+        detail::for_lanes<L>(out.size(),
+            [&](std::size_t i) {
+                using V = simd::vec<T, L>;
+                const V v = simd::load<V>(pv + i), vlo = V{} + lo._data, vhi = V{} + hi._data;
+                simd::store(po + i, (v < vlo) ? vlo : ((v > vhi) ? vhi : v));
+            },
+            [&](std::size_t i) { out[i] = (values[i] < lo) ? lo : ((values[i] > hi) ? hi : values[i]); });
+    }
+
+
+    /**
+     * Batch roots, see prec_utils.hpp.
+     * The integer square root has no vector instruction, so these are plain loops over the scalar functions.
+     */
+    template <PrecType P>
+    void sqrt(std::span<const std::type_identity_t<P>> values, std::span<P> out) {
+        detail::check_sizes(out.size(), values.size());
+        for (std::size_t i = 0; i < out.size(); ++i)
+            out[i] = dattatypes::sqrt(values[i]);
+    }
+
+    template <PrecType P>
+    void rsqrt(std::span<const std::type_identity_t<P>> values, std::span<P> out) {
+        detail::check_sizes(out.size(), values.size());
+        for (std::size_t i = 0; i < out.size(); ++i)
+            out[i] = dattatypes::rsqrt(values[i]);
+    }
+
+    template <PrecType P>
+    void hypot(std::span<const std::type_identity_t<P>> xs, std::span<const std::type_identity_t<P>> ys, std::span<P> out) {
+        detail::check_sizes(out.size(), xs.size());
+        detail::check_sizes(out.size(), ys.size());
+        for (std::size_t i = 0; i < out.size(); ++i)
+            out[i] = dattatypes::hypot(xs[i], ys[i]);
+    }
+
+
+    /**
+     * Batch exponentials and logarithms, see prec_utils.hpp.
+     * Template arguments follow the scalar functions: result type first, e.g. `exp2<prec64, prec32>(values, out)`.
+     */
+    template <PrecType R, PrecType T>
+    void exp2(std::span<const std::type_identity_t<T>> values, std::span<R> out) {
+        detail::check_sizes(out.size(), values.size());
+        for (std::size_t i = 0; i < out.size(); ++i)
+            out[i] = dattatypes::exp2<R>(values[i]);
+    }
+
+    template <PrecType R, PrecType T>
+    void log2(std::span<const std::type_identity_t<T>> values, std::span<R> out) {
+        detail::check_sizes(out.size(), values.size());
+        for (std::size_t i = 0; i < out.size(); ++i)
+            out[i] = dattatypes::log2<R>(values[i]);
+    }
+
+    template <PrecType R, PrecType T>
+    void exp(std::span<const std::type_identity_t<T>> values, std::span<R> out) {
+        detail::check_sizes(out.size(), values.size());
+        for (std::size_t i = 0; i < out.size(); ++i)
+            out[i] = dattatypes::exp<R>(values[i]);
+    }
+
+    template <PrecType R, PrecType T>
+    void log(std::span<const std::type_identity_t<T>> values, std::span<R> out) {
+        detail::check_sizes(out.size(), values.size());
+        for (std::size_t i = 0; i < out.size(); ++i)
+            out[i] = dattatypes::log<R>(values[i]);
+    }
+
+    template <PrecType R, PrecType T, PrecType U>
+    void pow(std::span<const std::type_identity_t<T>> bases, std::span<const std::type_identity_t<U>> exponents, std::span<R> out) {
+        detail::check_sizes(out.size(), bases.size());
+        detail::check_sizes(out.size(), exponents.size());
+        for (std::size_t i = 0; i < out.size(); ++i)
+            out[i] = dattatypes::pow<R>(bases[i], exponents[i]);
+    }
+
+    // Element-wise interpolation: out = a + (b - a) t
+    template <PrecType P, PrecType U>
+    void lerp(std::span<const std::type_identity_t<P>> a, std::span<const std::type_identity_t<P>> b,
+              std::span<const std::type_identity_t<U>> t, std::span<P> out) {
+        detail::check_sizes(out.size(), a.size());
+        detail::check_sizes(out.size(), b.size());
+        detail::check_sizes(out.size(), t.size());
+        for (std::size_t i = 0; i < out.size(); ++i)
+            out[i] = dattatypes::lerp(a[i], b[i], t[i]);
+    }
+
+
+    /**
+     * Batch trigonometry, see prec_utils.hpp.
+     * Template arguments follow the scalar functions: result type first, e.g. `sin<unit32, angle32>(angles, out)`.
+     */
+    template <PrecType Slope, PrecType Angle>
+    void sin(std::span<const std::type_identity_t<Angle>> angles, std::span<Slope> out) {
+        detail::check_sizes(out.size(), angles.size());
+        for (std::size_t i = 0; i < out.size(); ++i)
+            out[i] = dattatypes::sin<Slope>(angles[i]);
+    }
+
+    template <PrecType Slope, PrecType Angle>
+    void cos(std::span<const std::type_identity_t<Angle>> angles, std::span<Slope> out) {
+        detail::check_sizes(out.size(), angles.size());
+        for (std::size_t i = 0; i < out.size(); ++i)
+            out[i] = dattatypes::cos<Slope>(angles[i]);
+    }
+
+    template <PrecType Slope, PrecType Angle>
+    void sincos(std::span<const std::type_identity_t<Angle>> angles, std::span<Slope> sines, std::span<Slope> cosines) {
+        detail::check_sizes(sines.size(), angles.size());
+        detail::check_sizes(cosines.size(), angles.size());
+        for (std::size_t i = 0; i < angles.size(); ++i)
+            std::tie(sines[i], cosines[i]) = dattatypes::sincos<Slope>(angles[i]);
+    }
+
+    template <PrecType Angle, PrecType T>
+    void atan2(std::span<const std::type_identity_t<T>> ys, std::span<const std::type_identity_t<T>> xs, std::span<Angle> out) {
+        detail::check_sizes(out.size(), ys.size());
+        detail::check_sizes(out.size(), xs.size());
+        for (std::size_t i = 0; i < out.size(); ++i)
+            out[i] = dattatypes::atan2<Angle>(ys[i], xs[i]);
+    }
+
+    template <PrecType Angle, PrecType Slope>
+    void asin(std::span<const std::type_identity_t<Slope>> values, std::span<Angle> out) {
+        detail::check_sizes(out.size(), values.size());
+        for (std::size_t i = 0; i < out.size(); ++i)
+            out[i] = dattatypes::asin<Angle>(values[i]);
+    }
+
+    template <PrecType Angle, PrecType Slope>
+    void acos(std::span<const std::type_identity_t<Slope>> values, std::span<Angle> out) {
+        detail::check_sizes(out.size(), values.size());
+        for (std::size_t i = 0; i < out.size(); ++i)
+            out[i] = dattatypes::acos<Angle>(values[i]);
+    }
+
+
+}; // namespace dattatypes
@@ -0,0 +1,75 @@
+#pragma once
+// === HEADER ONLY ===
+
+#include <utility>
+
+#include "prec_utils.hpp"
+
+namespace dattatypes {
+
+    /**
+     * Complex number of two Prec values.
+     * `std::complex<Prec>` is unspecified by the standard, and rescales after every partial product.
+     * Here the products are fused: each part sums the exact raw products in a wide integer,
+     * and rounds once with the rounding and overflow policy of P.
+     */
+    template <PrecType P>
+    struct complex {
+        P _re{}, _im{};
+
+        constexpr complex() = default;
+        constexpr complex(const P re, const P im = P()) : _re(re), _im(im) {}
+
+        constexpr P real() const { return _re; }
+        constexpr P imag() const { return _im; }
+
+        constexpr bool operator==(const complex& other) const { return _re == other._re && _im == other._im; }
+        constexpr bool operator!=(const complex& other) const { return !(*this == other); }
+
+        constexpr complex operator+(const complex& other) const { return complex(_re + other._re, _im + other._im); }
+        constexpr complex operator-(const complex& other) const { return complex(_re - other._re, _im - other._im); }
+        constexpr complex operator-() const { return complex(-_re, -_im); }
+        constexpr complex operator*(const P factor) const { return complex(_re * factor, _im * factor); }
+        constexpr complex operator*(const complex& other) const {
+            using detail::accum_product, detail::from_accum;
+            return complex(from_accum<P>(accum_product(_re, other._re) - accum_product(_im, other._im)),
+                           from_accum<P>(accum_product(_re, other._im) + accum_product(_im, other._re)));
+        }
+        constexpr complex& operator+=(const complex& other) { return *this = *this + other; }
+        constexpr complex& operator-=(const complex& other) { return *this = *this - other; }
+        constexpr complex& operator*=(const complex& other) { return *this = *this * other; }
+        constexpr complex& operator*=(const P factor) { return *this = *this * factor; }
+
+        // (De)Serialization
+        template <class Archive>
+        void serialize(Archive &ar) { ar(_re, _im); }
+    };
+
+    template <PrecType P>
+    constexpr complex<P> operator*(const P factor, const complex<P>& z) { return z * factor; }
+
+    template <PrecType P>
+    constexpr complex<P> conj(const complex<P>& z) { return complex<P>(z._re, -z._im); }
+
+    // Squared magnitude, rounded once
+    template <PrecType P>
+    constexpr P norm(const complex<P>& z) {
+        return detail::from_accum<P>(detail::accum_product(z._re, z._re) + detail::accum_product(z._im, z._im));
+    }
+
+    // Magnitude, exact like `hypot`
+    template <PrecType P>
+    constexpr P abs(const complex<P>& z) { return hypot(z._re, z._im); }
+
+    /**
+     * Unit complex number at `angle`: cos(angle) + i sin(angle).
+     * The result type defaults to the angle type, or may be given first, e.g. `polar<unit32>(angle)`.
+     */
+    template <typename Result = void, PrecType Angle>
+    constexpr auto polar(const Angle& angle) {
+        const auto [s, c] = sincos<Result>(angle);
+        return complex<std::remove_const_t<decltype(c)>>(c, s);
+    }
+
+
+}; // namespace dattatypes
@@ -0,0 +1,230 @@
+#pragma once
+// === HEADER ONLY ===
+
+#include <span>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <ratio>
+#include <type_traits>
+#include <utility>
+
+#include "simd.hpp"
+#include "prec_utils.hpp"
+#include "prec_batch.hpp"
+
+namespace dattatypes {
+
+    /**
+     * Division and multiplication of Prec numbers by compile-time constants, without a divide instruction.
+     *
+     * - `div_by<C>(x)` is `x / C`: the raw value divided by the integer C, truncated toward zero.
+     * - `mul_by<std::ratio<N, D>>(x)` is `x * N / D` computed exactly, truncated toward zero once,
+     *   then narrowed with the overflow policy of P.
+     *
+     * Both use a magic-number reciprocal (Granlund & Montgomery, "Division by Invariant Integers using Multiplication";
+     * the variant of libdivide): a multiply-high, an optional add and a shift, exact for every input.
+     * The batch `div_by` runs the same steps on whole SIMD registers, where integer division has no instruction.
+     * See also `Prec::reciprocal<C>()`, for a constant factor 1 / C.
+     */
+    namespace detail {
+
+        // Integer of twice the width of T, for the multiply-high of T up to 32 bits
+        template <typename T>
+        using twice_t = std::conditional_t<(sizeof(T) == 1), std::conditional_t<std::is_signed_v<T>, int16_t, uint16_t>,
+                        std::conditional_t<(sizeof(T) == 2), std::conditional_t<std::is_signed_v<T>, int32_t, uint32_t>,
+                        std::conditional_t<(sizeof(T) == 4), std::conditional_t<std::is_signed_v<T>, int64_t, uint64_t>,
+                        std::conditional_t<std::is_signed_v<T>, int128_t, uint128_t>>>>;
+
+        // V with its lanes of type E: E itself for scalars, a SIMD vector of as many lanes of E otherwise
+        template <typename V>
+        struct lane_traits { using type = V; static constexpr std::size_t count = 1; };
+        template <typename V>
+            requires (!std::is_integral_v<V>)
+        struct lane_traits<V> {
+            using type = std::remove_cvref_t<decltype(std::declval<V>()[0])>;
+            static constexpr std::size_t count = sizeof(V) / sizeof(type);
+        };
+        template <typename V, typename E>
+        using rebind_t = std::conditional_t<std::is_integral_v<V>, E, simd::vec<E, lane_traits<V>::count>>;
+
+        /**
+         * high = the high half of the double-width product a * m, per lane of V.
+         * Vectors widen their lanes, so they are limited to 32-bit T; see `vector_div_by`.
+         * Writes through a reference, since returning wide vectors by value changes the ABI.
+         */
+        template <typename T, typename V>
+        constexpr void mulhi(const V& a, const T m, V& high) {
+            constexpr int bits = 8 * sizeof(T);
+            using W = twice_t<T>;
+            if constexpr (std::is_integral_v<V>)
+                high = V((W(a) * W(m)) >> bits);
+            else {
+                static_assert(sizeof(T) <= 4, "vector multiply-high should have lanes of up to 32 bits");
+                using VW = rebind_t<V, W>;
+                high = __builtin_convertvector((__builtin_convertvector(a, VW) * W(m)) >> bits, V);
+            }
+        }
+
+        /**
+         * Truncating division by the constant d, for T up to 64 bits and V a T or a SIMD vector of T.
+         * The magic number is the rounded-up 2^(bits + shift) / |d|, taking one more bit when the rounding error
+         * is too large for every input; that bit is then added back after the multiply-high.
+         */
+        template <typename T, T d>
+        struct divisor {
+            static_assert(std::is_integral_v<T> && d != 0, "divisor should be a non-zero integer");
+            using U = std::make_unsigned_t<T>;
+            static constexpr int bits = 8 * sizeof(T);
+            static constexpr bool negative = std::is_signed_v<T> && (d < 0);
+            static constexpr U magnitude = negative ? U(U(0) - U(d)) : U(d);
+            static constexpr int log2 = std::bit_width(magnitude) - 1;
+            static constexpr bool power = std::has_single_bit(magnitude);
+
+            struct Magic { T magic; int shift; bool add; };
+            static constexpr Magic magic = [] {
+                if constexpr (power) return Magic{T(0), log2, false};
+                else {
+                    // 2^(bits + log2) / |d| for unsigned T, 2^(bits - 1 + log2) / |d| for signed T
+                    const uint128_t power2 = uint128_t(1) << (bits - int(std::is_signed_v<T>) + log2);
+                    uint128_t proposed = power2 / magnitude;
+                    const uint128_t remainder = power2 - proposed * magnitude;
+                    Magic result;
+                    if (magnitude - remainder < (uint128_t(1) << log2)) {
+                        result.shift = std::is_signed_v<T> ? log2 - 1 : log2;
+                        result.add = false;
+                    }
+                    else {
+                        proposed *= 2;
+                        if (2 * remainder >= magnitude) ++proposed;
+                        result.shift = log2;
+                        result.add = true;
+                    }
+                    const U m = U(proposed + 1);
+                    result.magic = negative ? T(U(U(0) - m)) : T(m);
+                    return result;
+                }
+            }();
+
+            // x /= d, in place like `shift_right`
+            template <typename V>
+            static constexpr void divide(V& x) {
+                using VU = rebind_t<V, U>;
+                if constexpr (std::is_unsigned_v<T>) {
+                    if constexpr (power) x = V(x >> log2);
+                    else {
+                        V q;
+                        mulhi<T>(x, magic.magic, q);
+                        if constexpr (magic.add) x = V(V(V(V(x - q) >> 1) + q) >> magic.shift);
+                        else x = V(q >> magic.shift);
+                    }
+                }
+                else if constexpr (power) {
+                    // Bias negative values by |d| - 1, so the shift truncates toward zero
+                    const VU biased = VU((VU)x + VU((VU)V(x >> (bits - 1)) & U(magnitude - 1)));
+                    x = V((V)biased >> log2);
+                    if constexpr (negative) x = (V)VU(VU{} - (VU)x);
+                }
+                else {
+                    V q;
+                    mulhi<T>(x, magic.magic, q);
+                    if constexpr (magic.add) {
+                        if constexpr (negative) q = (V)VU((VU)q - (VU)x);
+                        else q = (V)VU((VU)q + (VU)x);
+                    }
+                    q = V(q >> magic.shift);
+                    x = (V)VU((VU)q + VU((VU)q >> (bits - 1))); // Round negative quotients up, toward zero
+                }
+            }
+        };
+
+        /**
+         * Whether div_by vectorizes for P. The multiply-high widens the lanes: 8 and 16-bit lanes always gain,
+         * 32-bit lanes need the 64-bit multiplies of AVX2, and 64-bit lanes would need a 128-bit product.
+         */
+        template <PrecType P>
+        inline constexpr bool vector_div_by = simd::enabled &&
+            (sizeof(typename P::value_type) <= 2 || (sizeof(typename P::value_type) == 4 && simd::register_bytes >= 32));
+
+        template <typename R, PrecType P>
+        constexpr void check_ratio() {
+            using T = typename P::value_type;
+            static_assert(R::num > -(int64_t(1) << 31) && R::num < (int64_t(1) << 31) && R::den < (int64_t(1) << 31),
+                          "ratio should have a numerator and denominator of up to 31 bits");
+            static_assert(std::is_signed_v<T> || R::num >= 0, "ratio should be non-negative for unsigned types");
+            static_assert(std::in_range<T>(R::den), "ratio denominator should fit the type");
+        }
+
+    }; // namespace detail
+
+
+    // x / C, truncated toward zero like `Prec::operator/(integral)`; C should fit the underlying type
+    template <auto C, PrecType P>
+        requires std::integral<decltype(C)>
+    constexpr P div_by(const P x) {
+        using T = typename P::value_type;
+        static_assert(C != 0 && std::in_range<T>(C), "divisor should be non-zero and fit the type");
+        P result = x;
+        detail::divisor<T, T(C)>::divide(result._data);
+        return result;
+    }
+
+    // x * N / D, exact and truncated toward zero, then narrowed with the overflow policy of P
+    template <typename R, PrecType P>
+    constexpr P mul_by(const P x) {
+        using T = typename P::value_type;
+        detail::check_ratio<R, P>();
+        P result;
+        if constexpr (sizeof(T) <= 4) {
+            int64_t product = int64_t(x._data) * R::num;
+            detail::divisor<int64_t, R::den>::divide(product);
+            result._data = P::narrow(product);
+        }
+        else {
+            // x = q * D + r, with |r| < D: x * N / D = q * N + r * N / D, where r * N fits 64 bits
+            T q = x._data;
+            detail::divisor<T, T(R::den)>::divide(q);
+            const T r = T(x._data - T(q * T(R::den)));
+            int64_t rest = int64_t(r) * R::num;
+            detail::divisor<int64_t, R::den>::divide(rest);
+            using I = std::conditional_t<std::is_signed_v<T>, detail::int128_t, detail::uint128_t>;
+            result._data = P::narrow(I(q) * I(R::num) + I(rest));
+        }
+        return result;
+    }
+
+
+    // Element-wise out = div_by<C>(values)
+    template <auto C, PrecType P>
+        requires std::integral<decltype(C)>
+    void div_by(std::span<const std::type_identity_t<P>> values, std::span<P> out) {
+        detail::check_sizes(out.size(), values.size());
+        using T = detail::raw_t<P>;
+        static_assert(C != 0 && std::in_range<T>(C), "divisor should be non-zero and fit the type");
+        constexpr std::size_t L = detail::vector_div_by<P> ? simd::lanes<T> : 1;
+        const T* pv = detail::raw(values);
+        T* po = detail::raw(out);
+
+        detail::for_lanes<L>(out.size(),
+            [&](std::size_t i) {
+                if constexpr (L > 1) {
+                    auto x = simd::load<simd::vec<T, L>>(pv + i);
+                    detail::divisor<T, T(C)>::divide(x);
+                    simd::store(po + i, x);
+                }
+            },
+            [&](std::size_t i) { out[i] = div_by<C>(values[i]); });
+    }
+
+    /**
+     * Element-wise out = mul_by<R>(values)
+     * The exact product needs 64-bit lanes, whose multiply-high has no instruction; the scalar loop is faster.
+     */
+    template <typename R, PrecType P>
+    void mul_by(std::span<const std::type_identity_t<P>> values, std::span<P> out) {
+        detail::check_sizes(out.size(), values.size());
+        for (std::size_t i = 0; i < out.size(); ++i)
+            out[i] = mul_by<R>(values[i]);
+    }
+
+}; // namespace dattatypes
@@ -0,0 +1,172 @@
+#pragma once
+// === HEADER ONLY ===
+
+#include <vector>
+#include <algorithm>
+#include <limits>
+#include <span>
+#include <cstddef>
+#include <cstdint>
+#include <bit>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+
+#include "prec_complex.hpp"
+
+namespace dattatypes {
+
+    // How an FFT keeps its values in range
+    enum class FFTScaling {
+        per_stage,      // Divide by the radix after every stage: the forward transform returns DFT / n
+        block_floating, // Divide only where a stage could overflow, and report the total as an exponent
+    };
+
+    /**
+     * Fixed-point FFT plan for complex<P> samples, e.g. unit16 or unit32, of a power-of-two size.
+     * In-place and iterative: a bit-reversal permutation, one radix-2 stage when log2(n) is odd,
+     * then radix-4 stages. Twiddles are precomputed in Q30 with the integer `sincos`, and every
+     * butterfly runs in 64-bit integers, so the output is identical on every platform.
+     *
+     * Each butterfly rounds its twiddle products and its stage scaling once, to nearest,
+     * and saturates its outputs. With `per_stage` scaling, inputs of magnitude up to 1.0 in the raw range
+     * (e.g. |z| <= 1 for unit types) cannot overflow.
+     *
+     * `forward` and `inverse` return an exponent e: the result times 2^e is the transform,
+     *   forward:  X[k] = sum_j x[j] W^(jk),   inverse:  x[j] = 1/n sum_k X[k] W^(-jk),   W = exp(-2 pi i / n).
+     */
+    template <PrecType P>
+    class FFT {
+        using T = typename P::value_type;
+        static_assert(std::is_signed_v<T> && sizeof(T) <= 4, "FFT samples should be signed and at most 32 bits.");
+
+    public:
+        using value_type = complex<P>;
+
+        explicit FFT(const std::size_t n, const FFTScaling scaling = FFTScaling::per_stage)
+            : _n(n), _log2n(std::countr_zero(n)), _scaling(scaling) {
+            if (n == 0 || !std::has_single_bit(n) || n > (std::size_t(1) << 30))
+                throw std::runtime_error("FFT size should be a power of two, at most 2^30");
+
+            // W^k = cos(2 pi k / n) - i sin(2 pi k / n), as angle32 of -2k/n half turns; radix-4 uses k < 3n/4
+            _twiddles.resize(std::max<std::size_t>(1, 3 * n / 4));
+            for (std::size_t k = 0; k < _twiddles.size(); ++k) {
+                angle32 angle;
+                angle._data = int32_t(-int64_t((uint64_t(k) << 31) / n));
+                const auto [s, c] = sincos(angle);
+                _twiddles[k] = {c._data, s._data};
+            }
+            for (std::size_t i = 0, j = 0; i < n; ++i) {
+                if (i < j) _swaps.emplace_back(uint32_t(i), uint32_t(j));
+                std::size_t bit = n >> 1;
+                for (; j & bit; bit >>= 1) j ^= bit;
+                j |= bit;
+            }
+        }
+
+        std::size_t size() const { return _n; }
+        FFTScaling scaling() const { return _scaling; }
+
+        int forward(std::span<value_type> data) const { return transform<false>(data); }
+        int inverse(std::span<value_type> data) const { return transform<true>(data) - _log2n; }
+
+    private:
+        static constexpr int twiddle_frac = 30;
+        // Extra fractional bits the butterflies carry until their single rounding
+        static constexpr int guard = 16;
+
+        struct Wide { int64_t re, im; };
+
+        std::size_t _n;
+        int _log2n;
+        FFTScaling _scaling;
+        std::vector<std::pair<int32_t, int32_t>> _twiddles; // (re, im) of W^k in Q30
+        std::vector<std::pair<uint32_t, uint32_t>> _swaps;  // Bit-reversal permutation
+
+        static Wide load(const value_type& z) { return {int64_t(z._re._data) << guard, int64_t(z._im._data) << guard}; }
+
+        // z * W^k with `guard` extra fractional bits, conjugating the twiddle for the inverse
+        template <bool inverse>
+        Wide rotate(const value_type& z, const std::size_t k) const {
+            const int64_t c = _twiddles[k].first, s = inverse ? -_twiddles[k].second : _twiddles[k].second;
+            const int64_t re = z._re._data, im = z._im._data;
+            constexpr int shift = twiddle_frac - guard;
+            constexpr int64_t half = int64_t(1) << (shift - 1);
+            return {(re * c - im * s + half) >> shift, (re * s + im * c + half) >> shift};
+        }
+
+        // Drops `guard + scale` bits to nearest and saturates into P
+        static P narrow(const int64_t value, const int scale) {
+            const int shift = guard + scale;
+            const int64_t rounded = (value + (int64_t(1) << (shift - 1))) >> shift;
+            P result;
+            result._data = T(std::clamp<int64_t>(rounded, std::numeric_limits<T>::min(), std::numeric_limits<T>::max()));
+            return result;
+        }
+
+        // Bits a stage of the given radix has to drop to stay in range
+        int stage_scale(std::span<const value_type> data, const int radix_bits) const {
+            if (_scaling == FFTScaling::per_stage) return radix_bits;
+            // Every output part is bounded by the sum of the input magnitudes, themselves below |re| + |im|
+            int64_t bound = 0;
+            for (const auto& z : data) {
+                const int64_t re = z._re._data, im = z._im._data;
+                bound = std::max(bound, (re < 0 ? -re : re) + (im < 0 ? -im : im));
+            }
+            // One extra unit per butterfly input covers the rounding of the twiddle products
+            const int64_t reach = (bound + 1) << radix_bits;
+            int scale = 0;
+            while ((reach >> scale) > std::numeric_limits<T>::max()) ++scale;
+            return scale;
+        }
+
+        template <bool inverse>
+        int transform(std::span<value_type> data) const {
+            if (data.size() != _n)
+                throw std::runtime_error("FFT data should match the size of the plan");
+            for (const auto& [i, j] : _swaps) std::swap(data[i], data[j]);
+
+            int exponent = 0;
+            std::size_t half = 1;
+            if (_log2n & 1) {
+                const int scale = stage_scale(data, 1);
+                for (std::size_t i = 0; i < _n; i += 2) {
+                    const Wide a = load(data[i]), b = load(data[i + 1]);
+                    data[i]     = value_type(narrow(a.re + b.re, scale), narrow(a.im + b.im, scale));
+                    data[i + 1] = value_type(narrow(a.re - b.re, scale), narrow(a.im - b.im, scale));
+                }
+                exponent += scale;
+                half = 2;
+            }
+
+            // Radix-4 stages merge two radix-2 stages of the bit-reversed order: blocks of 4 * half,
+            // with inputs at offsets j, j + half, j + 2 half, j + 3 half rotated by W^0, W^2j, W^j, W^3j of the block
+            for (; half < _n; half *= 4) {
+                const int scale = stage_scale(data, 2);
+                const std::size_t stride = _n / (4 * half);
+                for (std::size_t block = 0; block < _n; block += 4 * half)
+                    for (std::size_t j = 0; j < half; ++j) {
+                        value_type* z = data.data() + block + j;
+                        const Wide a0 = load(z[0]);
+                        const Wide y1 = rotate<inverse>(z[half], 2 * j * stride);
+                        const Wide y2 = rotate<inverse>(z[2 * half], j * stride);
+                        const Wide y3 = rotate<inverse>(z[3 * half], 3 * j * stride);
+
+                        const Wide s0 = {a0.re + y1.re, a0.im + y1.im}, d0 = {a0.re - y1.re, a0.im - y1.im};
+                        const Wide s1 = {y2.re + y3.re, y2.im + y3.im};
+                        // d1 = -i (y2 - y3) forward, +i (y2 - y3) inverse
+                        const Wide d1 = inverse ? Wide{y3.im - y2.im, y2.re - y3.re} : Wide{y2.im - y3.im, y3.re - y2.re};
+
+                        z[0]        = value_type(narrow(s0.re + s1.re, scale), narrow(s0.im + s1.im, scale));
+                        z[half]     = value_type(narrow(d0.re + d1.re, scale), narrow(d0.im + d1.im, scale));
+                        z[2 * half] = value_type(narrow(s0.re - s1.re, scale), narrow(s0.im - s1.im, scale));
+                        z[3 * half] = value_type(narrow(d0.re - d1.re, scale), narrow(d0.im - d1.im, scale));
+                    }
+                exponent += scale;
+            }
+            return exponent;
+        }
+    };
+
+
+}; // namespace dattatypes
@@ -0,0 +1,353 @@
+#pragma once
+// === HEADER ONLY ===
+
+#include <vector>
+#include <algorithm>
+#include <limits>
+#include <span>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <stdexcept>
+#include <type_traits>
+
+#include "simd.hpp"
+#include "prec_utils.hpp"
+#include "prec_batch.hpp"
+
+namespace dattatypes {
+
+    /**
+     * Streaming fixed-point filters: FIR, Biquad cascades, Decimator and Interpolator.
+     *
+     * Samples are P, e.g. unit16 or unit32, and coefficients C, e.g. unit16 or Prec<int32_t, -30> for gains
+     * up to 2.0. Every output is the exact sum of its products, in a wide integer, rounded once to nearest
+     * and saturated into P. Filters keep their state between calls to `process`, so a stream can be fed
+     * in blocks of any size, with the same output as in one call, and filters chain by passing one's
+     * output to the next. `reset` clears the state.
+     */
+    namespace detail {
+
+        template <PrecType P, PrecType C>
+        inline constexpr bool filter_types = std::is_signed_v<typename P::value_type> && std::is_signed_v<typename C::value_type> &&
+            sizeof(typename P::value_type) <= 4 && sizeof(typename C::value_type) <= 4 && C::_n < 0;
+
+        // Samples per block copied into the window buffer of a FIR-based filter
+        inline constexpr std::size_t filter_block = 1024;
+
+        /**
+         * Bits of the narrowest accumulator, 32, 64 or 128, that cannot overflow on any input:
+         * the sum of |taps| times the largest sample, plus the rounding half, below 2^(bits - 1).
+         */
+        template <PrecType P, PrecType C>
+        int accum_bits(std::span<const typename C::value_type> taps) {
+            uint128_t bound = 0;
+            for (const auto g : taps) bound += uint128_t(g < 0 ? -int64_t(g) : int64_t(g));
+            bound = (bound << (8 * sizeof(typename P::value_type) - 1)) + (uint128_t(1) << (-C::_n - 1));
+            return (bound < (uint128_t(1) << 31)) ? 32 : (bound < (uint128_t(1) << 63)) ? 64 : 128;
+        }
+
+        // Runs `body.template operator()<I>()` with the accumulator integer of `bits`
+        template <typename Body>
+        void with_accum(const int bits, Body&& body) {
+            if (bits == 32) body.template operator()<int32_t>();
+            else if (bits == 64) body.template operator()<int64_t>();
+            else body.template operator()<int128_t>();
+        }
+
+        // round(sum / 2^frac), saturated into T
+        template <typename T, int frac, typename I>
+        constexpr T filter_output(I sum) {
+            shift_right<Rounding::nearest, frac, I>(sum);
+            return T(std::clamp<I>(sum, std::numeric_limits<T>::min(), std::numeric_limits<T>::max()));
+        }
+
+        /**
+         * out[i] = sum_m g[m] b[i + m], for i in [0, n), rounded and saturated.
+         * SIMD across outputs: one register of sums per L outputs, each tap a broadcast multiply-add.
+         */
+        template <typename T, typename G, int frac, typename I>
+        void fir_outputs(const T* b, const G* g, const std::size_t taps, T* out, const std::size_t n) {
+            constexpr std::size_t L = (sizeof(I) <= 8) ? simd::lanes<I> : 1;
+            for_lanes<L>(n,
+                [&](std::size_t i) {
+                    if constexpr (L > 1) {
+                        using VI = simd::vec<I, L>;
+                        using VT = simd::vec<T, L>;
+                        VI sum{};
+                        for (std::size_t m = 0; m < taps; ++m)
+                            sum += __builtin_convertvector(simd::load<VT>(b + i + m), VI) * I(g[m]);
+                        shift_right<Rounding::nearest, frac, I>(sum);
+                        const VI lo = VI{} + I(std::numeric_limits<T>::min()), hi = VI{} + I(std::numeric_limits<T>::max());
+                        sum = (sum < lo) ? lo : ((sum > hi) ? hi : sum);
+                        simd::store(out + i, __builtin_convertvector(sum, VT));
+                    }
+                },
+                [&](std::size_t i) {
+                    I sum = 0;
+                    for (std::size_t m = 0; m < taps; ++m) sum += I(b[i + m]) * I(g[m]);
+                    out[i] = filter_output<T, frac>(sum);
+                });
+        }
+
+        // sum_m g[m] b[m], rounded and saturated. SIMD across taps, for outputs that are not consecutive.
+        template <typename T, typename G, int frac, typename I>
+        T fir_output(const T* b, const G* g, const std::size_t taps) {
+            constexpr std::size_t L = (sizeof(I) <= 8) ? simd::lanes<I> : 1;
+            I sum = 0;
+            if constexpr (L > 1) {
+                using VI = simd::vec<I, L>;
+                using VT = simd::vec<T, L>;
+                using VG = simd::vec<G, L>;
+                VI lanes{};
+                std::size_t m = 0;
+                for (; m + L <= taps; m += L)
+                    lanes += __builtin_convertvector(simd::load<VT>(b + m), VI) * __builtin_convertvector(simd::load<VG>(g + m), VI);
+                for (std::size_t j = 0; j < L; ++j) sum += lanes[j];
+                for (; m < taps; ++m) sum += I(b[m]) * I(g[m]);
+            }
+            else for (std::size_t m = 0; m < taps; ++m) sum += I(b[m]) * I(g[m]);
+            return filter_output<T, frac>(sum);
+        }
+
+        /**
+         * Window buffer of a FIR: the last `history` inputs, followed by the current block.
+         * Taps are stored reversed, so output i is the dot product of the taps with the window from i.
+         */
+        template <PrecType P, PrecType C>
+        class FIRWindow {
+        protected:
+            using T = typename P::value_type;
+            using G = typename C::value_type;
+            static constexpr int frac = -C::_n;
+
+            std::vector<T> _buffer;
+            std::size_t _history;
+
+            explicit FIRWindow(const std::size_t history) : _buffer(history + filter_block), _history(history) {}
+
+            // Appends up to filter_block inputs after the history
+            void load(const T* in, const std::size_t n) { std::memcpy(_buffer.data() + _history, in, n * sizeof(T)); }
+            // Keeps the last `history` of the inputs loaded
+            void retire(const std::size_t n) { std::memmove(_buffer.data(), _buffer.data() + n, _history * sizeof(T)); }
+
+        public:
+            void reset() { std::fill(_buffer.begin(), _buffer.end(), T(0)); }
+        };
+
+    }; // namespace detail
+
+
+    /**
+     * Finite impulse response filter: y[i] = sum_k taps[k] x[i - k].
+     * The sums run in 32-bit lanes where the taps guarantee they fit, e.g. unit16 samples through
+     * unit16 taps whose magnitudes add up to less than 2.0, otherwise in 64 bits, or 128 bits.
+     */
+    template <PrecType P, PrecType C = P>
+    class FIR : public detail::FIRWindow<P, C> {
+        static_assert(detail::filter_types<P, C>, "Filter samples and coefficients should be signed, fractional and at most 32 bits.");
+        using Base = detail::FIRWindow<P, C>;
+        using typename Base::T;
+        using typename Base::G;
+
+    public:
+        explicit FIR(std::span<const std::type_identity_t<C>> taps) : Base(taps.size() - (taps.empty() ? 0 : 1)) {
+            if (taps.empty()) throw std::runtime_error("FIR taps should not be empty");
+            for (auto it = taps.rbegin(); it != taps.rend(); ++it) _taps.push_back(it->_data);
+            _accum_bits = detail::accum_bits<P, C>(_taps);
+        }
+
+        std::size_t size() const { return _taps.size(); }
+
+        // Filters `in` into `out`, of the same size, which may alias it
+        void process(std::span<const std::type_identity_t<P>> in, std::span<P> out) {
+            detail::check_sizes(out.size(), in.size());
+            const T* pi = detail::raw(in);
+            T* po = detail::raw(out);
+            for (std::size_t first = 0; first < in.size(); first += detail::filter_block) {
+                const std::size_t n = std::min(detail::filter_block, in.size() - first);
+                this->load(pi + first, n);
+                detail::with_accum(_accum_bits, [&]<typename I>() {
+                    detail::fir_outputs<T, G, Base::frac, I>(this->_buffer.data(), _taps.data(), _taps.size(), po + first, n);
+                });
+                this->retire(n);
+            }
+        }
+
+    private:
+        std::vector<G> _taps;
+        int _accum_bits;
+    };
+
+
+    /**
+     * Keeps every `factor`-th output of a FIR, e.g. an anti-aliasing low-pass, computing only those.
+     * `process` returns the number of outputs written; `outputs(n)` tells how many the next n inputs give.
+     */
+    template <PrecType P, PrecType C = P>
+    class Decimator : public detail::FIRWindow<P, C> {
+        static_assert(detail::filter_types<P, C>, "Filter samples and coefficients should be signed, fractional and at most 32 bits.");
+        using Base = detail::FIRWindow<P, C>;
+        using typename Base::T;
+        using typename Base::G;
+
+    public:
+        Decimator(const std::size_t factor, std::span<const std::type_identity_t<C>> taps)
+            : Base(taps.size() - (taps.empty() ? 0 : 1)), _factor(factor) {
+            if (taps.empty() || factor == 0) throw std::runtime_error("Decimator taps and factor should not be empty");
+            for (auto it = taps.rbegin(); it != taps.rend(); ++it) _taps.push_back(it->_data);
+            _accum_bits = detail::accum_bits<P, C>(_taps);
+        }
+
+        std::size_t factor() const { return _factor; }
+        std::size_t outputs(const std::size_t n) const { return (n > _skip) ? (n - _skip - 1) / _factor + 1 : 0; }
+
+        std::size_t process(std::span<const std::type_identity_t<P>> in, std::span<P> out) {
+            if (out.size() < outputs(in.size())) throw std::runtime_error("Decimator output should hold outputs(input size)");
+            const T* pi = detail::raw(in);
+            T* po = detail::raw(out);
+            std::size_t written = 0;
+            for (std::size_t first = 0; first < in.size(); first += detail::filter_block) {
+                const std::size_t n = std::min(detail::filter_block, in.size() - first);
+                this->load(pi + first, n);
+                detail::with_accum(_accum_bits, [&]<typename I>() {
+                    for (std::size_t i = _skip; i < n; i += _factor)
+                        po[written++] = detail::fir_output<T, G, Base::frac, I>(this->_buffer.data() + i, _taps.data(), _taps.size());
+                });
+                _skip = (_skip < n) ? (_factor - 1) - (n - 1 - _skip) % _factor : _skip - n;
+                this->retire(n);
+            }
+            return written;
+        }
+
+        void reset() { Base::reset(); _skip = 0; }
+
+    private:
+        std::size_t _factor;
+        std::size_t _skip = 0; // Inputs before the next output
+        std::vector<G> _taps;
+        int _accum_bits;
+    };
+
+
+    /**
+     * Raises the sample rate by `factor`: zero-stuffing followed by a FIR, computed as `factor` polyphase
+     * sub-filters, so no product with a stuffed zero is made. Zero-stuffing divides the gain by the factor,
+     * which the taps should make up, e.g. a low-pass with a DC gain of `factor`.
+     * Every input gives `factor` outputs.
+     */
+    template <PrecType P, PrecType C = P>
+    class Interpolator : public detail::FIRWindow<P, C> {
+        static_assert(detail::filter_types<P, C>, "Filter samples and coefficients should be signed, fractional and at most 32 bits.");
+        using Base = detail::FIRWindow<P, C>;
+        using typename Base::T;
+        using typename Base::G;
+
+    public:
+        Interpolator(const std::size_t factor, std::span<const std::type_identity_t<C>> taps)
+            : Base(std::max<std::size_t>(phase_taps(factor, taps.size()), 1) - 1), _factor(factor), _phase_taps(phase_taps(factor, taps.size())) {
+            if (taps.empty() || factor == 0) throw std::runtime_error("Interpolator taps and factor should not be empty");
+            // Phase p has taps[p], taps[p + factor], ..., zero-padded to the same length and reversed
+            _taps.resize(_factor * _phase_taps);
+            _accum_bits = 32;
+            for (std::size_t p = 0; p < _factor; ++p) {
+                G* phase = _taps.data() + p * _phase_taps;
+                for (std::size_t k = 0; k * _factor + p < taps.size(); ++k) phase[_phase_taps - 1 - k] = taps[k * _factor + p]._data;
+                _accum_bits = std::max(_accum_bits, detail::accum_bits<P, C>(std::span<const G>(phase, _phase_taps)));
+            }
+        }
+
+        std::size_t factor() const { return _factor; }
+        std::size_t outputs(const std::size_t n) const { return n * _factor; }
+
+        // Filters `in` into `out`, of `factor` times its size
+        void process(std::span<const std::type_identity_t<P>> in, std::span<P> out) {
+            detail::check_sizes(out.size(), outputs(in.size()));
+            const T* pi = detail::raw(in);
+            T* po = detail::raw(out);
+            for (std::size_t first = 0; first < in.size(); first += detail::filter_block) {
+                const std::size_t n = std::min(detail::filter_block, in.size() - first);
+                this->load(pi + first, n);
+                detail::with_accum(_accum_bits, [&]<typename I>() {
+                    for (std::size_t i = 0; i < n; ++i)
+                        for (std::size_t p = 0; p < _factor; ++p)
+                            po[(first + i) * _factor + p] = detail::fir_output<T, G, Base::frac, I>(
+                                this->_buffer.data() + i, _taps.data() + p * _phase_taps, _phase_taps);
+                });
+                this->retire(n);
+            }
+        }
+
+    private:
+        std::size_t _factor;
+        std::size_t _phase_taps;
+        std::vector<G> _taps;
+        int _accum_bits;
+
+        static std::size_t phase_taps(const std::size_t factor, const std::size_t taps) {
+            return (factor == 0) ? 0 : (taps + factor - 1) / factor;
+        }
+    };
+
+
+    // One second-order section: y[i] = b0 x[i] + b1 x[i-1] + b2 x[i-2] - a1 y[i-1] - a2 y[i-2]
+    template <PrecType C>
+    struct BiquadSection {
+        C b0, b1, b2, a1, a2;
+    };
+
+    /**
+     * Cascade of second-order IIR sections, in direct form I: each section keeps its last two inputs
+     * and outputs, and rounds and saturates once per sample, so a cascade of stable sections cannot
+     * overflow its accumulator. Coefficients should allow magnitudes up to 2.0, e.g. Prec<int32_t, -30>.
+     *
+     * The recursion is sequential in time, so each section runs over the whole block before the next,
+     * in 64-bit integers where samples and coefficients add up to at most 48 bits, otherwise 128 bits.
+     */
+    template <PrecType P, PrecType C>
+    class Biquad {
+        static_assert(detail::filter_types<P, C>, "Filter samples and coefficients should be signed, fractional and at most 32 bits.");
+        using T = typename P::value_type;
+        using G = typename C::value_type;
+        using I = std::conditional_t<(sizeof(T) + sizeof(G) <= 6), int64_t, detail::int128_t>;
+        static constexpr int frac = -C::_n;
+
+    public:
+        explicit Biquad(std::span<const BiquadSection<C>> sections) : _sections(sections.begin(), sections.end()), _state(sections.size()) {
+            if (sections.empty()) throw std::runtime_error("Biquad sections should not be empty");
+        }
+
+        std::size_t size() const { return _sections.size(); }
+
+        // Filters `in` into `out`, of the same size, which may alias it
+        void process(std::span<const std::type_identity_t<P>> in, std::span<P> out) {
+            detail::check_sizes(out.size(), in.size());
+            const T* pi = detail::raw(in);
+            T* po = detail::raw(out);
+            if (pi != po) std::memmove(po, pi, in.size() * sizeof(T));
+            for (std::size_t s = 0; s < _sections.size(); ++s) {
+                const auto& c = _sections[s];
+                const I b0 = c.b0._data, b1 = c.b1._data, b2 = c.b2._data, a1 = c.a1._data, a2 = c.a2._data;
+                auto [x1, x2, y1, y2] = _state[s];
+                for (std::size_t i = 0; i < out.size(); ++i) {
+                    const T x = po[i];
+                    const T y = detail::filter_output<T, frac>(b0 * x + b1 * x1 + b2 * x2 - a1 * y1 - a2 * y2);
+                    x2 = x1; x1 = x;
+                    y2 = y1; y1 = y;
+                    po[i] = y;
+                }
+                _state[s] = {x1, x2, y1, y2};
+            }
+        }
+
+        void reset() { std::fill(_state.begin(), _state.end(), State{}); }
+
+    private:
+        struct State { T x1 = 0, x2 = 0, y1 = 0, y2 = 0; };
+
+        std::vector<BiquadSection<C>> _sections;
+        std::vector<State> _state;
+    };
+
+
+}; // namespace dattatypes
@@ -0,0 +1,358 @@
+#pragma once
+// === HEADER ONLY ===
+
+#include <array>
+#include <vector>
+#include <span>
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+#include <concepts>
+
+#include "simd.hpp"
+#include "prec_utils.hpp"
+#include "prec_batch.hpp"
+
+namespace dattatypes {
+
+    /**
+     * Fixed-point linear algebra: Vec2/3/4, Mat3/4 and the structure-of-arrays container SoAVec3.
+     *
+     * Sums of products (dot, cross, mat-vec, mat-mat) accumulate the exact raw products in a wide integer,
+     * and round once at the end with the rounding and overflow policy of P. They are therefore more precise
+     * than chaining the Prec operators, and identical on every platform.
+     * Bulk transforms of SoAVec3 run through the SIMD kernels, bit-identical to the scalar versions.
+     */
+    namespace detail {
+
+        // Whether the bulk transforms of SoAVec3<P> have vector kernels
+        template <PrecType P>
+        inline constexpr bool vector_transform = simd::enabled &&
+            (sizeof(typename P::value_type) <= 4) && (P::_overflow != Overflow::trap);
+
+    }; // namespace detail
+
+
+    // Fixed-point vector of N Prec values
+    template <PrecType P, std::size_t N>
+    struct Vec {
+        std::array<P, N> _data{};
+
+        constexpr Vec() = default;
+        template <typename... Args>
+            requires (sizeof...(Args) == N && (std::convertible_to<Args, P> && ...))
+        constexpr Vec(const Args&... values) : _data{P(values)...} {}
+
+        static constexpr std::size_t size() { return N; }
+        constexpr P& operator[](const std::size_t i) { return _data[i]; }
+        constexpr const P& operator[](const std::size_t i) const { return _data[i]; }
+
+        constexpr P x() const { return _data[0]; }
+        constexpr P y() const requires (N >= 2) { return _data[1]; }
+        constexpr P z() const requires (N >= 3) { return _data[2]; }
+        constexpr P w() const requires (N >= 4) { return _data[3]; }
+
+        constexpr bool operator==(const Vec& other) const {
+            for (std::size_t i = 0; i < N; ++i) if (_data[i] != other._data[i]) return false;
+            return true;
+        }
+        constexpr bool operator!=(const Vec& other) const { return !(*this == other); }
+
+        // Component-wise arithmetic, through the Prec operators
+        constexpr Vec operator+(const Vec& other) const { Vec r; for (std::size_t i = 0; i < N; ++i) r[i] = _data[i] + other[i]; return r; }
+        constexpr Vec operator-(const Vec& other) const { Vec r; for (std::size_t i = 0; i < N; ++i) r[i] = _data[i] - other[i]; return r; }
+        constexpr Vec operator*(const P factor) const { Vec r; for (std::size_t i = 0; i < N; ++i) r[i] = _data[i] * factor; return r; }
+        constexpr Vec operator-() const { Vec r; for (std::size_t i = 0; i < N; ++i) r[i] = -_data[i]; return r; }
+        constexpr Vec& operator+=(const Vec& other) { return *this = *this + other; }
+        constexpr Vec& operator-=(const Vec& other) { return *this = *this - other; }
+        constexpr Vec& operator*=(const P factor) { return *this = *this * factor; }
+
+        // (De)Serialization
+        template <class Archive>
+        void serialize(Archive &ar) { ar(_data); }
+    };
+
+    template <PrecType P, std::size_t N>
+    constexpr Vec<P, N> operator*(const P factor, const Vec<P, N>& v) { return v * factor; }
+
+    template <PrecType P> using Vec2 = Vec<P, 2>;
+    template <PrecType P> using Vec3 = Vec<P, 3>;
+    template <PrecType P> using Vec4 = Vec<P, 4>;
+
+
+    // Dot product, rounded once
+    template <PrecType P, std::size_t N>
+    constexpr P dot(const Vec<P, N>& a, const Vec<P, N>& b) {
+        detail::accum_t<P> sum = 0;
+        for (std::size_t i = 0; i < N; ++i) sum += detail::accum_product(a[i], b[i]);
+        return detail::from_accum<P>(sum);
+    }
+
+    // Cross product, each component rounded once
+    template <PrecType P>
+    constexpr Vec3<P> cross(const Vec3<P>& a, const Vec3<P>& b) {
+        using detail::accum_product, detail::from_accum;
+        return Vec3<P>(from_accum<P>(accum_product(a[1], b[2]) - accum_product(a[2], b[1])),
+                       from_accum<P>(accum_product(a[2], b[0]) - accum_product(a[0], b[2])),
+                       from_accum<P>(accum_product(a[0], b[1]) - accum_product(a[1], b[0])));
+    }
+
+    /**
+     * Euclidean length, exact like `sqrt`: the largest value whose square does not exceed the sum of squares.
+     * The squares are summed in 128 bits, so there is no intermediate overflow.
+     */
+    template <PrecType P, std::size_t N>
+    constexpr P length(const Vec<P, N>& v) {
+        using V = typename P::value_type;
+        using U = std::make_unsigned_t<V>;
+        detail::uint128_t sum = 0;
+        for (std::size_t i = 0; i < N; ++i) {
+            const detail::uint128_t magnitude = (v[i]._data < 0) ? U(U(0) - U(v[i]._data)) : U(v[i]._data);
+            sum += magnitude * magnitude;
+        }
+        P result;
+        result._data = V(std::min<uint64_t>(detail::isqrt(sum), std::numeric_limits<V>::max()));
+        return result;
+    }
+
+    /**
+     * Unit vector in the direction of v, rounded to nearest. The zero vector stays zero.
+     * The result type defaults to P, or may be given first, e.g. `normalize<unit32>(v)` for full precision.
+     * Multiplies by the reciprocal square root of the sum of squares (see `rsqrt`), so there is no division.
+     */
+    template <typename Result = void, PrecType P, std::size_t N>
+    constexpr auto normalize(const Vec<P, N>& v) {
+        using R = std::conditional_t<std::is_void_v<Result>, P, Result>;
+        using V = typename P::value_type;
+        using U = std::make_unsigned_t<V>;
+        detail::uint128_t sum = 0;
+        for (std::size_t i = 0; i < N; ++i) {
+            const detail::uint128_t magnitude = (v[i]._data < 0) ? U(U(0) - U(v[i]._data)) : U(v[i]._data);
+            sum += magnitude * magnitude;
+        }
+        Vec<R, N> result;
+        if (sum == 0) return result;
+
+        // Normalise the sum into m = M * 2^64 with M in [0.25, 1.0), for an even exponent
+        const uint64_t high = uint64_t(sum >> 64);
+        int exponent = high ? 64 + std::bit_width(high) : std::bit_width(uint64_t(sum));
+        exponent += exponent & 1;
+        const uint64_t m = uint64_t((exponent >= 64) ? sum >> (exponent - 64) : sum << (64 - exponent));
+        // 1 / sqrt(sum) = y * 2^(-61 - exponent / 2)
+        const detail::int128_t y = detail::rsqrt_q61(m, 3);
+        for (std::size_t i = 0; i < N; ++i)
+            result[i] = detail::from_fixed<R>(detail::int128_t(v[i]._data) * y, 61 + exponent / 2);
+        return result;
+    }
+
+
+    // Fixed-point square matrix of N x N Prec values, stored as rows
+    template <PrecType P, std::size_t N>
+    struct Mat {
+        std::array<Vec<P, N>, N> _rows{};
+
+        constexpr Mat() = default;
+        template <typename... Rows>
+            requires (sizeof...(Rows) == N && (std::same_as<Rows, Vec<P, N>> && ...))
+        constexpr Mat(const Rows&... rows) : _rows{rows...} {}
+
+        // For unit types, where 1.0 does not fit, the diagonal saturates to the largest value below it
+        static constexpr Mat identity() {
+            Mat m;
+            for (std::size_t i = 0; i < N; ++i) m[i][i] = detail::from_fixed<P>(1, 0);
+            return m;
+        }
+
+        constexpr Vec<P, N>& operator[](const std::size_t row) { return _rows[row]; }
+        constexpr const Vec<P, N>& operator[](const std::size_t row) const { return _rows[row]; }
+
+        constexpr bool operator==(const Mat& other) const {
+            for (std::size_t i = 0; i < N; ++i) if (_rows[i] != other._rows[i]) return false;
+            return true;
+        }
+        constexpr bool operator!=(const Mat& other) const { return !(*this == other); }
+
+        constexpr Mat transpose() const {
+            Mat t;
+            for (std::size_t i = 0; i < N; ++i)
+                for (std::size_t j = 0; j < N; ++j) t[j][i] = _rows[i][j];
+            return t;
+        }
+
+        // Matrix-vector product, each component rounded once
+        constexpr Vec<P, N> operator*(const Vec<P, N>& v) const {
+            Vec<P, N> r;
+            for (std::size_t i = 0; i < N; ++i) r[i] = dot(_rows[i], v);
+            return r;
+        }
+
+        // Matrix-matrix product, each entry rounded once
+        constexpr Mat operator*(const Mat& other) const {
+            Mat r;
+            for (std::size_t i = 0; i < N; ++i)
+                for (std::size_t j = 0; j < N; ++j) {
+                    detail::accum_t<P> sum = 0;
+                    for (std::size_t k = 0; k < N; ++k) sum += detail::accum_product(_rows[i][k], other[k][j]);
+                    r[i][j] = detail::from_accum<P>(sum);
+                }
+            return r;
+        }
+
+        // (De)Serialization
+        template <class Archive>
+        void serialize(Archive &ar) { ar(_rows); }
+    };
+
+    template <PrecType P> using Mat3 = Mat<P, 3>;
+    template <PrecType P> using Mat4 = Mat<P, 4>;
+
+    // Affine transform of a point by the upper 3 x 4 block of m, i.e. (m * [p, 1]).xyz, each component rounded once
+    template <PrecType P>
+    constexpr Vec3<P> transform_point(const Mat4<P>& m, const Vec3<P>& p) {
+        Vec3<P> r;
+        for (std::size_t i = 0; i < 3; ++i) {
+            detail::accum_t<P> sum = detail::accum_unit(m[i][3]);
+            for (std::size_t k = 0; k < 3; ++k) sum += detail::accum_product(m[i][k], p[k]);
+            r[i] = detail::from_accum<P>(sum);
+        }
+        return r;
+    }
+
+
+    namespace detail {
+
+        // Rows of a 3 x 4 affine transform as wide raw values of some fractional bits `frac`,
+        // the translations already in product units, i.e. with frac plus the fractional bits of P
+        template <PrecType P>
+        using affine_rows = std::array<accum_t<P>, 12>;
+
+        template <PrecType P, std::size_t N>
+        constexpr affine_rows<P> to_affine_rows(const Mat<P, N>& m) {
+            affine_rows<P> rows{};
+            for (std::size_t r = 0; r < 3; ++r) {
+                for (std::size_t k = 0; k < 3; ++k) rows[4*r + k] = m[r][k]._data;
+                if constexpr (N == 4) rows[4*r + 3] = accum_unit(m[r][3]);
+            }
+            return rows;
+        }
+
+        // Row r of `rows` applied to the point (x, y, z), rounded and narrowed like `from_accum`
+        template <PrecType P, int frac>
+        constexpr P affine_row(const affine_rows<P>& rows, const std::size_t r, const P x, const P y, const P z) {
+            using A = accum_t<P>;
+            A sum = rows[4*r] * A(x._data) + rows[4*r + 1] * A(y._data) + rows[4*r + 2] * A(z._data) + rows[4*r + 3];
+            shift_right<P::_rounding, frac, A>(sum);
+            P result;
+            result._data = P::narrow(sum);
+            return result;
+        }
+
+        template <PrecType P, int frac>
+        constexpr Vec3<P> affine_point(const affine_rows<P>& rows, const Vec3<P>& p) {
+            return Vec3<P>(affine_row<P, frac>(rows, 0, p[0], p[1], p[2]),
+                           affine_row<P, frac>(rows, 1, p[0], p[1], p[2]),
+                           affine_row<P, frac>(rows, 2, p[0], p[1], p[2]));
+        }
+
+        // One register of points: `affine_row` in wide lanes
+        template <PrecType P, int frac, std::size_t L>
+        void affine_lanes(const affine_rows<P>& c, raw_t<P>* px, raw_t<P>* py, raw_t<P>* pz) {
+            using T = raw_t<P>;
+            using A = accum_t<P>;
+            using VT = simd::vec<T, L>;
+            using VA = simd::vec<A, L>;
+
+            const VA vx = __builtin_convertvector(simd::load<VT>(px), VA);
+            const VA vy = __builtin_convertvector(simd::load<VT>(py), VA);
+            const VA vz = __builtin_convertvector(simd::load<VT>(pz), VA);
+            T* outputs[3] = {px, py, pz};
+            VT results[3];
+            for (std::size_t r = 0; r < 3; ++r) {
+                VA sum = vx * c[4*r] + vy * c[4*r + 1] + vz * c[4*r + 2] + c[4*r + 3];
+                shift_right<P::_rounding, frac, A>(sum);
+                if constexpr (P::_overflow == Overflow::saturate) {
+                    const VA lo = VA{} + A(std::numeric_limits<T>::min()), hi = VA{} + A(std::numeric_limits<T>::max());
+                    sum = (sum < lo) ? lo : ((sum > hi) ? hi : sum);
+                }
+                results[r] = __builtin_convertvector(sum, VT);
+            }
+            for (std::size_t r = 0; r < 3; ++r) simd::store(outputs[r], results[r]);
+        }
+
+        // Applies `rows` in place to the n points of three component arrays, a register at a time where P has vector kernels
+        template <PrecType P, int frac>
+        void affine_soa(const affine_rows<P>& rows, raw_t<P>* px, raw_t<P>* py, raw_t<P>* pz, const std::size_t n) {
+            constexpr std::size_t L = vector_transform<P> ? simd::lanes<raw_t<P>> : 1;
+            for_lanes<L>(n,
+                [&](std::size_t i) { if constexpr (L > 1) affine_lanes<P, frac, L>(rows, px + i, py + i, pz + i); },
+                [&](std::size_t i) {
+                    Vec3<P> p;
+                    p[0]._data = px[i]; p[1]._data = py[i]; p[2]._data = pz[i];
+                    p = affine_point<P, frac>(rows, p);
+                    px[i] = p[0]._data; py[i] = p[1]._data; pz[i] = p[2]._data;
+                });
+        }
+
+    }; // namespace detail
+
+
+    /**
+     * Structure-of-arrays container of 3D vectors: one array per component.
+     * Keeps each component contiguous, so the bulk transforms load whole registers of one component.
+     */
+    template <PrecType P>
+    class SoAVec3 {
+    public:
+        std::vector<P> x, y, z;
+
+        SoAVec3() = default;
+        explicit SoAVec3(const std::size_t n) : x(n), y(n), z(n) {}
+
+        std::size_t size() const { return x.size(); }
+        bool empty() const { return x.empty(); }
+        void resize(const std::size_t n) { x.resize(n); y.resize(n); z.resize(n); }
+        void reserve(const std::size_t n) { x.reserve(n); y.reserve(n); z.reserve(n); }
+        void clear() { x.clear(); y.clear(); z.clear(); }
+
+        void push_back(const Vec3<P>& v) { x.push_back(v[0]); y.push_back(v[1]); z.push_back(v[2]); }
+        Vec3<P> operator[](const std::size_t i) const { return Vec3<P>(x[i], y[i], z[i]); }
+        void set(const std::size_t i, const Vec3<P>& v) { x[i] = v[0]; y[i] = v[1]; z[i] = v[2]; }
+
+        // Add `offset` to every vector
+        void translate(const Vec3<P>& offset) {
+            for (std::size_t c = 0; c < 3; ++c) {
+                std::span<P> component = components()[c];
+                add<P>(component, offset[c], component);
+            }
+        }
+
+        // Multiply every vector by `m`, in place
+        void transform(const Mat3<P>& m) { transform_rows(m); }
+
+        // Transform every vector as a point by the affine matrix `m` (see `transform_point`), in place
+        void transform(const Mat4<P>& m) { transform_rows(m); }
+
+        /**
+         * Applies the 3 x 4 `rows`, with `frac` fractional bits, in place. The building block of the
+         * bulk transforms, e.g. of quaternion rotations with rows in Q30 (see prec_quat.hpp).
+         */
+        template <int frac>
+        void apply(const detail::affine_rows<P>& rows) {
+            detail::affine_soa<P, frac>(rows, detail::raw(std::span<P>(x)), detail::raw(std::span<P>(y)),
+                                        detail::raw(std::span<P>(z)), size());
+        }
+
+    private:
+        std::array<std::span<P>, 3> components() { return {x, y, z}; }
+
+        template <std::size_t N>
+        void transform_rows(const Mat<P, N>& m) {
+            if constexpr (P::_n < 0) apply<-P::_n>(detail::to_affine_rows(m));
+            else for (std::size_t i = 0; i < size(); ++i) {
+                if constexpr (N == 4) set(i, transform_point(m, (*this)[i]));
+                else set(i, m * (*this)[i]);
+            }
+        }
+    };
+
+}; // namespace dattatypes
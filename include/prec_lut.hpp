@@ -0,0 +1,169 @@
+#pragma once
+// === HEADER ONLY ===
+
+#include <array>
+#include <span>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <algorithm>
+#include <type_traits>
+
+#include "prec_utils.hpp"
+#include "prec_batch.hpp"
+
+namespace dattatypes {
+
+    /**
+     * Interpolation between the entries of a `LUT`.
+     * - linear    : One multiply per value. The error falls with the square of the table size.
+     * - quadratic : Through both ends and the middle of every segment, two multiplies. The error falls with its cube.
+     */
+    enum class Interpolation {
+        linear,
+        quadratic,
+    };
+
+
+    namespace detail {
+
+        // Fractional bits of the interpolation weight
+        inline constexpr int lut_weight_bits = 16;
+        // Extra fractional bits of the table entries, below those of the output type
+        inline constexpr int lut_guard_bits = 8;
+
+        // 2^e as a double, at compile time
+        constexpr double exp2i(const int e) {
+            double result = 1;
+            for (int i = 0; i < e; ++i) result *= 2;
+            for (int i = 0; i > e; --i) result /= 2;
+            return result;
+        }
+
+        constexpr int64_t round_to_int(const double value) {
+            return (value >= 0) ? int64_t(value + 0.5) : -int64_t(-value + 0.5);
+        }
+
+    }; // namespace detail
+
+
+    /**
+     * A function tabulated at compile time, and evaluated with integer arithmetic only: one lookup and one lerp.
+     *
+     * The input range of In is split into 2^bits segments, selected by the top bits of the raw input.
+     * `f` maps the double value of an input to the double value of the output, and should be constexpr.
+     * Outputs outside the range of Out saturate; segments that leave it far behind are clamped first. `max_error()` reports the worst error, to tune `bits` against.
+     *
+     *     static constexpr auto gamma = make_lut<u_unit16, u_unit16, 8>([](double x) { return x * x * (3 - 2 * x); });
+     *     u_unit16 y = gamma(x);
+     *     gamma(xs, ys);
+     */
+    template <PrecType In, PrecType Out, std::size_t bits, Interpolation interpolation, typename F>
+    class LUT {
+        using I = typename In::value_type;
+        using O = typename Out::value_type;
+        static_assert(sizeof(I) <= 4 && sizeof(O) <= 4, "LUT should map types of up to 32 bits");
+        static_assert(bits >= 1 && bits <= 8 * sizeof(I) && bits <= 16, "LUT should have 2^1 to 2^16 segments, at most one per input");
+
+        static constexpr int input_bits = 8 * sizeof(I);
+        static constexpr int shift = input_bits - int(bits);        // Raw input bits within a segment
+        static constexpr int guard = detail::lut_guard_bits;
+        static constexpr int weight = detail::lut_weight_bits;
+        // Entries in units of 2^-guard output steps; quadratic coefficients reach four times the output range
+        using E = std::conditional_t<(sizeof(O) <= 2), int32_t, int64_t>;
+
+    public:
+        static constexpr std::size_t size = std::size_t(1) << bits;
+
+        constexpr explicit LUT(const F f) : _f(f) {
+            const double step = detail::exp2i(shift);
+            const double scale = detail::exp2i(-Out::_n + guard);   // Output value to entry units
+            const double bound = detail::exp2i(8 * int(sizeof(O)) + guard);  // Past either end of Out, where it saturates
+            auto sample = [&](const double position) {              // f at `position` segments into the input range
+                const double y = _f((double(std::numeric_limits<I>::min()) + position * step) * detail::exp2i(In::_n)) * scale;
+                return std::clamp(y, -bound, bound);
+            };
+            for (std::size_t i = 0; i < size; ++i) {
+                const double p0 = sample(double(i)), p1 = sample(double(i) + 1);
+                _c0[i] = E(detail::round_to_int(p0));
+                if constexpr (interpolation == Interpolation::linear)
+                    _c1[i] = E(detail::round_to_int(p1) - _c0[i]);
+                else {
+                    const double pm = sample(double(i) + 0.5);
+                    _c1[i] = E(detail::round_to_int(-3 * p0 + 4 * pm - p1));
+                    _c2[i] = E(detail::round_to_int(2 * p0 - 4 * pm + 2 * p1));
+                }
+            }
+        }
+
+        constexpr Out operator()(const In x) const {
+            Out result;
+            result._data = evaluate(x._data);
+            return result;
+        }
+
+        /**
+         * Element-wise out = (*this)(values)
+         * A branch-free loop, which compilers may vectorize with gathers; the vector extensions have none to write it with,
+         * and loading the entries lane by lane measured slower than this loop.
+         */
+        void operator()(std::span<const std::type_identity_t<In>> values, std::span<Out> out) const {
+            detail::check_sizes(out.size(), values.size());
+            const I* pv = detail::raw(values);
+            O* po = detail::raw(out);
+            for (std::size_t i = 0; i < out.size(); ++i) po[i] = evaluate(pv[i]);
+        }
+
+        // The exact f at x, in the units of Out's resolution
+        constexpr double exact(const In x) const { return _f(double(x._data) * detail::exp2i(In::_n)) * detail::exp2i(-Out::_n); }
+
+        /**
+         * The largest |LUT(x) - f(x)| over the inputs, in units of Out's resolution, including the final rounding (0.5).
+         * Every input for types of up to 16 bits, 2^20 evenly spread inputs otherwise.
+         * Can run at compile time, e.g. in a static_assert, though large sweeps may hit the compiler's constexpr limits.
+         */
+        constexpr double max_error() const {
+            constexpr uint64_t count = uint64_t(1) << std::min(input_bits, 20);
+            constexpr uint64_t stride = (uint64_t(1) << input_bits) / count;
+            double worst = 0;
+            for (uint64_t k = 0; k < count; ++k) {
+                In x;
+                x._data = I(uint64_t(std::numeric_limits<I>::min()) + k * stride);
+                const double target = std::clamp(exact(x), double(std::numeric_limits<O>::min()), double(std::numeric_limits<O>::max()));
+                const double error = double((*this)(x)._data) - target;
+                worst = std::max(worst, (error < 0) ? -error : error);
+            }
+            return worst;
+        }
+
+    private:
+        F _f;
+        std::array<E, size> _c0{}, _c1{};
+        std::array<E, (interpolation == Interpolation::quadratic) ? size : 0> _c2{};
+
+        constexpr O evaluate(const I raw) const {
+            using U = std::make_unsigned_t<I>;
+            const uint32_t offset = uint32_t(U(U(raw) ^ U(std::is_signed_v<I> ? std::numeric_limits<I>::min() : 0))); // raw - min
+            const std::size_t index = std::size_t(offset >> shift);
+            const uint32_t within = uint32_t(uint64_t(offset) & ((uint64_t(1) << shift) - 1));
+            int64_t t;
+            if constexpr (shift >= weight) t = int64_t(within >> (shift - weight));
+            else t = int64_t(within) << (weight - shift);
+
+            int64_t y;
+            if constexpr (interpolation == Interpolation::linear)
+                y = int64_t(_c0[index]) + ((int64_t(_c1[index]) * t) >> weight);
+            else
+                y = int64_t(_c0[index]) + (((int64_t(_c1[index]) + ((int64_t(_c2[index]) * t) >> weight)) * t) >> weight);
+            y = (y + (int64_t(1) << (guard - 1))) >> guard;
+            return O(std::clamp<int64_t>(y, std::numeric_limits<O>::min(), std::numeric_limits<O>::max()));
+        }
+    };
+
+
+    // A LUT of 2^bits segments for f over the inputs In, e.g. `make_lut<u_unit16, u_unit16, 8>(f)`
+    template <PrecType In, PrecType Out, std::size_t bits, Interpolation interpolation = Interpolation::linear, typename F>
+    constexpr LUT<In, Out, bits, interpolation, F> make_lut(const F f) { return LUT<In, Out, bits, interpolation, F>(f); }
+
+}; // namespace dattatypes
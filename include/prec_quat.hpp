@@ -0,0 +1,184 @@
+#pragma once
+// === HEADER ONLY ===
+
+#include <array>
+#include <span>
+#include <cstddef>
+#include <type_traits>
+
+#include "prec_utils.hpp"
+#include "prec_batch.hpp"
+#include "prec_linalg.hpp"
+
+namespace dattatypes {
+
+    /**
+     * Fixed-point quaternion w + xi + yj + zk, e.g. `quat<unit32>` or `quat<prec32>`.
+     * Stored as four contiguous Prec values, in the order w, x, y, z.
+     *
+     * Products are fused like the rest of prec_linalg.hpp: each component sums the exact raw products
+     * in a wide integer and rounds once with the rounding and overflow policy of P.
+     * Rotations expand the quaternion once into a rotation matrix in Q30, and apply it to the points
+     * with the affine kernels of SoAVec3, so single and batch rotations are bit-identical.
+     */
+    template <PrecType P>
+    struct quat {
+        std::array<P, 4> _data{};
+
+        constexpr quat() = default;
+        constexpr quat(const P w, const P x, const P y, const P z) : _data{w, x, y, z} {}
+
+        // The identity rotation. For unit types, where 1.0 does not fit, w saturates to the largest value below it.
+        static constexpr quat identity() { return quat(detail::from_fixed<P>(1, 0), P(), P(), P()); }
+
+        constexpr P w() const { return _data[0]; }
+        constexpr P x() const { return _data[1]; }
+        constexpr P y() const { return _data[2]; }
+        constexpr P z() const { return _data[3]; }
+        constexpr Vec3<P> vec() const { return Vec3<P>(_data[1], _data[2], _data[3]); }
+
+        constexpr bool operator==(const quat& other) const { return _data == other._data; }
+        constexpr bool operator!=(const quat& other) const { return !(*this == other); }
+
+        constexpr quat operator+(const quat& other) const { quat r; for (std::size_t i = 0; i < 4; ++i) r._data[i] = _data[i] + other._data[i]; return r; }
+        constexpr quat operator-(const quat& other) const { quat r; for (std::size_t i = 0; i < 4; ++i) r._data[i] = _data[i] - other._data[i]; return r; }
+        constexpr quat operator-() const { quat r; for (std::size_t i = 0; i < 4; ++i) r._data[i] = -_data[i]; return r; }
+        constexpr quat operator*(const P factor) const { quat r; for (std::size_t i = 0; i < 4; ++i) r._data[i] = _data[i] * factor; return r; }
+
+        // Hamilton product, each component rounded once
+        constexpr quat operator*(const quat& other) const {
+            using detail::accum_product, detail::from_accum;
+            const auto& [aw, ax, ay, az] = _data;
+            const auto& [bw, bx, by, bz] = other._data;
+            return quat(from_accum<P>(accum_product(aw, bw) - accum_product(ax, bx) - accum_product(ay, by) - accum_product(az, bz)),
+                        from_accum<P>(accum_product(aw, bx) + accum_product(ax, bw) + accum_product(ay, bz) - accum_product(az, by)),
+                        from_accum<P>(accum_product(aw, by) - accum_product(ax, bz) + accum_product(ay, bw) + accum_product(az, bx)),
+                        from_accum<P>(accum_product(aw, bz) + accum_product(ax, by) - accum_product(ay, bx) + accum_product(az, bw)));
+        }
+        constexpr quat& operator*=(const quat& other) { return *this = *this * other; }
+
+        // (De)Serialization
+        template <class Archive>
+        void serialize(Archive &ar) { ar(_data); }
+    };
+
+    template <PrecType P>
+    constexpr quat<P> conj(const quat<P>& q) { return quat<P>(q._data[0], -q._data[1], -q._data[2], -q._data[3]); }
+
+    // Dot product of the four components, rounded once
+    template <PrecType P>
+    constexpr P dot(const quat<P>& a, const quat<P>& b) {
+        detail::accum_t<P> sum = 0;
+        for (std::size_t i = 0; i < 4; ++i) sum += detail::accum_product(a._data[i], b._data[i]);
+        return detail::from_accum<P>(sum);
+    }
+
+    // Unit quaternion, through the division-free `normalize` of Vec4. The result type may be given first.
+    template <typename Result = void, PrecType P>
+    constexpr auto normalize(const quat<P>& q) {
+        using R = std::conditional_t<std::is_void_v<Result>, P, Result>;
+        Vec4<P> v;
+        v._data = q._data;
+        quat<R> result;
+        result._data = normalize<R>(v)._data;
+        return result;
+    }
+
+    /**
+     * Rotation by `angle` about the unit vector `axis`, where the angle counts half turns (see `sincos`).
+     * The result type defaults to the axis type, or may be given first, e.g. `from_axis_angle<unit32>(axis, angle)`.
+     */
+    template <typename Result = void, PrecType P, PrecType Angle>
+    constexpr auto from_axis_angle(const Vec3<P>& axis, const Angle& angle) {
+        using R = std::conditional_t<std::is_void_v<Result>, P, Result>;
+        Angle half;
+        half._data = angle._data >> 1;
+        const auto [s, c] = sincos<R>(half);
+        quat<R> q;
+        q._data[0] = c;
+        for (std::size_t i = 0; i < 3; ++i)
+            q._data[i + 1] = detail::from_fixed<R>(detail::int128_t(s._data) * axis[i]._data, -R::_n - P::_n);
+        return q;
+    }
+
+
+    namespace detail {
+
+        // Rotation matrix of the unit quaternion q as `affine_rows` in Q30, for points of type P
+        template <PrecType P, PrecType Q>
+        constexpr affine_rows<P> rotation_rows(const quat<Q>& q) {
+            static_assert(sizeof(typename Q::value_type) <= 4, "Rotations take quaternions of at most 32 bits.");
+            const int128_t w = q._data[0]._data, x = q._data[1]._data, y = q._data[2]._data, z = q._data[3]._data;
+            // Products carry 2 f fractional bits, f those of Q
+            constexpr int frac = -2 * Q::_n;
+            const int128_t one = int128_t(1) << frac;
+            const int128_t entries[9] = {
+                one - 2*(y*y + z*z), 2*(x*y - w*z),       2*(x*z + w*y),
+                2*(x*y + w*z),       one - 2*(x*x + z*z), 2*(y*z - w*x),
+                2*(x*z - w*y),       2*(y*z + w*x),       one - 2*(x*x + y*y),
+            };
+            affine_rows<P> rows{};
+            for (std::size_t r = 0; r < 3; ++r)
+                for (std::size_t k = 0; k < 3; ++k) {
+                    const int128_t entry = entries[3*r + k];
+                    rows[4*r + k] = accum_t<P>((frac > 30) ? round_shift(entry, frac - 30) : entry << (30 - frac));
+                }
+            return rows;
+        }
+
+    }; // namespace detail
+
+    // Rotates v by the unit quaternion q: q v q*
+    template <PrecType P, PrecType Q>
+    constexpr Vec3<P> rotate(const quat<Q>& q, const Vec3<P>& v) {
+        return detail::affine_point<P, 30>(detail::rotation_rows<P>(q), v);
+    }
+
+    // Rotates every point of `in` by the unit quaternion q into `out`, which may be `in` itself
+    template <PrecType P, PrecType Q>
+    void rotate(const quat<Q>& q, std::span<const std::type_identity_t<Vec3<P>>> in, std::span<Vec3<P>> out) {
+        detail::check_sizes(out.size(), in.size());
+        const auto rows = detail::rotation_rows<P>(q);
+        for (std::size_t i = 0; i < out.size(); ++i) out[i] = detail::affine_point<P, 30>(rows, in[i]);
+    }
+
+    // Rotates every point of `points` by the unit quaternion q, in place, with the SIMD kernels where P has them
+    template <PrecType P, PrecType Q>
+    void rotate(const quat<Q>& q, SoAVec3<P>& points) {
+        points.template apply<30>(detail::rotation_rows<P>(q));
+    }
+
+    // Normalised linear interpolation along the shorter arc, for t in [0.0, 1.0]
+    template <PrecType P, PrecType U>
+    constexpr quat<P> nlerp(const quat<P>& a, quat<P> b, const U& t) {
+        if (dot(a, b) < P()) b = -b;
+        quat<P> q;
+        for (std::size_t i = 0; i < 4; ++i) q._data[i] = lerp(a._data[i], b._data[i], t);
+        return normalize(q);
+    }
+
+    /**
+     * Spherical linear interpolation along the shorter arc, for t in [0.0, 1.0].
+     * Division-free: rotates a towards the unit quaternion orthogonal to it in the plane of a and b,
+     *   slerp = a cos(t theta) + v sin(t theta),   v = normalize(b - a dot(a, b)),   theta = acos(dot(a, b)),
+     * with the integer `acos` and `sincos`. Falls back to `nlerp` where a and b are too close to tell apart.
+     */
+    template <PrecType P, PrecType U>
+    constexpr quat<P> slerp(const quat<P>& a, quat<P> b, const U& t) {
+        using Angle = angle_of<P>;
+        P d = dot(a, b);
+        if (d < P()) { b = -b; d = -d; }
+        const quat<P> orthogonal = b - a * d;
+        const Angle theta = acos(std::min(d, detail::from_fixed<P>(1, 0)));
+        if (theta._data == 0 || orthogonal == quat<P>()) return nlerp(a, b, t);
+
+        const quat<P> v = normalize(orthogonal);
+        const auto [s, c] = sincos<P>(detail::from_fixed<Angle>(detail::int128_t(theta._data) * t._data, -Angle::_n - U::_n));
+        quat<P> q;
+        for (std::size_t i = 0; i < 4; ++i)
+            q._data[i] = detail::from_accum<P>(detail::accum_product(a._data[i], c) + detail::accum_product(v._data[i], s));
+        return q;
+    }
+
+
+}; // namespace dattatypes
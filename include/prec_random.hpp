@@ -0,0 +1,230 @@
+#pragma once
+// === HEADER ONLY ===
+
+#include <array>
+#include <span>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <type_traits>
+#include <algorithm>
+
+#include "simd.hpp"
+#include "prec_utils.hpp"
+
+namespace dattatypes {
+
+    /**
+     * Counter-based random number generator: Philox4x32-10 (Salmon et al., "Parallel Random Numbers: As Easy as 1, 2, 3").
+     *
+     * Each block of four 32-bit words is a pure function of (seed, stream, block index), so any position
+     * of any stream can be computed directly, in any order and on any thread, with bit-exact results.
+     * Streams are independent sequences of 2^66 words: give every thread or task its own stream number.
+     *
+     * The words are consumed in order, and `fill` produces them a SIMD register of blocks at a time,
+     * identical to the scalar sequence. Also a UniformRandomBitGenerator, for the std distributions.
+     */
+    class Philox {
+    public:
+        using result_type = uint32_t;
+        using block_type = std::array<uint32_t, 4>;
+
+        explicit constexpr Philox(const uint64_t seed = 0, const uint64_t stream = 0)
+            : _key{uint32_t(seed), uint32_t(seed >> 32)}, _stream{uint32_t(stream), uint32_t(stream >> 32)} {}
+
+        static constexpr result_type min() { return 0; }
+        static constexpr result_type max() { return std::numeric_limits<result_type>::max(); }
+
+        // The generator of another stream with the same seed, at its start
+        constexpr Philox stream(const uint64_t stream) const {
+            return Philox(uint64_t(_key[0]) | (uint64_t(_key[1]) << 32), stream);
+        }
+
+        // Position in words from the start of the stream
+        constexpr uint64_t position() const { return _position; }
+        constexpr void seek(const uint64_t position) { _position = position; }
+        constexpr void discard(const uint64_t words) { _position += words; }
+
+        // Block `index` of the stream
+        constexpr block_type block(const uint64_t index) const {
+            block_type c = {uint32_t(index), uint32_t(index >> 32), _stream[0], _stream[1]};
+            uint32_t k0 = _key[0], k1 = _key[1];
+            for (int round = 0; round < rounds; ++round) {
+                const uint64_t p0 = uint64_t(M0) * c[0], p1 = uint64_t(M1) * c[2];
+                c = {uint32_t(p1 >> 32) ^ c[1] ^ k0, uint32_t(p1), uint32_t(p0 >> 32) ^ c[3] ^ k1, uint32_t(p0)};
+                k0 += W0; k1 += W1;
+            }
+            return c;
+        }
+
+        // Next word
+        constexpr result_type operator()() {
+            const uint64_t index = _position / 4;
+            if (!_cached || _cached_index != index) {
+                _cache = block(index);
+                _cached_index = index;
+                _cached = true;
+            }
+            return _cache[_position++ % 4];
+        }
+
+        // Next words.size() words
+        void fill(std::span<uint32_t> words) {
+            std::size_t i = 0;
+            while (i < words.size() && _position % 4 != 0) words[i++] = (*this)();
+            constexpr std::size_t L = simd::lanes<uint32_t>;
+            if constexpr (L > 1)
+                for (; i + 4 * L <= words.size(); i += 4 * L, _position += 4 * L)
+                    block_lanes<L>(_position / 4, words.data() + i);
+            while (i < words.size()) words[i++] = (*this)();
+        }
+
+    private:
+        static constexpr int rounds = 10;
+        static constexpr uint32_t M0 = 0xD2511F53, M1 = 0xCD9E8D57; // Multipliers
+        static constexpr uint32_t W0 = 0x9E3779B9, W1 = 0xBB67AE85; // Weyl sequence of the key
+
+        std::array<uint32_t, 2> _key, _stream;
+        uint64_t _position = 0;
+        block_type _cache{};
+        uint64_t _cached_index = 0;
+        bool _cached = false;
+
+        // L consecutive blocks from `index` in the lanes of a register, written out in stream order
+        template <std::size_t L>
+        void block_lanes(const uint64_t index, uint32_t* out) const {
+            using V = simd::vec<uint32_t, L>;
+            using W = simd::vec<uint64_t, L>;
+            V iota;
+            for (std::size_t j = 0; j < L; ++j) iota[j] = uint32_t(j);
+            V c0 = uint32_t(index) + iota;
+            V c1 = V{} + uint32_t(index >> 32) - V(c0 < uint32_t(index)); // Carry, as the comparison gives -1
+            V c2 = V{} + _stream[0], c3 = V{} + _stream[1];
+            uint32_t k0 = _key[0], k1 = _key[1];
+            for (int round = 0; round < rounds; ++round) {
+                const W p0 = __builtin_convertvector(c0, W) * M0, p1 = __builtin_convertvector(c2, W) * M1;
+                const V hi0 = __builtin_convertvector(p0 >> 32, V), hi1 = __builtin_convertvector(p1 >> 32, V);
+                c0 = hi1 ^ c1 ^ k0;
+                c1 = __builtin_convertvector(p1, V);
+                c2 = hi0 ^ c3 ^ k1;
+                c3 = __builtin_convertvector(p0, V);
+                k0 += W0; k1 += W1;
+            }
+            for (std::size_t j = 0; j < L; ++j) {
+                out[4*j] = c0[j]; out[4*j + 1] = c1[j]; out[4*j + 2] = c2[j]; out[4*j + 3] = c3[j];
+            }
+        }
+    };
+
+
+    /**
+     * Distributions for Prec types, generated directly in the fixed-point domain: no floating point, so
+     * every platform and compiler produces the same values. A sample of up to 32 bits takes one word
+     * of the generator (its top bits), a 64-bit sample takes two.
+     */
+    namespace detail {
+
+        // Words per sample of T
+        template <typename T>
+        inline constexpr std::size_t words_per = (sizeof(T) == 8) ? 2 : 1;
+
+        // Runs `body(words, i)` over the samples of `n`, with the words of each sample, in chunks on the stack
+        template <typename Body>
+        void for_samples(Philox& gen, const std::size_t n, const std::size_t words_per_sample, Body&& body) {
+            constexpr std::size_t chunk = 256;
+            std::array<uint32_t, chunk> words;
+            const std::size_t per_chunk = chunk / words_per_sample;
+            for (std::size_t first = 0; first < n; first += per_chunk) {
+                const std::size_t count = std::min(per_chunk, n - first);
+                gen.fill(std::span<uint32_t>(words.data(), count * words_per_sample));
+                for (std::size_t i = 0; i < count; ++i) body(words.data() + i * words_per_sample, first + i);
+            }
+        }
+
+        // Uniform raw bits of T from its words
+        template <typename T>
+        constexpr T random_bits(const uint32_t* words) {
+            using U = std::make_unsigned_t<T>;
+            if constexpr (sizeof(T) == 8) return T((uint64_t(words[0]) << 32) | words[1]);
+            else return T(U(words[0] >> (32 - 8 * sizeof(T))));
+        }
+
+        // sqrt(3/2) in Q31: scales the Irwin-Hall sum of 8 uniforms to unit variance
+        inline constexpr uint64_t sqrt_three_halves_q31 = isqrt_bitwise(uint64_t(3) << 61);
+
+        // Standard normal sample in Q48 from four words, i.e. eight 16-bit uniforms
+        constexpr int64_t normal_q48(const uint32_t* words) {
+            int64_t sum = 0;
+            for (int i = 0; i < 4; ++i) sum += (words[i] >> 16) + (words[i] & 0xFFFF);
+            // (sum - mean) sqrt(12 / 8) / 2^16, with the mean 8 (2^16 - 1) / 2 doubled to stay an integer
+            return (2 * sum - 8 * 0xFFFF) * int64_t(sqrt_three_halves_q31);
+        }
+
+    }; // namespace detail
+
+
+    // Uniform over every value of P, e.g. [0.0, 1.0) for u_unit32 and [-1.0, 1.0) for unit32
+    template <PrecType P>
+    void uniform(Philox& gen, std::span<P> out) {
+        using T = typename P::value_type;
+        detail::for_samples(gen, out.size(), detail::words_per<T>,
+            [&](const uint32_t* words, std::size_t i) { out[i]._data = detail::random_bits<T>(words); });
+    }
+
+    /**
+     * Uniform over [lo, hi), by the multiply-shift reduction of the random bits into the range.
+     * No rejection, so the number of words drawn is fixed; the bias is below 2^-32 (2^-64 for 64-bit types),
+     * and there is none for power-of-two ranges, e.g. [0.0, 1.0) of prob32.
+     */
+    template <PrecType P>
+    void uniform(Philox& gen, std::span<P> out, const P lo, const P hi) {
+        using T = typename P::value_type;
+        using U = std::make_unsigned_t<T>;
+        const U range = U(U(hi._data) - U(lo._data));
+        detail::for_samples(gen, out.size(), detail::words_per<T>, [&](const uint32_t* words, std::size_t i) {
+            U offset;
+            if constexpr (sizeof(T) == 8) offset = U((detail::uint128_t(U(detail::random_bits<T>(words))) * range) >> 64);
+            else offset = U((uint64_t(words[0]) * range) >> 32);
+            out[i]._data = T(U(lo._data) + offset);
+        });
+    }
+
+    // Bernoulli trials: 1 with the given probability, e.g. a prob32, with P(1) exactly the probability from 0.0 to 1.0
+    template <PrecType P>
+    void bernoulli(Philox& gen, const P probability, std::span<uint8_t> out) {
+        ASSERT_PROBABILITY(P)
+        using T = typename P::value_type;
+        // Uniform in [0.0, 1.0) of P, against the threshold
+        detail::for_samples(gen, out.size(), detail::words_per<T>,
+            [&](const uint32_t* words, std::size_t i) { out[i] = uint8_t((detail::random_bits<T>(words) >> 1) < probability._data); });
+    }
+
+    /**
+     * Approximately normal samples: the Irwin-Hall sum of eight 16-bit uniforms, scaled to unit variance.
+     * Matches the normal distribution to about 1% in the density, with tails cut at +-4.9 standard deviations.
+     * Takes four words per sample, rounds to nearest and saturates.
+     */
+    template <PrecType P>
+    void normal(Philox& gen, std::span<P> out) {
+        detail::for_samples(gen, out.size(), 4,
+            [&](const uint32_t* words, std::size_t i) { out[i] = detail::from_fixed<P>(detail::normal_q48(words), 48); });
+    }
+
+    template <PrecType P>
+    void normal(Philox& gen, std::span<P> out, const P mean, const P stddev) {
+        constexpr int frac = -P::_n;
+        detail::for_samples(gen, out.size(), 4, [&](const uint32_t* words, std::size_t i) {
+            const detail::int128_t z = detail::int128_t(detail::normal_q48(words)) * stddev._data;
+            out[i] = detail::from_fixed<P>(z + (detail::int128_t(mean._data) << 48), 48 + frac);
+        });
+    }
+
+    // Single samples, drawing the same words as the span versions
+    template <PrecType P>
+    P uniform(Philox& gen) { P value; uniform<P>(gen, std::span<P>(&value, 1)); return value; }
+
+    template <PrecType P>
+    P normal(Philox& gen) { P value; normal<P>(gen, std::span<P>(&value, 1)); return value; }
+
+
+}; // namespace dattatypes
@@ -0,0 +1,266 @@
+#pragma once
+// === HEADER ONLY ===
+
+#include <span>
+#include <cstddef>
+#include <cstdint>
+#include <algorithm>
+#include <stdexcept>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "simd.hpp"
+#include "prec_utils.hpp"
+#include "prec_batch.hpp"
+
+namespace dattatypes {
+
+    /**
+     * Reductions over spans of Prec numbers: sum, dot, mean, min, max and histogram.
+     * The element type is given explicitly, and optionally a wider result type: `sum<prec32, prec64>(values)`.
+     *
+     * Sums accumulate exactly, in 128 bits, so they do not overflow where `operator+` would.
+     * The span is split into contiguous chunks, one per thread, and each chunk runs SIMD kernels.
+     * Integer addition is associative, so results are bit-identical for every thread count and
+     * instruction set: the chunking only changes the order of exact additions.
+     *
+     * `threads` is the most threads to use, 0 for one per hardware thread. Each thread takes at least
+     * `reduce_grain` values, so short spans stay on the calling thread.
+     */
+    inline constexpr std::size_t reduce_grain = std::size_t(1) << 16;
+
+    namespace detail {
+
+        // Exact sums of raw values and products, signed as P
+        template <PrecType P>
+        using reduce_t = std::conditional_t<std::is_signed_v<raw_t<P>>, int128_t, uint128_t>;
+
+        // Additions per lane before a 64-bit lane accumulator of 32-bit terms is flushed
+        inline constexpr std::size_t flush_every = std::size_t(1) << 30;
+
+        inline std::size_t thread_count(const std::size_t n, std::size_t threads) {
+            if (threads == 0) threads = std::max(1u, std::thread::hardware_concurrency());
+            return std::clamp<std::size_t>(n / reduce_grain, 1, threads);
+        }
+
+        // `chunk(first, last)` over contiguous chunks of [0, n), one per thread, the first on the calling thread
+        template <typename R, typename Chunk>
+        std::vector<R> parallel_chunks(const std::size_t n, const std::size_t threads, Chunk&& chunk) {
+            const std::size_t count = thread_count(n, threads);
+            std::vector<R> results(count);
+            {
+                std::vector<std::jthread> workers;
+                workers.reserve(count - 1);
+                for (std::size_t t = 1; t < count; ++t)
+                    workers.emplace_back([&, t] { results[t] = chunk(n * t / count, n * (t + 1) / count); });
+                results[0] = chunk(0, n / count);
+            }
+            return results;
+        }
+
+        /**
+         * Exact sum of 64-bit lanes. The low and the high 32 bits of each term add up separately,
+         * so the 64-bit lane accumulators cannot overflow for flush_every additions.
+         */
+        template <typename I, std::size_t L>
+        struct split_sum {
+            using W = simd::vec<I, L>;
+            using R = std::conditional_t<std::is_signed_v<I>, int128_t, uint128_t>;
+            W lo{}, hi{};
+
+            void add(const W& terms) { lo += terms & I(0xFFFFFFFF); hi += terms >> 32; }
+            R total() const {
+                R sum = 0;
+                for (std::size_t j = 0; j < L; ++j) sum += (R(hi[j]) << 32) + R(lo[j]);
+                return sum;
+            }
+        };
+
+        // Runs `body(first, last)` over [first, last) in blocks of at most flush_every registers of L
+        template <std::size_t L, typename Body>
+        void for_blocks(const std::size_t first, const std::size_t last, Body&& body) {
+            for (std::size_t i = first; i < last; i += std::min(last - i, flush_every * L))
+                body(i, i + std::min(last - i, flush_every * L));
+        }
+
+        // Exact sum of the raw values in [first, last)
+        template <PrecType P>
+        reduce_t<P> sum_chunk(const raw_t<P>* values, const std::size_t first, const std::size_t last) {
+            using T = raw_t<P>;
+            using I = std::conditional_t<std::is_signed_v<T>, int64_t, uint64_t>;
+            constexpr std::size_t L = simd::lanes<T>;
+            using V = simd::vec<T, L>;
+            reduce_t<P> total = 0;
+            for_blocks<L>(first, last, [&](const std::size_t begin, const std::size_t end) {
+                if constexpr (sizeof(T) == 8) {
+                    split_sum<I, L> acc;
+                    for_lanes<L>(end - begin,
+                        [&](std::size_t i) { if constexpr (L > 1) acc.add(simd::load<V>(values + begin + i)); },
+                        [&](std::size_t i) { total += values[begin + i]; });
+                    total += acc.total();
+                }
+                else {
+                    using W = simd::vec<I, L>;
+                    W acc{};
+                    for_lanes<L>(end - begin,
+                        [&](std::size_t i) { if constexpr (L > 1) acc += __builtin_convertvector(simd::load<V>(values + begin + i), W); },
+                        [&](std::size_t i) { total += values[begin + i]; });
+                    for (std::size_t j = 0; j < L; ++j) total += acc[j];
+                }
+            });
+            return total;
+        }
+
+        // Exact sum of the raw products in [first, last)
+        template <PrecType P>
+        reduce_t<P> dot_chunk(const raw_t<P>* a, const raw_t<P>* b, const std::size_t first, const std::size_t last) {
+            using T = raw_t<P>;
+            using I = std::conditional_t<std::is_signed_v<T>, int64_t, uint64_t>;
+            using R = reduce_t<P>;
+            constexpr std::size_t L = (sizeof(T) < 8) ? simd::lanes<T> : 1; // 64-bit products need 128 bits
+            using V = simd::vec<T, L>;
+            using W = simd::vec<I, L>;
+            R total = 0;
+            for_blocks<L>(first, last, [&](const std::size_t begin, const std::size_t end) {
+                split_sum<I, L> acc;
+                for_lanes<L>(end - begin,
+                    [&](std::size_t i) {
+                        if constexpr (L > 1) {
+                            const V va = simd::load<V>(a + begin + i), vb = simd::load<V>(b + begin + i);
+                            if constexpr (sizeof(T) <= 2) {
+                                // Products of 16 bits fit 32-bit lanes, and 64-bit lanes hold their sums
+                                using H = std::conditional_t<std::is_signed_v<T>, int32_t, uint32_t>;
+                                using VH = simd::vec<H, L>;
+                                acc.lo += __builtin_convertvector(__builtin_convertvector(va, VH) * __builtin_convertvector(vb, VH), W);
+                            }
+                            else acc.add(__builtin_convertvector(va, W) * __builtin_convertvector(vb, W));
+                        }
+                    },
+                    [&](std::size_t i) { total += R(a[begin + i]) * R(b[begin + i]); });
+                total += acc.total();
+            });
+            return total;
+        }
+
+        template <PrecType P>
+        reduce_t<P> sum_raw(std::span<const std::type_identity_t<P>> values, const std::size_t threads) {
+            const raw_t<P>* pv = raw(values);
+            reduce_t<P> total = 0;
+            for (const auto part : parallel_chunks<reduce_t<P>>(values.size(), threads,
+                    [&](std::size_t first, std::size_t last) { return sum_chunk<P>(pv, first, last); }))
+                total += part;
+            return total;
+        }
+
+        // num / den, rounded to nearest with ties toward positive infinity, for den > 0
+        constexpr int128_t round_div(const int128_t num, const int128_t den) {
+            const int128_t twice = 2 * num + den, q = twice / (2 * den);
+            return (twice % (2 * den) != 0 && twice < 0) ? q - 1 : q;
+        }
+
+    }; // namespace detail
+
+
+    // Sum of the values, exact until rounded to nearest into the result type, e.g. `sum<prec32, prec64>(values)`, and saturated
+    template <PrecType P, PrecType R = P>
+    R sum(std::span<const std::type_identity_t<P>> values, const std::size_t threads = 0) {
+        return detail::from_fixed<R>(detail::int128_t(detail::sum_raw<P>(values, threads)), -P::_n);
+    }
+
+    /**
+     * Sum of the products a[i] b[i], exact until rounded to nearest into the result type, and saturated.
+     * Products of 64-bit types accumulate in 128 bits, so their sum should stay below 2^127.
+     */
+    template <PrecType P, PrecType R = P>
+    R dot(std::span<const std::type_identity_t<P>> a, std::span<const std::type_identity_t<P>> b, const std::size_t threads = 0) {
+        detail::check_sizes(a.size(), b.size());
+        const detail::raw_t<P> *pa = detail::raw(a), *pb = detail::raw(b);
+        detail::reduce_t<P> total = 0;
+        for (const auto part : detail::parallel_chunks<detail::reduce_t<P>>(a.size(), threads,
+                [&](std::size_t first, std::size_t last) { return detail::dot_chunk<P>(pa, pb, first, last); }))
+            total += part;
+        return detail::from_fixed<R>(detail::int128_t(total), -2 * P::_n);
+    }
+
+    // Mean of the values, from the exact sum, rounded to nearest into the result type
+    template <PrecType P, PrecType R = P>
+    R mean(std::span<const std::type_identity_t<P>> values, const std::size_t threads = 0) {
+        if (values.empty()) throw std::runtime_error("mean input should not be empty");
+        const detail::int128_t total = detail::int128_t(detail::sum_raw<P>(values, threads));
+        const detail::int128_t count = detail::int128_t(values.size());
+        // The sum has the fractional bits of P, the mean those of R
+        constexpr int shift = P::_n - R::_n;
+        if constexpr (shift >= 0) return detail::from_fixed<R>(detail::round_div(total << shift, count), -R::_n);
+        else return detail::from_fixed<R>(detail::round_div(total, count << -shift), -R::_n);
+    }
+
+    // Smallest and largest value
+    template <PrecType P>
+    std::pair<P, P> minmax(std::span<const std::type_identity_t<P>> values, const std::size_t threads = 0) {
+        using T = detail::raw_t<P>;
+        if (values.empty()) throw std::runtime_error("minmax input should not be empty");
+        const T* pv = detail::raw(values);
+        const auto parts = detail::parallel_chunks<std::pair<T, T>>(values.size(), threads, [&](std::size_t first, std::size_t last) {
+            constexpr std::size_t L = simd::lanes<T>;
+            using V = simd::vec<T, L>;
+            V lo = V{} + pv[first], hi = lo;
+            T slo = pv[first], shi = pv[first];
+            detail::for_lanes<L>(last - first,
+                [&](std::size_t i) {
+                    if constexpr (L > 1) {
+                        const V v = simd::load<V>(pv + first + i);
+                        lo = (v < lo) ? v : lo;
+                        hi = (v > hi) ? v : hi;
+                    }
+                },
+                [&](std::size_t i) { slo = std::min(slo, pv[first + i]); shi = std::max(shi, pv[first + i]); });
+            for (std::size_t j = 0; j < L; ++j) { slo = std::min(slo, T(lo[j])); shi = std::max(shi, T(hi[j])); }
+            return std::pair<T, T>(slo, shi);
+        });
+        std::pair<P, P> result;
+        result.first._data = parts[0].first;
+        result.second._data = parts[0].second;
+        for (const auto& [lo, hi] : parts) {
+            result.first._data = std::min(result.first._data, lo);
+            result.second._data = std::max(result.second._data, hi);
+        }
+        return result;
+    }
+
+    template <PrecType P>
+    P min(std::span<const std::type_identity_t<P>> values, const std::size_t threads = 0) { return minmax<P>(values, threads).first; }
+
+    template <PrecType P>
+    P max(std::span<const std::type_identity_t<P>> values, const std::size_t threads = 0) { return minmax<P>(values, threads).second; }
+
+    /**
+     * Counts of the values in [lo, hi), in counts.size() bins of equal width; values outside are not counted.
+     * Value v goes to bin floor((v - lo) bins / (hi - lo)), computed exactly. Every thread counts into
+     * its own bins, which are added at the end.
+     */
+    template <PrecType P>
+    void histogram(std::span<const std::type_identity_t<P>> values, const P lo, const P hi, std::span<uint64_t> counts,
+                   const std::size_t threads = 0) {
+        using T = detail::raw_t<P>;
+        using U = std::make_unsigned_t<T>;
+        using W = std::conditional_t<(sizeof(T) < 8), uint64_t, detail::uint128_t>;
+        if (!(lo < hi) || counts.empty()) throw std::runtime_error("histogram range and bins should not be empty");
+        const T* pv = detail::raw(values);
+        const W range = W(U(U(hi._data) - U(lo._data))), bins = W(counts.size());
+        const auto parts = detail::parallel_chunks<std::vector<uint64_t>>(values.size(), threads, [&](std::size_t first, std::size_t last) {
+            std::vector<uint64_t> local(counts.size());
+            for (std::size_t i = first; i < last; ++i) {
+                const W offset = W(U(U(pv[i]) - U(lo._data)));
+                if (pv[i] >= lo._data && offset < range) ++local[std::size_t(offset * bins / range)];
+            }
+            return local;
+        });
+        std::fill(counts.begin(), counts.end(), 0);
+        for (const auto& local : parts)
+            for (std::size_t b = 0; b < counts.size(); ++b) counts[b] += local[b];
+    }
+
+
+}; // namespace dattatypes
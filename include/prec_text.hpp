@@ -0,0 +1,381 @@
+#pragma once
+// === HEADER ONLY ===
+
+#include <algorithm>
+#include <array>
+#include <charconv>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <ostream>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <system_error>
+#include <type_traits>
+#include <utility>
+#include <vector>
+#include <version>
+#ifdef __cpp_lib_format
+#include <format>
+#endif
+
+#include "prec_utils.hpp"
+
+namespace dattatypes {
+
+    /**
+     * Exact text conversion of Prec, in integer arithmetic only: never through float or double,
+     * so the 64-bit types keep every bit, and every platform reads and writes the same digits.
+     *
+     * Text is in fixed notation, e.g. "-12.375": an optional '-' (signed types only), digits, and an optional
+     * fraction. Like std::to_chars and std::from_chars, nothing is allocated and no locale is consulted.
+     * Types of up to 64 fractional bits are supported, which covers every alias.
+     */
+    namespace detail {
+
+        // Fraction arithmetic must hold 10 * 2^(frac + 1)
+        template <int frac>
+        using text_word = std::conditional_t<(frac <= 59), uint64_t, uint128_t>;
+
+        // Absolute raw value, e.g. 128 for -128 of int8_t
+        template <PrecType P>
+        constexpr auto magnitude(const typename P::value_type data) {
+            using U = std::make_unsigned_t<typename P::value_type>;
+            return (data < 0) ? U(U(0) - U(data)) : U(data);
+        }
+
+        // Decimal digits of `value`, or nullptr if they do not fit [first, last)
+        constexpr char* write_uint(char* first, char* last, uint128_t value) {
+            char digits[40];
+            int count = 0;
+            do { digits[count++] = char('0' + int(value % 10)); value /= 10; } while (value != 0);
+            if (last - first < count) return nullptr;
+            while (count > 0) *first++ = digits[--count];
+            return first;
+        }
+
+        // Writes [integer].[digits], or nullptr if it does not fit [first, last)
+        constexpr char* write_fixed(char* first, char* last, const uint128_t integer, const char* digits, const int count) {
+            first = write_uint(first, last, integer);
+            if (first == nullptr) return nullptr;
+            if (count == 0) return first;
+            if (last - first < count + 1) return nullptr;
+            *first++ = '.';
+            for (int i = 0; i < count; ++i) *first++ = digits[i];
+            return first;
+        }
+
+        // Adds one to the last of `count` digits, carrying into the integer part
+        constexpr void carry_up(uint128_t& integer, char* digits, int count) {
+            while (count > 0 && digits[count - 1] == '9') digits[--count] = '0';
+            if (count > 0) ++digits[count - 1];
+            else ++integer;
+        }
+
+        // The parts of a parsed number, before scaling into a raw value
+        struct decimal {
+            bool negative = false;
+            bool overflow = false;              // Integer part beyond 128 bits
+            uint128_t integer = 0;
+            const char* fraction = nullptr;     // Fraction digits, without trailing zeros
+            int fraction_digits = 0;
+        };
+
+        // Parses [-]digits[.digits] from `first`; `end` is left at `first` if no number is there
+        constexpr decimal parse_decimal(const char* first, const char* last, const bool allow_sign, const char*& end) {
+            decimal d;
+            const char* p = first;
+            end = first;
+            if (allow_sign && p != last && *p == '-') { d.negative = true; ++p; }
+            const char* digits = p;
+            uint64_t low = 0; // First 19 digits, in a 64-bit register
+            int low_digits = 0;
+            for (; p != last && *p >= '0' && *p <= '9'; ++p) {
+                if (low_digits < 19) { low = low * 10 + uint64_t(*p - '0'); if (low != 0) ++low_digits; continue; }
+                if (low_digits == 19) { d.integer = low; ++low_digits; }
+                if (d.integer > (~uint128_t(0) - 9) / 10) d.overflow = true;
+                else d.integer = d.integer * 10 + uint128_t(*p - '0');
+            }
+            if (low_digits <= 19) d.integer = low;
+            bool any = (p != digits);
+            if (p != last && *p == '.') {
+                const char* fraction = ++p;
+                while (p != last && *p >= '0' && *p <= '9') ++p;
+                any |= (p != fraction);
+                int count = int(p - fraction);
+                while (count > 0 && fraction[count - 1] == '0') --count;
+                d.fraction = fraction;
+                d.fraction_digits = count;
+                if (!any) p = fraction - 1; // A lone '.' is not part of the number
+            }
+            if (any) end = p;
+            return d;
+        }
+
+        // floor(fraction * 2^frac), and how the remainder compares to one half: -1, 0 or 1
+        template <int frac>
+        constexpr std::pair<uint128_t, int> fraction_bits(const char* digits, const int count) {
+            if (count == 0) return {0, -1};
+            if (count <= 19) {
+                // fraction = N / 10^count exactly
+                uint64_t n = 0, power = 1;
+                for (int i = 0; i < count; ++i) { n = n * 10 + uint64_t(digits[i] - '0'); power *= 10; }
+                const uint128_t scaled = uint128_t(n) << frac;
+                uint128_t q, rem;
+                if (scaled >> 63 == 0) { q = uint64_t(scaled) / power; rem = uint64_t(scaled) % power; } // Skips the 128-bit division
+                else { q = scaled / power; rem = scaled % power; }
+                return {q, (2 * rem < power) ? -1 : (2 * rem > power) ? 1 : 0};
+            }
+            // Long fractions: multiples of 2^-(frac + 1) have at most frac + 1 decimals, so the digits past
+            // those only decide whether the remainder is zero. Doubling the decimal digits yields the bits.
+            constexpr int kept_max = frac + 1;
+            char kept[kept_max];
+            const int kept_count = (count < kept_max) ? count : kept_max;
+            bool sticky = false;
+            for (int i = 0; i < count; ++i) {
+                if (i < kept_count) kept[i] = char(digits[i] - '0');
+                else sticky |= (digits[i] != '0');
+            }
+            uint128_t bits = 0;
+            for (int bit = 0; bit <= frac; ++bit) {
+                int carry = 0;
+                for (int i = kept_count - 1; i >= 0; --i) {
+                    const int doubled = 2 * kept[i] + carry;
+                    kept[i] = char(doubled % 10);
+                    carry = doubled / 10;
+                }
+                bits = (bits << 1) | uint128_t(carry);
+            }
+            for (int i = 0; i < kept_count; ++i) sticky |= (kept[i] != 0);
+            return {bits >> 1, !(bits & 1) ? -1 : sticky ? 1 : 0};
+        }
+
+    }; // namespace detail
+
+
+    /**
+     * Characters of the longest text of P, from either to_chars with at most one decimal per fractional bit:
+     * a sign, the digits of the integer bits (a carry never adds one, as no power of two is a power of ten),
+     * a '.' and the fraction.
+     */
+    template <PrecType P>
+    inline constexpr std::size_t max_chars = [] {
+        constexpr int frac = (P::_n < 0) ? -P::_n : 0, bits = int(8 * sizeof(typename P::value_type)) + P::_n;
+        return std::size_t(1 + ((bits > 0) ? bits : 1) * 30103 / 100000 + 1 + 1 + frac);
+    }();
+
+    /**
+     * The shortest decimal that reads back into the same value, e.g. "0.1" for the prec32 nearest to 0.1, which is 0.1015625.
+     * Never more than one digit per fractional bit. Returns std::errc::value_too_large if it does not fit.
+     */
+    template <PrecType P>
+    constexpr std::to_chars_result to_chars(char* first, char* last, const P value) {
+        static_assert(-P::_n <= 64, "to_chars supports up to 64 fractional bits");
+        const auto mag = detail::magnitude<P>(value._data);
+        char* out = first;
+        if (value._data < 0) {
+            if (out == last) return {last, std::errc::value_too_large};
+            *out++ = '-';
+        }
+        if constexpr (P::_n >= 0) {
+            static_assert(8 * sizeof(typename P::value_type) + P::_n <= 128, "to_chars supports values of up to 128 bits");
+            out = detail::write_uint(out, last, detail::uint128_t(mag) << P::_n);
+        }
+        else {
+            constexpr int frac = -P::_n;
+            using W = detail::text_word<frac>;
+            detail::uint128_t integer = (frac >= int(8 * sizeof(mag))) ? 0 : (mag >> frac);
+            // fraction R / D with D = 2^(frac + 1), and the half unit in the last place M / D, both scaled by 10 per digit
+            const W D = W(1) << (frac + 1);
+            W R = (W(mag) << 1) & (D - 1), M = 1;
+            char digits[frac + 1]{};
+            int count = 0;
+            while (R != 0) {
+                R *= 10; M *= 10;
+                const char digit = char('0' + int(R >> (frac + 1)));
+                R &= D - 1;
+                const bool down = R < M, up = R + M > D; // Truncated, or rounded up, here is within the half unit
+                digits[count++] = digit;
+                if (down && up) { if (2 * R > D || (2 * R == D && (digit & 1))) detail::carry_up(integer, digits, count); }
+                else if (up) detail::carry_up(integer, digits, count);
+                if (down || up) break;
+            }
+            while (count > 0 && digits[count - 1] == '0') --count;
+            out = detail::write_fixed(out, last, integer, digits, count);
+        }
+        if (out == nullptr) return {last, std::errc::value_too_large};
+        return {out, std::errc()};
+    }
+
+    // Exactly `precision` decimals, rounded to nearest with ties to even, like printf("%.*f")
+    template <PrecType P>
+    constexpr std::to_chars_result to_chars(char* first, char* last, const P value, const int precision) {
+        static_assert(-P::_n <= 64, "to_chars supports up to 64 fractional bits");
+        const auto mag = detail::magnitude<P>(value._data);
+        char* out = first;
+        if (value._data < 0) {
+            if (out == last) return {last, std::errc::value_too_large};
+            *out++ = '-';
+        }
+        constexpr int frac = (P::_n < 0) ? -P::_n : 0;
+        detail::uint128_t integer;
+        char digits[frac + 1]{};
+        int count = 0;
+        if constexpr (P::_n >= 0) {
+            static_assert(8 * sizeof(typename P::value_type) + P::_n <= 128, "to_chars supports values of up to 128 bits");
+            integer = detail::uint128_t(mag) << P::_n;
+        }
+        else {
+            using W = detail::text_word<frac>;
+            integer = (frac >= int(8 * sizeof(mag))) ? 0 : (mag >> frac);
+            // The fraction has exactly `frac` decimals, so rounding only happens below that
+            const W D = W(1) << frac;
+            W R = W(mag) & (D - 1);
+            count = (precision < frac) ? precision : frac;
+            for (int i = 0; i < count; ++i) {
+                R *= 10;
+                digits[i] = char('0' + int(R >> frac));
+                R &= D - 1;
+            }
+            const bool odd = (count > 0) ? (digits[count - 1] & 1) : bool(integer & 1);
+            if (2 * R > D || (2 * R == D && odd)) detail::carry_up(integer, digits, count);
+        }
+        out = detail::write_uint(out, last, integer);
+        if (out == nullptr) return {last, std::errc::value_too_large};
+        if (precision > 0) {
+            if (last - out < precision + 1) return {last, std::errc::value_too_large};
+            *out++ = '.';
+            for (int i = 0; i < precision; ++i) *out++ = (i < count) ? digits[i] : '0';
+        }
+        return {out, std::errc()};
+    }
+
+    /**
+     * Parses a number in fixed notation into `value`, rounded to nearest with ties to even.
+     * Reads back every output of to_chars exactly, and any number of decimals.
+     * Errors as std::from_chars: std::errc::invalid_argument if no number starts at `first`,
+     * std::errc::result_out_of_range if it does not fit P, and `value` is only written on success.
+     */
+    template <PrecType P>
+    constexpr std::from_chars_result from_chars(const char* first, const char* last, P& value) {
+        static_assert(-P::_n <= 64, "from_chars supports up to 64 fractional bits");
+        using T = typename P::value_type;
+        using U = std::make_unsigned_t<T>;
+        const char* end;
+        const detail::decimal d = detail::parse_decimal(first, last, std::is_signed_v<T>, end);
+        if (end == first) return {first, std::errc::invalid_argument};
+
+        // Raw magnitude, before rounding, and the remainder against one half
+        detail::uint128_t raw;
+        int half;
+        if constexpr (P::_n > 0) {
+            constexpr int shift = (P::_n < 128) ? P::_n : 127;
+            raw = d.integer >> shift;
+            const detail::uint128_t rem = d.integer & ((detail::uint128_t(1) << shift) - 1), one_half = detail::uint128_t(1) << (shift - 1);
+            half = (rem < one_half) ? -1 : (rem > one_half || d.fraction_digits > 0) ? 1 : 0;
+        }
+        else {
+            constexpr int frac = -P::_n;
+            if (d.integer >> (128 - frac - 1) != 0) return {end, std::errc::result_out_of_range};
+            const auto [bits, compared] = detail::fraction_bits<frac>(d.fraction, d.fraction_digits);
+            raw = (d.integer << frac) + bits;
+            half = compared;
+        }
+        raw += (half > 0 || (half == 0 && (raw & 1)));
+
+        const detail::uint128_t limit = std::is_signed_v<T> && d.negative ? detail::uint128_t(U(std::numeric_limits<T>::max())) + 1
+                                                                           : detail::uint128_t(U(std::numeric_limits<T>::max()));
+        if (d.overflow || raw > limit) return {end, std::errc::result_out_of_range};
+        value._data = T(d.negative ? U(U(0) - U(raw)) : U(raw));
+        return {end, std::errc()};
+    }
+
+
+    /**
+     * Appends field `column` (counted from 0) of every line of delimited text, e.g. a CSV file, to `out`.
+     * Lines end in '\n' or "\r\n", blank lines are skipped, and spaces and tabs around fields are ignored.
+     * Returns the number of values appended. Throws if a line has no such field, or it is not a number of P.
+     */
+    template <PrecType P>
+    std::size_t parse_column(const std::string_view text, std::vector<P>& out, const std::size_t column = 0, const char delimiter = ',') {
+        const std::size_t before = out.size();
+        const auto is_blank = [](const char c) { return c == ' ' || c == '\t' || c == '\r'; };
+        std::size_t line = 0;
+        for (std::size_t start = 0; start < text.size(); ) {
+            ++line;
+            std::size_t stop = text.find('\n', start);
+            if (stop == std::string_view::npos) stop = text.size();
+            const char* p = text.data() + start;
+            const char* const line_end = text.data() + stop;
+            start = stop + 1;
+
+            const char* q = p;
+            while (q != line_end && is_blank(*q)) ++q;
+            if (q == line_end) continue;
+
+            for (std::size_t skip = 0; skip < column; ++skip) {
+                while (p != line_end && *p != delimiter) ++p;
+                if (p == line_end) throw std::runtime_error("column " + std::to_string(column) + " should exist, on line " + std::to_string(line));
+                ++p;
+            }
+            while (p != line_end && is_blank(*p)) ++p;
+            P value;
+            auto [end, error] = from_chars(p, line_end, value);
+            while (end != line_end && is_blank(*end)) ++end;
+            if (error != std::errc() || (end != line_end && *end != delimiter))
+                throw std::runtime_error("column " + std::to_string(column) + " should be a number, on line " + std::to_string(line));
+            out.push_back(value);
+        }
+        return out.size() - before;
+    }
+
+
+    // Streams the shortest decimal, as to_chars
+    template <typename T, int order, Rounding rounding, Overflow overflow>
+    std::ostream& operator<<(std::ostream& os, const Prec<T, order, rounding, overflow> value) {
+        char buffer[max_chars<Prec<T, order, rounding, overflow>>];
+        const auto result = to_chars(buffer, buffer + sizeof(buffer), value);
+        return os.write(buffer, result.ptr - buffer);
+    }
+
+
+}; // namespace dattatypes
+
+
+#ifdef __cpp_lib_format
+/**
+ * std::format support, e.g. for the logging macros of debug.hpp.
+ * "{}" writes the shortest decimal, "{:.3}" exactly three decimals. Formats on the stack: decimals past the
+ * fractional bits are zeros, so they are written after to_chars rather than into its buffer.
+ */
+template <typename T, int order, dattatypes::Rounding rounding, dattatypes::Overflow overflow>
+struct std::formatter<dattatypes::Prec<T, order, rounding, overflow>, char> {
+    int precision = -1;
+
+    constexpr auto parse(std::format_parse_context& ctx) {
+        auto it = ctx.begin();
+        if (it != ctx.end() && *it == '.') {
+            precision = 0;
+            for (++it; it != ctx.end() && *it >= '0' && *it <= '9'; ++it) precision = precision * 10 + (*it - '0');
+        }
+        if (it != ctx.end() && *it != '}') throw std::format_error("Prec format should be empty or a precision, e.g. {:.3}");
+        return it;
+    }
+
+    template <typename Context>
+    auto format(const dattatypes::Prec<T, order, rounding, overflow> value, Context& ctx) const {
+        using P = dattatypes::Prec<T, order, rounding, overflow>;
+        constexpr int frac = (order < 0) ? -order : 0;
+        std::array<char, dattatypes::max_chars<P>> buffer;
+        const auto result = (precision < 0) ? dattatypes::to_chars(buffer.data(), buffer.data() + buffer.size(), value)
+                                            : dattatypes::to_chars(buffer.data(), buffer.data() + buffer.size(), value, std::min(precision, frac));
+        auto out = std::copy(buffer.data(), result.ptr, ctx.out());
+        if (precision > frac) {
+            if (frac == 0) *out++ = '.';
+            out = std::fill_n(out, precision - frac, '0');
+        }
+        return out;
+    }
+};
+#endif
@@ -5,6 +5,12 @@
 #include <concepts>
 #include <cmath>
 #include <stdexcept>
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cstdint>
+#include <limits>
+#include <utility>
 
 #include <prec.hpp>
 
@@ -45,6 +51,12 @@ namespace dattatypes {
         { T::_n } -> std::convertible_to<int>;
     };
 
+    // The same Prec type with another overflow policy, e.g. `saturating<prec32>`
+    template <PrecType T>
+    using saturating = Prec<typename T::value_type, T::_n, T::_rounding, Overflow::saturate>;
+    template <PrecType T>
+    using checked = Prec<typename T::value_type, T::_n, T::_rounding, Overflow::trap>;
+
     #define ASSERT_ANGLE(T) static_assert( \
         std::is_signed_v<typename T::value_type> && \
         (T::_n == -(8 * sizeof(typename T::value_type) - 2)), \
@@ -56,30 +68,180 @@ namespace dattatypes {
         "Type is not a Prec-based probability. I.e.: where the range is [0.0, 2.0)." );
 
 
+    namespace detail {
+
+        // Round-to-nearest arithmetic right shift
+        template <typename I>
+        constexpr I round_shift(const I value, const int shift) {
+            return (value + (I(1) << (shift - 1))) >> shift;
+        }
+
+        // Fixed-point value with `from` fractional bits to the Prec type P, rounding to nearest and saturating.
+        template <PrecType P>
+        constexpr P from_fixed(int128_t value, const int from) {
+            using T = typename P::value_type;
+            const int to = -P::_n;
+            if (to < from) value = round_shift(value, from - to);
+            else value <<= (to - from);
+            value = std::clamp(value, int128_t(std::numeric_limits<T>::min()), int128_t(std::numeric_limits<T>::max()));
+            P result;
+            result._data = T(value);
+            return result;
+        }
+
+        // Accumulator for sums of raw products: 64 bits for types of up to 32 bits, 128 bits otherwise
+        template <PrecType P>
+        using accum_t = std::conditional_t<(sizeof(typename P::value_type) <= 4), typename P::wide_type,
+                        std::conditional_t<std::is_signed_v<typename P::value_type>, int128_t, uint128_t>>;
+
+        template <PrecType P>
+        constexpr accum_t<P> accum_product(const P a, const P b) { return accum_t<P>(a._data) * accum_t<P>(b._data); }
+
+        // a * 1.0 as a raw product, exact even for the unit types, where 1.0 does not fit P
+        template <PrecType P>
+        constexpr accum_t<P> accum_unit(const P a) {
+            if constexpr (P::_n <= 0) return accum_t<P>(a._data) << -P::_n;
+            else return accum_product(a, from_fixed<P>(1, 0));
+        }
+
+        // A sum of raw products back into P, with its rounding and overflow policy
+        template <PrecType P>
+        constexpr P from_accum(accum_t<P> sum) {
+            using A = accum_t<P>;
+            if constexpr (P::_n >= 0) sum <<= P::_n;
+            else shift_right<P::_rounding, -P::_n, A>(sum);
+            P result;
+            result._data = P::narrow(sum);
+            return result;
+        }
+
+        // Integer square root computed bit by bit. Slow, only used to generate tables.
+        constexpr uint64_t isqrt_bitwise(uint64_t value) {
+            uint64_t root = 0, bit = uint64_t(1) << 62;
+            while (bit > value) bit >>= 2;
+            while (bit != 0) {
+                if (value >= root + bit) { value -= root + bit; root = (root >> 1) + bit; }
+                else root >>= 1;
+                bit >>= 2;
+            }
+            return root;
+        }
+
+        // Seeds for 1/sqrt(M) in Q16, for M = (i + 0.5) / 256 in [0.25, 1.0), indexed by i - 64
+        inline constexpr auto rsqrt_seed = [] {
+            std::array<uint32_t, 192> table{};
+            for (unsigned i = 64; i < 256; ++i)
+                table[i - 64] = uint32_t(isqrt_bitwise((uint64_t(1) << 41) / (2*i + 1)));
+            return table;
+        }();
+
+        /**
+         * 1/sqrt(M) in Q61 for a normalised m = M * 2^64, with M in [0.25, 1.0).
+         * Seeds from `rsqrt_seed` (8 bits) and refines with division-free Newton-Raphson steps,
+         *   y = y * (3 - M y^2) / 2,
+         * each roughly doubling the number of correct bits: 2 steps give 31 bits, 3 reach the limit of Q61.
+         */
+        constexpr uint64_t rsqrt_q61(const uint64_t m, const int steps) {
+            uint64_t y = uint64_t(rsqrt_seed[(m >> 56) - 64]) << 45;
+            for (int i = 0; i < steps; ++i) {
+                const uint64_t y2 = uint64_t((uint128_t(y) * y) >> 61);
+                const uint64_t my2 = uint64_t((uint128_t(m) * y2) >> 64);
+                y = uint64_t((uint128_t(y) * ((uint64_t(3) << 61) - my2)) >> 62);
+            }
+            return y;
+        }
+
+        // Integer square root, floor(sqrt(value))
+        constexpr uint64_t isqrt(const uint64_t value) {
+            if (value < 2) return value;
+            const int shift = std::countl_zero(value) & ~1;
+            const uint64_t m = value << shift;
+            // sqrt(M) = M / sqrt(M), within 1 of the root; undo the normalisation and fix the last bit without branches
+            uint64_t root = uint64_t((uint128_t(m) * rsqrt_q61(m, 3)) >> 93) >> (shift / 2);
+            root -= (uint128_t(root) * root > value);
+            root += (uint128_t(root + 1) * (root + 1) <= value);
+            return root;
+        }
+        constexpr uint64_t isqrt(const uint128_t value) {
+            if ((value >> 64) == 0) return isqrt(uint64_t(value));
+            const int shift = std::countl_zero(uint64_t(value >> 64)) & ~1;
+            const uint64_t m = uint64_t((value << shift) >> 64);
+            // Estimate from the top 64 bits, then one Newton-Raphson step on the full value
+            uint128_t root = ((uint128_t(m) * rsqrt_q61(m, 3)) >> 61) >> (shift / 2);
+            root = (root + value / root) >> 1;
+            root = std::min(root, uint128_t(~uint64_t(0)));
+            root -= (root * root > value);
+            root += (root < ~uint64_t(0)) && ((root + 1) * (root + 1) <= value);
+            return uint64_t(root);
+        }
+
+        // Unsigned integer wide enough for the square of T, shifted by its fractional bits
+        template <PrecType T>
+        using square_t = std::conditional_t<(sizeof(typename T::value_type) <= 4), uint64_t, uint128_t>;
+
+    }; // namespace detail
+
+
     /**
      * Square Root for Prec numbers.
-     * Using Dampened Newton-Raphson Iteration.
-     *
-     * TODO: It is currently rather expensive
+     * Exact: returns the largest representable value whose square does not exceed the input.
+     * Integer only; see `detail::isqrt`.
      */
     template <PrecType T>
-    constexpr T sqrt(const T& value, int iterations = 32) {
-        if (value._data < 0)
-            throw std::runtime_error("sqrt input should be non-negative");
+    constexpr T sqrt(const T& value) {
+        if constexpr (std::is_signed_v<typename T::value_type>)
+            if (value._data < 0)
+                throw std::runtime_error("sqrt input should be non-negative");
 
-        int shift = -T::_n;
-        u_int64_t S = u_int64_t(value._data);
-        u_int64_t x_n = (S >> (1 - (-shift >> 1)));
-        u_int64_t x_nm1 = 0;
-        int t = 1 << shift;
+        using S = detail::square_t<T>;
+        constexpr int frac = -T::_n;
+        const S square = (frac >= 0) ? S(value._data) << frac : S(value._data) >> -frac;
 
-        while (iterations-- > 0 && x_n != x_nm1) {
-            x_nm1 = x_n;
-            x_n = ( (x_n+1) + ( (S / (x_n) ) << shift) ) >> 1;
-        }
+        T res;
+        res._data = typename T::value_type(std::min<S>(detail::isqrt(square), std::numeric_limits<typename T::value_type>::max()));
+        return res;
+    }
+
+    /**
+     * Reciprocal Square Root for Prec numbers: 1 / sqrt(value).
+     * Rounded to nearest, saturating where the result does not fit (e.g. for 0).
+     */
+    template <PrecType T>
+    constexpr T rsqrt(const T& value) {
+        using V = typename T::value_type;
+        if constexpr (std::is_signed_v<V>)
+            if (value._data < 0)
+                throw std::runtime_error("rsqrt input should be non-negative");
+        if (value._data == 0)
+            return detail::from_fixed<T>(std::numeric_limits<V>::max(), -T::_n);
+
+        // Normalise into m = M * 2^64 with M in [0.25, 1.0), keeping the shift of the same parity as `frac`
+        constexpr int frac = -T::_n;
+        const uint64_t raw = uint64_t(value._data);
+        int shift = std::countl_zero(raw);
+        if ((shift - frac) & 1) --shift;
+        const uint64_t m = (shift >= 0) ? raw << shift : raw >> 1;
+
+        // 2^frac / sqrt(raw * 2^-frac) = 1/sqrt(M) * 2^((3 frac + shift - 64) / 2)
+        const uint64_t y = detail::rsqrt_q61(m, (sizeof(V) <= 2) ? 2 : 3);
+        return detail::from_fixed<T>(y, 61 + frac - (3*frac + shift - 64) / 2);
+    }
+
+    /**
+     * Hypotenuse for Prec numbers: sqrt(x^2 + y^2), without intermediate overflow.
+     * Exact like `sqrt`, saturating where the result does not fit.
+     */
+    template <PrecType T>
+    constexpr T hypot(const T& x, const T& y) {
+        using V = typename T::value_type;
+        using U = std::make_unsigned_t<V>;
+        const auto magnitude = [](const V v) { return detail::uint128_t((v < 0) ? U(U(0) - U(v)) : U(v)); };
+        const detail::uint128_t xx = magnitude(x._data) * magnitude(x._data), yy = magnitude(y._data) * magnitude(y._data);
+        // Only u64 squares can carry out of 128 bits, and their root would not fit anyway
+        const uint64_t root = (xx + yy < xx) ? ~uint64_t(0) : detail::isqrt(xx + yy);
 
         T res;
-        res._data = x_n;
+        res._data = V(std::min<uint64_t>(root, std::numeric_limits<V>::max()));
         return res;
     }
 
@@ -91,28 +253,502 @@ namespace dattatypes {
 
 
 
-    // TODO(): Implement Trigonometric functions
-    // template <typename Angle, typename Slope>
-    // constexpr Slope sin(const Angle& value) {
-    //     ASSERT_ANGLE(A)
-    //     return 1;
-    // }
-    // template <typename Angle, typename Slope>
-    // constexpr Slope cos(const Angle& value) {
-    //     ASSERT_ANGLE(A)
-    //     return 1;
-    // }
-    //     template <typename Slope, typename Angle>
-    // constexpr Angle asin(const Slope& value) {
-    //     ASSERT_ANGLE(A)
-    //     return 1;
-    // }
-    // template <typename Slope, typename Angle>
-    // constexpr Angle acos(const Slope& value) {
-    //     ASSERT_ANGLE(A)
-    //     return 1;
-    // }
+    // Angle type of the same width as T
+    template <PrecType T>
+    using angle_of = Prec<std::make_signed_t<typename T::value_type>, -int(8 * sizeof(typename T::value_type) - 2)>;
+
+
+    namespace detail {
+
+        /**
+         * Compile-time Q126 arithmetic, used to generate the lookup tables.
+         * Exact integer arithmetic keeps the tables identical on every platform,
+         * unlike `long double`, whose width depends on the target.
+         */
+        inline constexpr uint128_t pi_q126 = (uint128_t(0xC90FDAA22168C234) << 64) | 0xC4C6628B80DC1CD1;
+        inline constexpr uint128_t two_over_pi_q126 = (uint128_t(0x28BE60DB9391054A) << 64) | 0x7F09D5F47D4D3770;
+
+        // (a * b) >> 126 through a 256-bit product
+        constexpr uint128_t mul_q126(const uint128_t a, const uint128_t b) {
+            const uint128_t al = uint64_t(a), ah = a >> 64, bl = uint64_t(b), bh = b >> 64;
+            uint128_t lo = al * bl, hi = ah * bh;
+            for (const uint128_t mid : {ah * bl, al * bh}) {
+                const uint128_t shifted = mid << 64;
+                lo += shifted;
+                hi += (mid >> 64) + (lo < shifted);
+            }
+            return (hi << 2) | (lo >> 126);
+        }
+
+        // Taylor series of sin(x) for x in [0, pi/2]
+        constexpr uint128_t sin_q126(const uint128_t x) {
+            const uint128_t x2 = mul_q126(x, x);
+            uint128_t term = x, sum = x;
+            for (unsigned k = 1; term != 0; ++k) {
+                term = mul_q126(term, x2) / ((2*k) * (2*k + 1));
+                sum = (k & 1) ? sum - term : sum + term;
+            }
+            return sum;
+        }
+
+        // Taylor series of atan(2^-i), in units of 2^-128 turns
+        constexpr uint128_t atan_turns(const int i) {
+            if (i == 0) return uint128_t(1) << 125; // An eighth of a turn
+            const uint128_t t = uint128_t(1) << (126 - i), t2 = mul_q126(t, t);
+            uint128_t power = t, sum = t;
+            for (unsigned k = 1; power != 0; ++k) {
+                power = mul_q126(power, t2);
+                sum = (k & 1) ? sum - power / (2*k + 1) : sum + power / (2*k + 1);
+            }
+            return mul_q126(sum, two_over_pi_q126);
+        }
+
+        // Quarter sine wave sampled at 2^bits + 1 points, in Q62
+        template <int bits>
+        inline constexpr auto quarter_sine = [] {
+            std::array<int64_t, (1 << bits) + 1> table{};
+            for (int i = 0; i <= (1 << bits); ++i)
+                table[i] = int64_t((sin_q126(((pi_q126 >> 1) >> bits) * i) + (uint128_t(1) << 63)) >> 64);
+            return table;
+        }();
+
+        // Same table in Q38, for the 64-bit arithmetic path
+        template <int bits>
+        inline constexpr auto quarter_sine38 = [] {
+            std::array<int64_t, (1 << bits) + 1> table{};
+            for (int i = 0; i <= (1 << bits); ++i)
+                table[i] = round_shift(quarter_sine<bits>[i], 24);
+            return table;
+        }();
+
+        // CORDIC rotation angles atan(2^-i), in units of 2^-128 turns
+        template <int iterations>
+        inline constexpr auto cordic_turns = [] {
+            std::array<uint128_t, iterations> table{};
+            for (int i = 0; i < iterations; ++i)
+                table[i] = atan_turns(i);
+            return table;
+        }();
+
+        // Same angles in units of 2^-64 turns
+        template <int iterations>
+        inline constexpr auto cordic_turns64 = [] {
+            std::array<uint64_t, iterations> table{};
+            for (int i = 0; i < iterations; ++i)
+                table[i] = uint64_t(round_shift(cordic_turns<iterations>[i], 64));
+            return table;
+        }();
+
+        // Angle as a phase, where 2^64 is one full turn
+        template <PrecType Angle>
+        constexpr uint64_t turn_phase(const Angle& angle) {
+            constexpr int bits = 8 * sizeof(typename Angle::value_type);
+            return uint64_t(int64_t(angle._data)) << (65 - bits);
+        }
+
+        // Map a quadrant-local sine and cosine onto the full turn, without branching on the quadrant
+        template <typename I>
+        constexpr std::pair<I, I> unfold_quadrant(const unsigned quadrant, const I s, const I c) {
+            const I a = (quadrant & 1) ? c : s, b = (quadrant & 1) ? s : c;
+            return {((quadrant >> 1) & 1) ? -a : a, (((quadrant + 1) >> 1) & 1) ? -b : b};
+        }
+
+        /**
+         * Sine and cosine of a 32-bit phase, in Q30.
+         * Looks up the nearest point x0 of a quarter-wave table and corrects by the offset d:
+         *   sin(x0 + d) = sin(x0) cos(d) + cos(x0) sin(d)
+         * with cos(d) and sin(d) from their Taylor series.
+         * Only uses 64-bit integer arithmetic.
+         */
+        constexpr std::pair<int64_t, int64_t> sincos_q30(const uint32_t phase) {
+            constexpr int bits = 8, step = 30 - bits;
+            constexpr int64_t half_pi = int64_t(pi_q126 >> 92); // Q35
+            const auto& table = quarter_sine38<bits>;
+
+            const uint32_t r = phase & ((uint32_t(1) << 30) - 1);
+            const uint32_t i = (r + (uint32_t(1) << (step - 1))) >> step;
+            const int64_t d = round_shift((int64_t(r) - (int64_t(i) << step)) * half_pi, 32); // Q33 radians
+            const int64_t d2 = round_shift(d * d, 33);
+            const int64_t d3 = round_shift(d2 * d, 33);
+            const int64_t cos_d = -(d2 >> 1);           // cos(d) - 1
+            const int64_t sin_d = d - d3 / 6;
+
+            const int64_t S = table[i], C = table[(1 << bits) - i];
+            const int64_t s = S + round_shift(S * cos_d, 33) + round_shift(C * sin_d, 33);
+            const int64_t c = C + round_shift(C * cos_d, 33) - round_shift(S * sin_d, 33);
+            return unfold_quadrant(phase >> 30, round_shift(s, 8), round_shift(c, 8));
+        }
+
+        // Sine and cosine of a 64-bit phase, in Q62. Same scheme as `sincos_q30`, in 128-bit arithmetic.
+        constexpr std::pair<int64_t, int64_t> sincos_q62(const uint64_t phase) {
+            constexpr int bits = 8, step = 62 - bits;
+            constexpr int64_t half_pi = int64_t(pi_q126 >> 65); // Q62
+            const auto& table = quarter_sine<bits>;
+
+            const uint64_t r = phase & ((uint64_t(1) << 62) - 1);
+            const uint64_t i = (r + (uint64_t(1) << (step - 1))) >> step;
+            const int128_t d = round_shift(int128_t(int64_t(r) - int64_t(i << step)) * half_pi, 54); // Q70 radians
+            const int128_t d2 = round_shift(d * d, 70);
+            const int128_t d3 = round_shift(d2 * d, 70);
+            const int128_t d4 = round_shift(d2 * d2, 70);
+            const int128_t d5 = round_shift(d4 * d, 70);
+            const int128_t d6 = round_shift(d3 * d3, 70);
+            const int128_t cos_d = -d2 / 2 + d4 / 24 - d6 / 720; // cos(d) - 1
+            const int128_t sin_d = d - d3 / 6 + d5 / 120;
+
+            const int128_t S = table[i], C = table[(1 << bits) - i];
+            const int128_t s = S + round_shift(S * cos_d, 70) + round_shift(C * sin_d, 70);
+            const int128_t c = C + round_shift(C * cos_d, 70) - round_shift(S * sin_d, 70);
+            return unfold_quadrant(unsigned(phase >> 62), int64_t(s), int64_t(c));
+        }
 
+        /**
+         * CORDIC vectoring: angle of the point (x, y).
+         * Rotates the point onto the positive x-axis by the angles atan(2^-i), summing them up.
+         * Angles up to 32 bits run 16 steps in 64-bit arithmetic and finish with one division,
+         * angle64 runs 64 steps in 128-bit arithmetic.
+         */
+        template <PrecType Angle>
+        constexpr Angle cordic_atan2(int128_t y, int128_t x) {
+            constexpr int bits = 8 * sizeof(typename Angle::value_type);
+            if (x == 0 && y == 0) return from_fixed<Angle>(0, 0);
+
+            // Rotate the left half-plane onto the right one
+            const bool lower = y < 0;
+            uint128_t turns = 0;
+            if (x < 0) { x = -x; y = -y; turns = uint128_t(1) << 127; }
+
+            // Normalise the magnitude to leave exactly enough headroom for the CORDIC gain
+            constexpr int headroom = (bits <= 32) ? 60 : 100;
+            const uint128_t m = uint128_t(std::max(x, (y < 0) ? -y : y));
+            const int length = (m >> 64) ? 64 + std::bit_width(uint64_t(m >> 64)) : std::bit_width(uint64_t(m));
+            if (length <= headroom) { x <<= headroom - length; y <<= headroom - length; }
+            else { x >>= length - headroom; y >>= length - headroom; }
+
+            int128_t raw;
+            if constexpr (bits <= 32) {
+                constexpr auto& table = cordic_turns64<16>;
+                constexpr int64_t turns_per_radian = int64_t(two_over_pi_q126 >> 93); // 2^35 / 2pi
+                int64_t X = int64_t(x), Y = int64_t(y);
+                uint64_t z = uint64_t(turns >> 64);
+                for (int i = 0; i < 16; ++i) {
+                    // Rotate towards the x-axis: conditionally negate the steps by the sign mask of Y
+                    const int64_t sign = Y >> 63, dx = Y >> i, dy = X >> i;
+                    X += (dx ^ sign) - sign;
+                    Y -= (dy ^ sign) - sign;
+                    z += (table[i] ^ uint64_t(sign)) - uint64_t(sign);
+                }
+                // The remaining angle is below 2^-15 radians, where atan(Y/X) = Y/X well within 32 bits
+                const int64_t residual = (Y << 15) / (X >> 30); // Q45 radians
+                z += uint64_t((residual * turns_per_radian) >> 16);
+                raw = round_shift(int128_t(int64_t(z)), 65 - bits);
+            } else {
+                constexpr auto& table = cordic_turns<64>;
+                uint128_t z = turns;
+                for (int i = 0; i < 64; ++i) {
+                    const int128_t sign = y >> 127, dx = y >> i, dy = x >> i;
+                    x += (dx ^ sign) - sign;
+                    y -= (dy ^ sign) - sign;
+                    z += (table[i] ^ uint128_t(sign)) - uint128_t(sign);
+                }
+                raw = round_shift(int128_t(z), 129 - bits);
+            }
+
+            // A half turn takes the sign of y
+            constexpr int128_t half_turn = int128_t(1) << (bits - 2);
+            if (raw == half_turn || raw == -half_turn) raw = lower ? -half_turn : half_turn;
+            Angle result;
+            result._data = typename Angle::value_type(raw);
+            return result;
+        }
+
+        // Sine and cosine parts (s, sqrt(1 - s^2)) of a slope, in the same fixed point
+        template <PrecType Slope>
+        constexpr std::pair<int128_t, int128_t> unit_legs(const Slope& value) {
+            constexpr int from = -Slope::_n;
+            constexpr int frac = std::max(from, 30);
+            const int128_t one = int128_t(1) << frac;
+            const int128_t s = int128_t(value._data) << (frac - from);
+            if (s > one || s < -one)
+                throw std::runtime_error("asin and acos input should be within [-1.0, 1.0]");
+            if constexpr (frac <= 31) return {s, int128_t(isqrt(uint64_t((one - s) * (one + s))))};
+            else return {s, int128_t(isqrt(uint128_t((one - s) * (one + s))))};
+        }
+
+    }; // namespace detail
+
+
+    /**
+     * Trigonometric functions for Prec-based angles.
+     *
+     * An angle counts half turns: 1.0 is pi radians, and the range [-2.0, 2.0) wraps around
+     * twice, so overflowing angle arithmetic still lands on the right direction.
+     * The result type defaults to the angle type itself, which holds [-1.0, 1.0] exactly.
+     * Another type may be given as the first template argument, e.g. `sin<unit32>(angle)`,
+     * where 1.0 saturates to the largest value below it.
+     *
+     * Integer only and constexpr. sin and cos use a 257-point quarter-wave table with a Taylor
+     * correction, the inverse functions use CORDIC. All tables are generated at compile time.
+     *
+     * Max error, against the exact result rounded to the output type:
+     * - sin, cos, sincos:  1 ULP up to 32 bits, 2 ULP for 64 bits.
+     * - atan2:             1 ULP up to 32 bits, 2 ULP for 64 bits.
+     * - asin, acos:        Same as atan2 where the input carries enough precision. Near |x| = 1 the
+     *                      slope is steep, and the error follows the input's resolution instead.
+     */
+    template <typename Slope = void, PrecType Angle>
+    constexpr auto sincos(const Angle& angle) {
+        ASSERT_ANGLE(Angle)
+        using R = std::conditional_t<std::is_void_v<Slope>, Angle, Slope>;
+        const uint64_t phase = detail::turn_phase(angle);
+        if constexpr (sizeof(typename Angle::value_type) == 8 || -R::_n > 30) {
+            const auto [s, c] = detail::sincos_q62(phase);
+            return std::pair<R, R>{detail::from_fixed<R>(s, 62), detail::from_fixed<R>(c, 62)};
+        } else {
+            const auto [s, c] = detail::sincos_q30(uint32_t(phase >> 32));
+            return std::pair<R, R>{detail::from_fixed<R>(s, 30), detail::from_fixed<R>(c, 30)};
+        }
+    }
+
+    template <typename Slope = void, PrecType Angle>
+    constexpr auto sin(const Angle& angle) { return sincos<Slope>(angle).first; }
+
+    template <typename Slope = void, PrecType Angle>
+    constexpr auto cos(const Angle& angle) { return sincos<Slope>(angle).second; }
+
+    // Angle of the point (x, y), in (-1.0, 1.0] half turns
+    template <typename Angle = void, PrecType T>
+    constexpr auto atan2(const T& y, const T& x) {
+        using R = std::conditional_t<std::is_void_v<Angle>, angle_of<T>, Angle>;
+        ASSERT_ANGLE(R)
+        return detail::cordic_atan2<R>(detail::int128_t(y._data), detail::int128_t(x._data));
+    }
+
+    // Inverse sine, in [-0.5, 0.5] half turns
+    template <typename Angle = void, PrecType Slope>
+    constexpr auto asin(const Slope& value) {
+        using R = std::conditional_t<std::is_void_v<Angle>, angle_of<Slope>, Angle>;
+        ASSERT_ANGLE(R)
+        const auto [s, c] = detail::unit_legs(value);
+        return detail::cordic_atan2<R>(s, c);
+    }
+
+    // Inverse cosine, in [0.0, 1.0] half turns
+    template <typename Angle = void, PrecType Slope>
+    constexpr auto acos(const Slope& value) {
+        using R = std::conditional_t<std::is_void_v<Angle>, angle_of<Slope>, Angle>;
+        ASSERT_ANGLE(R)
+        const auto [c, s] = detail::unit_legs(value);
+        return detail::cordic_atan2<R>(s, c);
+    }
+
+
+    namespace detail {
+
+        inline constexpr uint128_t ln2_q126 = (uint128_t(0x2C5C85FDF473DE6A) << 64) | 0xF278ECE600FCBDAB;
+        inline constexpr uint128_t log2e_q126 = (uint128_t(0x5C551D94AE0BF85D) << 64) | 0xDF43FF68348E9F44;
+
+        // Series of log2(1 + 2^-k) for k >= 1, in Q126. The powers of 2^-k are exact shifts.
+        constexpr uint128_t log2_factor_q126(const int k) {
+            uint128_t sum = 0;
+            for (int n = 1; k * n <= 126; ++n) {
+                const uint128_t term = (uint128_t(1) << (126 - k * n)) / n;
+                sum = (n & 1) ? sum + term : sum - term;
+            }
+            return mul_q126(sum, log2e_q126);
+        }
+
+        /**
+         * The exponential cores work in Q62 on uint64_t for results of up to 32 bits,
+         * and in Q126 on uint128_t for 64-bit results, where Q62 rounding would add up to several ULP.
+         */
+        template <PrecType R>
+        using exp_word = std::conditional_t<(sizeof(typename R::value_type) == 8), uint128_t, uint64_t>;
+        template <typename U>
+        inline constexpr int exp_q = 8 * sizeof(U) - 2;
+
+        // log2(1 + 2^-k) in Q62 or Q126, indexed by k; the factors of the shift-and-add decomposition
+        template <typename U>
+        inline constexpr auto log2_factors = [] {
+            std::array<U, exp_q<U> + 1> table{};
+            for (int k = 1; k <= exp_q<U>; ++k) {
+                if constexpr (exp_q<U> == 126) table[k] = log2_factor_q126(k);
+                else table[k] = U((log2_factor_q126(k) + (uint128_t(1) << 63)) >> 64);
+            }
+            return table;
+        }();
+
+        /**
+         * log2(m) for m in [1.0, 2.0), all in Q62 or Q126.
+         * Multiplies up z = 1 by every factor (1 + 2^-k) that keeps it below m, which takes a shift and an add,
+         * while summing their logarithms from `log2_factors`. After `steps` factors, m / z < 1 + 2^-steps.
+         */
+        template <int steps, typename U>
+        constexpr U log2_core(const U m) {
+            U z = U(1) << exp_q<U>, sum = 0;
+            for (int k = 1; k <= steps; ++k) {
+                const U mask = U(0) - U(z + (z >> k) <= m);
+                z += (z >> k) & mask;
+                sum += log2_factors<U>[k] & mask;
+            }
+            return sum;
+        }
+
+        /**
+         * 2^f for f in [0.0, 1.0), all in Q62 or Q126.
+         * The inverse walk of `log2_core`: subtracts every factor's logarithm that fits into f,
+         * then corrects the remainder r < 2^-steps by the series 2^r ~ 1 + x + x^2 / 2 with x = r ln(2),
+         * for about 3 * steps bits.
+         */
+        template <int steps, typename U>
+        constexpr U exp2_core(U f) {
+            U z = U(1) << exp_q<U>;
+            for (int k = 1; k <= steps; ++k) {
+                const U mask = U(0) - U(f >= log2_factors<U>[k]);
+                f -= log2_factors<U>[k] & mask;
+                z += (z >> k) & mask;
+            }
+            if constexpr (exp_q<U> == 126) {
+                const U x = mul_q126(f, ln2_q126);
+                return z + mul_q126(z, x + (mul_q126(x, x) >> 1));
+            } else {
+                const auto mul = [](const U a, const U b) { return U((uint128_t(a) * b) >> 62); };
+                const U x = mul(f, U(ln2_q126 >> 64));
+                return z + mul(z, x + (mul(x, x) >> 1));
+            }
+        }
+
+        // Fractional bits of the log2 results. Q126 leaves no room for the integer part, so those drop to Q118.
+        template <typename U>
+        inline constexpr int log_frac = (exp_q<U> == 126) ? 118 : 62;
+
+        /**
+         * log2 of a positive raw value with `frac` fractional bits, in `log_frac<U>` fractional bits.
+         * The integer part comes from the bit width, the fraction from `log2_core` on the normalised value.
+         */
+        template <typename U, int steps>
+        constexpr int128_t log2_fixed(const uint64_t raw, const int frac) {
+            const int exponent = std::bit_width(raw) - 1;
+            const uint64_t m = (exponent <= 62) ? raw << (62 - exponent) : raw >> 1;
+            const U fraction = log2_core<steps>(U(m) << (exp_q<U> - 62));
+            return (int128_t(exponent - frac) << log_frac<U>) + int128_t(fraction >> (exp_q<U> - log_frac<U>));
+        }
+
+        // Steps of the decompositions for a result type R
+        template <PrecType R>
+        inline constexpr int log2_steps = std::clamp(-R::_n + 3, 4, exp_q<exp_word<R>>);
+        template <PrecType R>
+        inline constexpr int exp2_steps = int(8 * sizeof(typename R::value_type) + 8) / 3;
+
+        // Saturated results
+        template <PrecType R>
+        constexpr R lowest() { R r; r._data = std::numeric_limits<typename R::value_type>::min(); return r; }
+        template <PrecType R>
+        constexpr R highest() { R r; r._data = std::numeric_limits<typename R::value_type>::max(); return r; }
+
+        // 2^value for a value with `frac` fractional bits, into R, saturating
+        template <PrecType R>
+        constexpr R exp2_fixed(const int128_t value, const int frac) {
+            using U = exp_word<R>;
+            constexpr int to = -R::_n, q = exp_q<U>;
+            const int128_t whole = value >> frac; // floor
+            if (whole < -to - 1) return from_fixed<R>(0, 0); // Below half the resolution
+            const uint128_t f = uint128_t(value - (whole << frac));
+            const U phase = U((frac <= q) ? f << (q - frac) : f >> (frac - q));
+            // Above this bound the result saturates anyway, so clamping keeps the shifts in range
+            const int i = int(std::min<int128_t>(whole, 64 - to));
+            return from_fixed<R>(int128_t(exp2_core<exp2_steps<R>>(phase) >> 1), q - 1 - i);
+        }
+
+        // Raw value of a Prec, widened
+        template <PrecType T>
+        constexpr int128_t wide_raw(const T& value) { return int128_t(value._data); }
+
+        // Signed value times a Q126 constant, keeping the fractional bits of the value
+        constexpr int128_t mul_q126(const int128_t value, const uint128_t constant) {
+            const int128_t product = int128_t(mul_q126(uint128_t((value < 0) ? -value : value), constant));
+            return (value < 0) ? -product : product;
+        }
+
+    }; // namespace detail
+
+
+    /**
+     * Exponential and logarithmic functions for Prec numbers.
+     *
+     * The result type defaults to the argument type, or may be given first, e.g. `exp2<prec64>(x)`.
+     * Results saturate where they do not fit. Logarithms of 0 saturate to the lowest value,
+     * and of negative numbers throw, like `sqrt`.
+     *
+     * Integer only and constexpr, using shift-and-add decomposition into factors (1 + 2^-k),
+     * whose logarithms come from a table generated at compile time.
+     *
+     * Max error, against the exact result rounded to the output type:
+     * - exp2, log2, exp, log:  1 ULP.
+     * - pow:                   1 ULP for moderate exponents. log2(base) carries 62 fractional bits, so the error
+     *                          grows with |exponent| once the result needs more relative precision than that.
+     */
+    template <typename Result = void, PrecType T>
+    constexpr auto exp2(const T& value) {
+        using R = std::conditional_t<std::is_void_v<Result>, T, Result>;
+        return detail::exp2_fixed<R>(detail::wide_raw(value), -T::_n);
+    }
+
+    template <typename Result = void, PrecType T>
+    constexpr auto exp(const T& value) {
+        using R = std::conditional_t<std::is_void_v<Result>, T, Result>;
+        // e^x = 2^(x log2(e)), with log2(e) in Q126 kept to 62 bits beyond the input's resolution
+        return detail::exp2_fixed<R>(detail::mul_q126(detail::wide_raw(value) << 62, detail::log2e_q126), -T::_n + 62);
+    }
+
+    template <typename Result = void, PrecType T>
+    constexpr auto log2(const T& value) {
+        using R = std::conditional_t<std::is_void_v<Result>, T, Result>;
+        using U = detail::exp_word<R>;
+        if (value._data < 0) throw std::runtime_error("log2 input should be non-negative");
+        if (value._data == 0) return detail::lowest<R>();
+        return detail::from_fixed<R>(detail::log2_fixed<U, detail::log2_steps<R>>(uint64_t(value._data), -T::_n),
+                                     detail::log_frac<U>);
+    }
+
+    template <typename Result = void, PrecType T>
+    constexpr auto log(const T& value) {
+        using R = std::conditional_t<std::is_void_v<Result>, T, Result>;
+        using U = detail::exp_word<R>;
+        if (value._data < 0) throw std::runtime_error("log input should be non-negative");
+        if (value._data == 0) return detail::lowest<R>();
+        // ln(x) = log2(x) ln(2)
+        const detail::int128_t log2 = detail::log2_fixed<U, detail::log2_steps<R>>(uint64_t(value._data), -T::_n);
+        return detail::from_fixed<R>(detail::mul_q126(log2, detail::ln2_q126), detail::log_frac<U>);
+    }
+
+    // base^exponent = 2^(exponent log2(base)), for a non-negative base
+    template <typename Result = void, PrecType T, PrecType U>
+    constexpr auto pow(const T& base, const U& exponent) {
+        using R = std::conditional_t<std::is_void_v<Result>, T, Result>;
+        using W = detail::exp_word<R>;
+        if (base._data < 0) throw std::runtime_error("pow base should be non-negative");
+        if (exponent._data == 0) return detail::from_fixed<R>(1, 0);
+        if (base._data == 0) return (exponent._data > 0) ? detail::from_fixed<R>(0, 0) : detail::highest<R>();
+
+        // log2(base) in Q62, as precise as the relative precision of the result, plus guard bits for the exponent.
+        // Low bits are dropped as its magnitude grows, so the product with the exponent fits 128 bits.
+        constexpr int steps = std::min(int(8 * sizeof(typename R::value_type)) + 8, detail::exp_q<W>);
+        const detail::int128_t log = detail::log2_fixed<W, steps>(uint64_t(base._data), -T::_n) >> (detail::log_frac<W> - 62);
+        const int drop = std::bit_width(uint64_t(detail::uint128_t((log < 0) ? -log : log) >> 62));
+        return detail::exp2_fixed<R>(detail::wide_raw(exponent) * (log >> drop), -U::_n + 62 - drop);
+    }
+
+    // Linear interpolation a + (b - a) t, rounded to nearest. t is any Prec type, usually a unit or probability.
+    // Two 64-bit operands drop the lowest 2 fractional bits of t (rounded), so the sum of products fits 128 bits.
+    template <PrecType T, PrecType U>
+    constexpr T lerp(const T& a, const T& b, const U& t) {
+        constexpr int drop = std::clamp(int(8 * (sizeof(typename T::value_type) + sizeof(typename U::value_type))) - 126, 0, std::max(-U::_n, 0));
+        detail::int128_t weight = detail::wide_raw(t);
+        detail::shift_right<Rounding::nearest, drop, detail::int128_t>(weight);
+        const detail::int128_t delta = detail::wide_raw(b) - detail::wide_raw(a);
+        return detail::from_fixed<T>((detail::wide_raw(a) << (-U::_n - drop)) + delta * weight, -T::_n - U::_n - drop);
+    }
 
 
 }; // namespace dattatypes
@@ -0,0 +1,49 @@
+#pragma once
+// === HEADER ONLY ===
+
+#include <cstddef>
+#include <cstring>
+
+/**
+ * Portable SIMD helpers.
+ *
+ * Kernels are written with the GCC/Clang vector extensions, which lower to SSE2, AVX2 or AVX-512
+ * depending on the target flags (e.g. `-mavx2`, `-march=native`).
+ * The register width is picked from the widest enabled instruction set.
+ * Define DATTATYPES_NO_SIMD to force the scalar paths.
+ */
+namespace dattatypes::simd {
+
+#if defined(DATTATYPES_NO_SIMD) || !(defined(__GNUC__) || defined(__clang__))
+    inline constexpr std::size_t register_bytes = 0;
+#elif defined(__AVX512BW__)
+    inline constexpr std::size_t register_bytes = 64;
+#elif defined(__AVX2__)
+    inline constexpr std::size_t register_bytes = 32;
+#else
+    inline constexpr std::size_t register_bytes = 16; // SSE2 / NEON
+#endif
+
+    inline constexpr bool enabled = register_bytes != 0;
+
+    // Number of T lanes in one register
+    template <typename T>
+    inline constexpr std::size_t lanes = enabled ? register_bytes / sizeof(T) : 1;
+
+#if defined(__GNUC__) || defined(__clang__)
+    // Vector of N lanes of T
+    template <typename T, std::size_t N>
+    using vec __attribute__((vector_size(N * sizeof(T)))) = T;
+#else
+    template <typename T, std::size_t N>
+    struct vec { T _lanes[N]; };
+#endif
+
+    // Unaligned load and store
+    template <typename V, typename T>
+    inline V load(const T* ptr) { V v; std::memcpy(&v, ptr, sizeof(V)); return v; }
+    template <typename V, typename T>
+    inline void store(T* ptr, const V& v) { std::memcpy(ptr, &v, sizeof(V)); }
+
+
+}; // namespace dattatypes::simd
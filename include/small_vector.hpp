@@ -0,0 +1,210 @@
+#pragma once
+// === HEADER ONLY ===
+
+#include <memory>
+#include <memory_resource>
+#include <initializer_list>
+#include <iterator>
+#include <algorithm>
+#include <cstddef>
+#include <cstring>
+#include <type_traits>
+#include <utility>
+
+namespace dattatypes {
+
+    /**
+     * A std::vector of trivially copyable T, holding its first N elements inside the object.
+     * Spills to memory from Alloc once it grows past N, and moves back inline on `shrink_to_fit()` when it fits again.
+     * Follows the allocator propagation rules of std::vector, so `std::pmr::polymorphic_allocator` works with arenas.
+     * Iterators are plain pointers, invalidated by any change of capacity, and by moves while inline.
+     */
+    template <typename T, std::size_t N, typename Alloc = std::allocator<T>>
+    class small_vector {
+        static_assert(std::is_trivially_copyable_v<T>, "T must be trivially copyable");
+        static_assert(N > 0, "small_vector should have an inline capacity, use std::vector otherwise");
+        using traits = std::allocator_traits<Alloc>;
+
+    public:
+        using value_type = T;
+        using allocator_type = Alloc;
+        using size_type = std::size_t;
+        using difference_type = std::ptrdiff_t;
+        using reference = T&;
+        using const_reference = const T&;
+        using pointer = T*;
+        using const_pointer = const T*;
+        using iterator = T*;
+        using const_iterator = const T*;
+
+        small_vector() = default;
+        explicit small_vector(const Alloc& alloc) : _alloc(alloc) {}
+        small_vector(std::initializer_list<T> values, const Alloc& alloc = Alloc()) : _alloc(alloc) { assign(values.begin(), values.end()); }
+        template <std::input_iterator It>
+        small_vector(It first, It last, const Alloc& alloc = Alloc()) : _alloc(alloc) { assign(first, last); }
+
+        small_vector(const small_vector& other)
+            : _alloc(traits::select_on_container_copy_construction(other._alloc)) { assign(other.begin(), other.end()); }
+        small_vector(small_vector&& other) noexcept : _alloc(std::move(other._alloc)) { steal(other); }
+        ~small_vector() { release(); }
+
+        small_vector& operator=(const small_vector& other) {
+            if (this == &other) return *this;
+            if constexpr (traits::propagate_on_container_copy_assignment::value)
+                if (_alloc != other._alloc) { release(); _alloc = other._alloc; }
+            assign(other.begin(), other.end());
+            return *this;
+        }
+        small_vector& operator=(small_vector&& other) noexcept(traits::propagate_on_container_move_assignment::value || traits::is_always_equal::value) {
+            if (this == &other) return *this;
+            if constexpr (traits::propagate_on_container_move_assignment::value) {
+                release();
+                _alloc = std::move(other._alloc);
+                steal(other);
+            }
+            else if (_alloc == other._alloc) { release(); steal(other); }
+            else { assign(other.begin(), other.end()); other.clear(); }
+            return *this;
+        }
+
+        // Element access
+        T* data() { return _begin; }
+        const T* data() const { return _begin; }
+        T& operator[](const std::size_t i) { return _begin[i]; }
+        const T& operator[](const std::size_t i) const { return _begin[i]; }
+        T& front() { return _begin[0]; }
+        const T& front() const { return _begin[0]; }
+        T& back() { return _begin[_size - 1]; }
+        const T& back() const { return _begin[_size - 1]; }
+
+        // Iterators
+        iterator begin() { return _begin; }
+        const_iterator begin() const { return _begin; }
+        iterator end() { return _begin + _size; }
+        const_iterator end() const { return _begin + _size; }
+
+        // Capacity
+        bool empty() const { return _size == 0; }
+        std::size_t size() const { return _size; }
+        std::size_t capacity() const { return _capacity; }
+        static constexpr std::size_t inline_capacity() { return N; }
+        bool is_inline() const { return _begin == _inline; }
+        Alloc get_allocator() const { return _alloc; }
+
+        void reserve(const std::size_t capacity) { if (capacity > _capacity) reallocate(capacity); }
+        void shrink_to_fit() { if (!is_inline()) reallocate(std::max(_size, N)); }
+
+        // Modifiers
+        void clear() { _size = 0; }
+
+        void resize(const std::size_t size) {
+            reserve_for(size);
+            if (size > _size) std::memset(static_cast<void*>(_begin + _size), 0, (size - _size) * sizeof(T));
+            _size = size;
+        }
+        void resize(const std::size_t size, const T value) {
+            reserve_for(size);
+            if (size > _size) std::fill(_begin + _size, _begin + size, value);
+            _size = size;
+        }
+
+        template <std::input_iterator It>
+        void assign(It first, It last) {
+            clear();
+            insert(end(), first, last);
+        }
+
+        void push_back(const T value) {
+            reserve_for(_size + 1);
+            _begin[_size++] = value;
+        }
+        void pop_back() { --_size; }
+
+        iterator insert(const_iterator position, const T value) { return insert(position, &value, &value + 1); }
+        iterator insert(const_iterator position, std::initializer_list<T> values) { return insert(position, values.begin(), values.end()); }
+
+        // Inserts [first, last), which may not point into this vector
+        template <std::input_iterator It>
+        iterator insert(const_iterator position, It first, It last) {
+            const std::size_t index = std::size_t(position - _begin);
+            if constexpr (std::forward_iterator<It>) {
+                const std::size_t count = std::size_t(std::distance(first, last));
+                reserve_for(_size + count);
+                std::memmove(static_cast<void*>(_begin + index + count), _begin + index, (_size - index) * sizeof(T));
+                std::copy(first, last, _begin + index);
+                _size += count;
+            }
+            else
+                for (std::size_t i = index; first != last; ++first, ++i) insert(_begin + i, T(*first));
+            return _begin + index;
+        }
+
+        iterator erase(const_iterator first, const_iterator last) {
+            const std::size_t index = std::size_t(first - _begin), count = std::size_t(last - first);
+            std::memmove(static_cast<void*>(_begin + index), _begin + index + count, (_size - index - count) * sizeof(T));
+            _size -= count;
+            return _begin + index;
+        }
+        iterator erase(const_iterator position) { return erase(position, position + 1); }
+
+        void swap(small_vector& other) {
+            if constexpr (traits::propagate_on_container_swap::value) std::swap(_alloc, other._alloc);
+            small_vector temporary(std::move(other));
+            other = std::move(*this);
+            *this = std::move(temporary);
+        }
+
+        friend bool operator==(const small_vector& a, const small_vector& b) { return std::equal(a.begin(), a.end(), b.begin(), b.end()); }
+
+    private:
+        [[no_unique_address]] Alloc _alloc{};
+        T* _begin = _inline;
+        std::size_t _size = 0;
+        std::size_t _capacity = N;
+        T _inline[N];
+
+        // Grows geometrically to hold `size` elements
+        void reserve_for(const std::size_t size) { if (size > _capacity) reallocate(std::max(size, 2 * _capacity)); }
+
+        // Moves the elements into `capacity`, inline if it fits
+        void reallocate(const std::size_t capacity) {
+            T* target = (capacity <= N) ? _inline : traits::allocate(_alloc, capacity);
+            if (target == _begin) return;
+            std::memcpy(static_cast<void*>(target), _begin, _size * sizeof(T));
+            release();
+            _begin = target;
+            _capacity = std::max(capacity, N);
+        }
+
+        // Frees the heap buffer, if any, and goes back inline
+        void release() {
+            if (!is_inline()) traits::deallocate(_alloc, _begin, _capacity);
+            _begin = _inline;
+            _capacity = N;
+        }
+
+        // Takes the elements of other, whose allocator can free its buffer, leaving it empty
+        void steal(small_vector& other) {
+            if (other.is_inline()) {
+                std::memcpy(static_cast<void*>(_inline), other._inline, other._size * sizeof(T));
+                _begin = _inline;
+                _capacity = N;
+            }
+            else {
+                _begin = other._begin;
+                _capacity = other._capacity;
+            }
+            _size = other._size;
+            other._begin = other._inline;
+            other._capacity = N;
+            other._size = 0;
+        }
+    };
+
+
+    namespace pmr {
+        template <typename T, std::size_t N>
+        using small_vector = dattatypes::small_vector<T, N, std::pmr::polymorphic_allocator<T>>;
+    }; // namespace pmr
+
+}; // namespace dattatypes
@@ -2,100 +2,176 @@
 // === HEADER ONLY ===
 
 #include <vector>
+#include <span>
+#include <memory>
+#include <memory_resource>
+#include <utility>
+#include <initializer_list>
 #include <type_traits>
 #include <algorithm>
+#include <bit>
+#include <cstdint>
+#include <limits>
+#include <optional>
+#include <stdexcept>
+#include <iterator>
+#include <ranges>
+#include <atomic>
+#include <mutex>
 
 #include "debug.hpp"
+#include "small_vector.hpp"
 
 /**
  * Efficiently maps enum->bool
  * Implements std::vector.
+ *
+ * Stores sorted intervals while they are few, and switches to a bitmap over the values they span once that is smaller,
+ * i.e. when the set is dense or fragmented. It switches back once the intervals take less than half the bitmap.
+ * A check is then one bit test, and the size a popcount.
+ *
+ * The first N endpoints, i.e. N / 2 intervals, are stored inside the object, and spill to the heap only past that.
+ * Besides them the object holds the count and one pointer: the bitmap, the rank index and the search layout live in
+ * a side block, allocated once the map switches to a bitmap or grows past `search_threshold` endpoints.
+ *
+ * Thread safety is that of the standard containers: const members may be called from any number of threads at once,
+ * and any change needs exclusive access. The rank index and search layout that const queries build lazily are built
+ * once under a mutex and published with release order, and `check` only reads them after an acquire load.
+ * The endpoints, the bitmap and the rank index come from Alloc, e.g. `pmr::unlock_map` on a
+ * `std::pmr::monotonic_buffer_resource` arena, freed at once with it; so do the scratch buffers of the set algebra.
  */
 namespace dattatypes {
 
-	template<typename T>
+	template <typename T, std::size_t N, typename Alloc>
+	class concurrent_unlock_map;
+
+	template<typename T, std::size_t N = 0, typename Alloc = std::allocator<std::underlying_type_t<T>>>
 	class unlock_map {
 		static_assert(std::is_enum_v<T>, "T must be an enum type");
 
 		// Underlying integer type
 		using U = std::underlying_type_t<T>;
+		static_assert(std::is_same_v<typename Alloc::value_type, U>, "Alloc should allocate the underlying type of T");
+
+		template <typename V>
+		using Rebind = typename std::allocator_traits<Alloc>::template rebind_alloc<V>;
+		// Endpoint storage, inline for N > 0
+		using Storage = std::conditional_t<N == 0, std::vector<U, Alloc>, small_vector<U, N, Alloc>>;
 	public:
+		using allocator_type = Alloc;
+
 		unlock_map() = default;
-		unlock_map(std::vector<U> vec) : _data(std::move(vec)) {};
-		~unlock_map() = default;
+		explicit unlock_map(const Alloc& alloc) : _data(alloc) {}
+		unlock_map(std::vector<U> vec, const Alloc& alloc = Alloc()) : unlock_map(alloc) { assign(std::move(vec)); recount(); adapt(); };
+		unlock_map(const unlock_map& other) : _data(other._data), _count(other._count) { if (other._side) copy_side(*other._side); }
+		unlock_map(unlock_map&& other) noexcept
+			: _data(std::move(other._data)), _count(std::exchange(other._count, 0)), _side(std::exchange(other._side, nullptr)) {}
+		~unlock_map() { release(); }
 
-		std::vector<U> _data{}; // Pairs of [start, past_end]
+		unlock_map& operator=(const unlock_map& other) {
+			if (this == &other) return *this;
+			release();  // Allocated from the allocator of _data, which may change
+			_data = other._data;
+			_count = other._count;
+			if (other._side) copy_side(*other._side);
+			return *this;
+		}
+		unlock_map& operator=(unlock_map&& other) noexcept(std::allocator_traits<Alloc>::propagate_on_container_move_assignment::value || std::allocator_traits<Alloc>::is_always_equal::value) {
+			if (this == &other) return *this;
+			release();
+			const bool steal = std::allocator_traits<Alloc>::propagate_on_container_move_assignment::value || get_allocator() == other.get_allocator();
+			_data = std::move(other._data);
+			_count = std::exchange(other._count, 0);
+			if (steal) _side = std::exchange(other._side, nullptr);
+			else if (other._side) { copy_side(*other._side); other.release(); }
+			return *this;
+		}
+
+		Storage _data{}; // Pairs of [start, past_end], while not in bitmap mode
 
 		// Insert a single value into the interval set
 		void insert(const T item) {
-			U lower_value = U(item);
-			U upper_value = U(item)+1;
+			if (bitmap()) bitmap_insert(U(item));
+			else {
+				U lower_value = U(item);
+				U upper_value = U(item)+1;
 
-			if (_data.empty() || (_data.front() > upper_value)) [[unlikely]] {
-				_data.insert(_data.begin(), {lower_value, upper_value});
-				return;
+				if (_data.empty() || (_data.front() > upper_value)) [[unlikely]]
+					_data.insert(_data.begin(), {lower_value, upper_value}), ++_count;
+				else if (_data.back() < lower_value)
+					_data.insert(_data.end(), {lower_value, upper_value}), ++_count;
+				else
+					insertion_logic(lower_value, upper_value);
 			}
-			if (_data.back() < lower_value) {
-				_data.insert(_data.end(), {lower_value, upper_value});
-				return;
-			}
-
-			Range range = find_range(lower_value, upper_value);
-			insertion_logic(lower_value, upper_value, range);
+			adapt();
 		}
 
 		// Insert a range [item_begin, item_end] of values into the interval set
 		void insert(const T item_begin, const T item_end) {
 			if (item_begin > item_end) return;
 
-			U lower_value = U(item_begin);
-			U upper_value = U(item_end)+1;
+			if (bitmap()) bitmap_insert(U(item_begin), U(item_end));
+			else {
+				U lower_value = U(item_begin);
+				U upper_value = U(item_end)+1;
 
-			if (_data.empty() || (_data.back() < lower_value)) [[unlikely]] {
-				_data.insert(_data.end(), {lower_value, upper_value});
-				return;
+				if (_data.empty() || (_data.back() < lower_value)) [[unlikely]]
+					_data.insert(_data.end(), {lower_value, upper_value}), _count += distance(lower_value, upper_value);
+				else if (_data.front() > upper_value)
+					_data.insert(_data.begin(), {lower_value, upper_value}), _count += distance(lower_value, upper_value);
+				else
+					insertion_logic(lower_value, upper_value);
 			}
-			if (_data.front() > upper_value) {
-				_data.insert(_data.begin(), {lower_value, upper_value});
-				return;
-			}
-
-			Range range = find_range(lower_value, upper_value);
-			insertion_logic(lower_value, upper_value, range);
+			adapt();
 		}
 
 		// Erase a single value from the interval set
 		void erase(const T item) {
-			U lower_value = U(item);
-			U upper_value = U(item)+1;
+			if (bitmap()) bitmap_erase(U(item));
+			else {
+				U lower_value = U(item);
+				U upper_value = U(item)+1;
 
-			if (_data.empty() || (_data.back() < lower_value)) [[unlikely]]
-				return;
-			if (_data.front() > upper_value)
-				return;
+				if (_data.empty() || (_data.back() < lower_value)) [[unlikely]]
+					return;
+				if (_data.front() > upper_value)
+					return;
 
-			Range range = find_range(lower_value, upper_value);
-			erasure_logic(lower_value, upper_value, range);
+				erasure_logic(lower_value, upper_value);
+			}
+			adapt();
 		}
 
 		// Erase a range [item_begin, item_end] of values from the interval set
 		void erase(const T item_begin, const T item_end) {
 			if (item_begin > item_end) return;
 
-			U lower_value = U(item_begin);
-			U upper_value = U(item_end)+1;
+			if (bitmap()) bitmap_erase(U(item_begin), U(item_end));
+			else {
+				U lower_value = U(item_begin);
+				U upper_value = U(item_end)+1;
 
-			if (_data.empty() || (_data.back() < lower_value)) [[unlikely]]
-				return;
-			if (_data.front() > upper_value)
-				return;
+				if (_data.empty() || (_data.back() < lower_value)) [[unlikely]]
+					return;
+				if (_data.front() > upper_value)
+					return;
 
-			Range range = find_range(lower_value, upper_value);
-			erasure_logic(lower_value, upper_value, range);
+				erasure_logic(lower_value, upper_value);
+			}
+			adapt();
 		}
 
 		// Check whether the item exists in any stored interval
 		bool check(const T item) const {
+			if (bitmap()) {
+				const std::size_t offset = offset_of(U(item));
+				return (offset < _side->span) && ((_side->bits[offset >> 6] >> (offset & 63)) & 1);
+			}
+			if (_side && _side->searchable.load(std::memory_order_acquire) && _data.size() >= search_threshold) {
+				bool result;
+				search_batch(&item, &result, 1);
+				return result;
+			}
 			if (_data.empty() || _data[0] > U(item)) return false;
 			// Last element not greater than item
 			auto it = std::upper_bound(_data.begin(), _data.end(), U(item)) -1;
@@ -103,115 +179,953 @@ namespace dattatypes {
 			return !(index & 1); // Item already exists if index is odd.
 		}
 
-		constexpr bool empty() const { return _data.empty(); }
-		constexpr void clear() { _data.clear(); }
+		/**
+		 * results[i] = check(items[i]), for as many results as items.
+		 * From `search_threshold` endpoints on, searches an Eytzinger layout of them: a branch-free descent, prefetching
+		 * the nodes a cache line of levels down, for `search_group` items in lock step so that their cache misses overlap.
+		 * The layout is rebuilt in O(n) by the first batch after a change, and `check` uses it too once it is published.
+		 * In bitmap mode, each item is one bit test.
+		 */
+		void check_batch(std::span<const T> items, std::span<bool> results) const {
+			if (items.size() != results.size()) throw std::runtime_error("check_batch should have as many results as items");
+			if (bitmap() || _data.size() < search_threshold) {
+				for (std::size_t i = 0; i < items.size(); ++i) results[i] = check(items[i]);
+				return;
+			}
+			search();
+			for (std::size_t i = 0; i < items.size(); i += search_group)
+				search_batch(items.data() + i, results.data() + i, std::min(search_group, items.size() - i));
+		}
+
+		constexpr bool empty() const { return _count == 0; }
+		constexpr void clear() {
+			_data.clear();
+			_count = 0;
+			if (_side) {
+				_side->bits.clear();
+				_side->span = 0;
+				_side->runs = 0;
+				_side->bitmap = false;
+				_side->indexed.store(false, std::memory_order_relaxed);
+				_side->searchable.store(false, std::memory_order_relaxed);
+			}
+		}
 		constexpr void reserve(std::size_t __n) { _data.reserve(__n); }
-		constexpr void shrink_to_fit() { _data.shrink_to_fit(); }
-
-		// Calculates the number of values covered
-		constexpr size_t size() const {
-			if (_data.empty()) return 0;
-			size_t sum=0, i=0;
-			for (; i+1<_data.size() ; i+=2)
-				sum += size_t(_data[i+1]-_data[i]);
-			return sum;
+		constexpr void shrink_to_fit() { _data.shrink_to_fit(); if (_side) _side->bits.shrink_to_fit(); }
+
+		// The number of values covered, kept up to date by every change
+		constexpr size_t size() const { return _count; }
+
+		/**
+		 * Order statistics, in O(log(n)) on a prefix-sum index over the intervals, or over the words of the bitmap;
+		 * below `search_threshold` endpoints, by a walk over the intervals.
+		 * The index is rebuilt in O(n) by the first query after a change.
+		 */
+
+		// The number of values below item
+		size_t rank(const T item) const {
+			index();
+			if (bitmap()) {
+				const std::size_t offset = offset_of(U(item));
+				if (offset >= _side->span) return (U(item) < _side->base) ? 0 : _count;
+				return _side->prefix[offset >> 6] + size_t(std::popcount(_side->bits[offset >> 6] & ((uint64_t(1) << (offset & 63)) - 1)));
+			}
+			if (!_side) {
+				// Below `search_threshold` endpoints there is no index, and the intervals are summed directly
+				std::size_t below = 0;
+				for (std::size_t i = 0; i + 1 < _data.size() && _data[i] <= U(item); i += 2) below += distance(_data[i], std::min(_data[i + 1], U(item)));
+				return below;
+			}
+			// Intervals starting at or before item
+			const std::size_t index = std::upper_bound(_data.begin(), _data.end(), U(item)) - _data.begin();
+			if (!(index & 1)) return _side->prefix[index / 2];
+			return _side->prefix[index / 2] + distance(_data[index - 1], U(item));
+		}
+
+		// The k-th value, counting from 0; k should be below size()
+		T select(const size_t k) const {
+			if (k >= _count) throw std::runtime_error("select index should be below size()");
+			index();
+			if (!_side) {
+				std::size_t skip = k;
+				for (std::size_t i = 0; ; i += 2) {
+					if (skip < distance(_data[i], _data[i + 1])) return T(UU(UU(_data[i]) + UU(skip)));
+					skip -= distance(_data[i], _data[i + 1]);
+				}
+			}
+			// The last word or interval with fewer than k + 1 values before it
+			const std::size_t i = std::upper_bound(_side->prefix.begin(), _side->prefix.end(), k) - _side->prefix.begin() - 1;
+			if (!bitmap()) return T(UU(UU(_data[2 * i]) + UU(k - _side->prefix[i])));
+			uint64_t word = _side->bits[i];
+			for (size_t skip = k - _side->prefix[i]; skip > 0; --skip) word &= word - 1;
+			return T(value_of(64 * i + std::size_t(std::countr_zero(word))));
+		}
+
+		// The first value from item on that is in the set, if any
+		std::optional<T> next_set(const T item) const {
+			if (bitmap()) {
+				const std::size_t offset = (U(item) < _side->base) ? 0 : offset_of(U(item));
+				const std::size_t found = next_bit(offset, true);
+				if (found < _side->span) return T(value_of(found));
+				return std::nullopt;
+			}
+			const std::size_t index = std::upper_bound(_data.begin(), _data.end(), U(item)) - _data.begin();
+			if (index & 1) return item;
+			// Skip empty intervals left in _data from outside
+			for (std::size_t i = index; i + 1 < _data.size(); i += 2)
+				if (_data[i] != _data[i + 1]) return T(_data[i]);
+			return std::nullopt;
+		}
+
+		// The first value from item on that is not in the set, if any
+		std::optional<T> next_unset(const T item) const {
+			if (bitmap()) {
+				const std::size_t offset = offset_of(U(item));
+				if (offset >= _side->span) return item;
+				const std::size_t found = next_bit(offset, false);
+				if (found < _side->span) return T(value_of(found));
+				if (value_of(_side->span - 1) == std::numeric_limits<U>::max()) return std::nullopt;
+				return T(U(value_of(_side->span - 1) + 1));
+			}
+			const std::size_t index = std::upper_bound(_data.begin(), _data.end(), U(item)) - _data.begin();
+			if (!(index & 1)) return item;
+			// The end of this interval, unless the next one starts there
+			std::size_t end = index;
+			while (end + 2 < _data.size() && _data[end + 1] == _data[end]) end += 2;
+			return T(_data[end]);
+		}
+
+		// Whether the values are held in the bitmap, rather than as intervals in `_data`
+		constexpr bool bitmap() const { return _side && _side->bitmap; }
+
+		// Pairs of [start, past_end], in either representation
+		std::vector<U> intervals() const {
+			std::vector<U> result;
+			if (!bitmap()) result.assign(_data.begin(), _data.end());
+			else write_intervals(result);
+			return result;
+		}
+
+		Alloc get_allocator() const { return _data.get_allocator(); }
+
+		/**
+		 * Lazy views over the covered values, in order and in either representation, copying nothing.
+		 * - covered_intervals() : each maximal run as a pair [first, last], empty intervals skipped
+		 * - covered_values()    : each value
+		 * Both are forward ranges, valid until the next change.
+		 *
+		 *     for (const auto [first, last] : map.covered_intervals()) ...
+		 *     auto granted = map.covered_values() | std::views::filter(is_rare);
+		 */
+		class interval_iterator {
+		public:
+			using value_type = std::pair<T, T>;
+			using difference_type = std::ptrdiff_t;
+
+			interval_iterator() = default;
+			value_type operator*() const {
+				if (_map->bitmap()) return {T(_map->value_of(_position)), T(_map->value_of(_end - 1))};
+				return {T(_map->_data[_position]), T(U(_map->_data[_position + 1] - 1))};
+			}
+			interval_iterator& operator++() { _position = _end; settle(); return *this; }
+			interval_iterator operator++(int) { interval_iterator previous = *this; ++*this; return previous; }
+			bool operator==(const interval_iterator& other) const { return _position == other._position; }
+			bool operator==(std::default_sentinel_t) const { return _position >= _map->limit(); }
+
+		private:
+			friend class unlock_map;
+			explicit interval_iterator(const unlock_map* map) : _map(map) { settle(); }
+
+			// Moves to the next non-empty interval from _position on, and finds its end
+			void settle() {
+				if (_map->bitmap()) {
+					_position = _map->next_bit(_position, true);
+					_end = _map->next_bit(_position, false);
+				}
+				else {
+					while (_position + 1 < _map->_data.size() && _map->_data[_position] == _map->_data[_position + 1]) _position += 2;
+					_end = _position + 2;
+				}
+			}
+
+			const unlock_map* _map = nullptr;
+			std::size_t _position = 0;  // Index into _data, or offset into the bitmap, of the start
+			std::size_t _end = 0;       // Of the next start to look from
+		};
+
+		class value_iterator {
+		public:
+			using value_type = T;
+			using difference_type = std::ptrdiff_t;
+
+			value_iterator() = default;
+			value_type operator*() const { return T(_value); }
+			value_iterator& operator++() {
+				if (_map->bitmap()) {
+					_position = _map->next_bit(_position + 1, true);
+					_value = _map->value_of(_position);
+				}
+				else if ((_value = U(UU(UU(_value) + 1))) == _stop) {
+					_position += 2;
+					settle();
+				}
+				return *this;
+			}
+			value_iterator operator++(int) { value_iterator previous = *this; ++*this; return previous; }
+			bool operator==(const value_iterator& other) const { return _position == other._position && _value == other._value; }
+			bool operator==(std::default_sentinel_t) const { return _position >= _map->limit(); }
+
+		private:
+			friend class unlock_map;
+			explicit value_iterator(const unlock_map* map) : _map(map) {
+				if (_map->bitmap()) _position = _map->next_bit(0, true), _value = _map->value_of(_position);
+				else settle();
+			}
+
+			// Moves to the first value of the next non-empty interval from _position on
+			void settle() {
+				while (_position + 1 < _map->_data.size() && _map->_data[_position] == _map->_data[_position + 1]) _position += 2;
+				if (_position < _map->_data.size()) _value = _map->_data[_position], _stop = _map->_data[_position + 1];
+			}
+
+			const unlock_map* _map = nullptr;
+			std::size_t _position = 0;  // Index into _data of the interval, or offset into the bitmap
+			U _value{};
+			U _stop{};                  // Past the end of the interval
+		};
+
+		std::ranges::subrange<interval_iterator, std::default_sentinel_t> covered_intervals() const { return {interval_iterator(this), std::default_sentinel}; }
+		std::ranges::subrange<value_iterator, std::default_sentinel_t> covered_values() const { return {value_iterator(this), std::default_sentinel}; }
+
+		/**
+		 * Set algebra, each one linear merge over the two sorted endpoint vectors, or word by word over two bitmaps.
+		 * The compound forms merge intervals in place, reallocating only when _data lacks the capacity for both inputs.
+		 * The operations are written with bitwise operators, so they apply to bitmap words and, in bit 0, to single values alike.
+		 */
+		unlock_map& operator|=(const unlock_map& other) { return combine(other, [](auto a, auto b) { return a | b; }); }
+		unlock_map& operator&=(const unlock_map& other) { return combine(other, [](auto a, auto b) { return a & b; }); }
+		unlock_map& operator-=(const unlock_map& other) { return combine(other, [](auto a, auto b) { return a & ~b; }); }
+		unlock_map& operator^=(const unlock_map& other) { return combine(other, [](auto a, auto b) { return a ^ b; }); }
+
+		friend unlock_map operator|(const unlock_map& a, const unlock_map& b) { return merged(a, b, [](auto x, auto y) { return x | y; }); }
+		friend unlock_map operator&(const unlock_map& a, const unlock_map& b) { return merged(a, b, [](auto x, auto y) { return x & y; }); }
+		friend unlock_map operator-(const unlock_map& a, const unlock_map& b) { return merged(a, b, [](auto x, auto y) { return x & ~y; }); }
+		friend unlock_map operator^(const unlock_map& a, const unlock_map& b) { return merged(a, b, [](auto x, auto y) { return x ^ y; }); }
+
+		// Whether every value of other is also in this set
+		bool includes(const unlock_map& other) const { return !any(other, [](bool a, bool b) { return b && !a; }); }
+
+		// Whether any value is in both sets
+		bool intersects(const unlock_map& other) const { return any(other, [](bool a, bool b) { return a && b; }); }
+
+		// Build from values in any order, with duplicates: one sort, then the runs. O(k log(k))
+		static unlock_map from_unsorted(std::span<const T> items, const Alloc& alloc = Alloc()) { return unlock_map(runs_of(items), alloc); }
+
+		/**
+		 * Batch insertion and erasure: the values or ranges [first, second] are sorted, coalesced into runs,
+		 * and merged into the intervals in one pass. O(n + k log(k))
+		 * In bitmap mode, the runs are set or cleared in place, the bitmap growing at most once to cover them,
+		 * O(k log(k)) plus the words they cover; unless the grown bitmap would be larger than the intervals, then merged.
+		 */
+		void insert_batch(std::span<const T> items) { insert_runs(runs_of(items)); }
+		void insert_ranges(std::span<const std::pair<T, T>> ranges) { insert_runs(runs_of(ranges)); }
+		void erase_batch(std::span<const T> items) { erase_runs(runs_of(items)); }
+		void erase_ranges(std::span<const std::pair<T, T>> ranges) { erase_runs(runs_of(ranges)); }
+
+		/**
+		 * Compact encoding, appended to out: LEB128 varints of the number of intervals, then the first start (zigzag for
+		 * signed T), and for every interval its length - 1 and the gap to the next start. Close endpoints take a byte each,
+		 * against sizeof(T) for `serialize`. O(n)
+		 */
+		void encode(std::vector<uint8_t>& out) const {
+			write_varint(out, uint64_t(std::ranges::distance(covered_intervals())));
+			UU previous{};
+			for (bool first = true; const auto [start, last] : covered_intervals()) {
+				if (first) write_varint(out, zigzag(U(start)));
+				else write_varint(out, UU(UU(biased(U(start))) - previous));
+				write_varint(out, UU(UU(biased(U(last))) - UU(biased(U(start)))));
+				previous = UU(biased(U(last)) + 1);
+				first = false;
+			}
+		}
+		std::vector<uint8_t> encode() const {
+			std::vector<uint8_t> out;
+			encode(out);
+			return out;
+		}
+
+		/**
+		 * Replaces the contents by the encoding at the start of bytes, written straight into the endpoints.
+		 * Returns the bytes read, so encodings can follow each other. Throws on malformed input, leaving the map empty. O(n)
+		 */
+		std::size_t decode(std::span<const uint8_t> bytes) {
+			clear();
+			std::size_t read = 0;
+			const uint64_t intervals = read_varint(bytes, read);
+			// Every interval takes at least two bytes
+			if (intervals > (bytes.size() - read) / 2) fail("unlock_map encoding should hold as many intervals as it counts");
+			_data.resize(2 * std::size_t(intervals));
+			UU next{};
+			for (std::size_t i = 0; i < _data.size(); i += 2) {
+				const uint64_t gap = read_varint(bytes, read), length = read_varint(bytes, read);
+				UU start, last;
+				if (i == 0) start = biased(unzigzag(narrow_varint(gap)));
+				else if (__builtin_add_overflow(next, narrow_varint(gap), &start)) fail("unlock_map encoding should stay within the range of T");
+				// The end past the last value should be representable, as for insert
+				if (__builtin_add_overflow(start, narrow_varint(length), &last) || last == std::numeric_limits<UU>::max())
+					fail("unlock_map encoding should stay within the range of T");
+				next = UU(last + 1);
+				_data[i] = unbiased(start);
+				_data[i + 1] = unbiased(next);
+				_count += std::size_t(length) + 1;
+			}
+			adapt();
+			return read;
 		}
 
-        // (De)Serialization
+        // (De)Serialization, always as intervals
         template <class Archive>
-        void serialize(Archive &ar) { ar(_data); }
+        void serialize(Archive &ar) {
+            if (bitmap()) to_intervals();
+            if constexpr (std::is_same_v<Storage, std::vector<U>>) ar(_data);
+            else {
+                // Through a std::vector, which archives know
+                std::vector<U> values(_data.begin(), _data.end());
+                ar(values);
+                assign(std::move(values));
+            }
+            recount();
+            adapt();
+        }
 	private:
+		// Publishes versions with the index and search layout built
+		friend class concurrent_unlock_map<T, N, Alloc>;
 
-		struct Range {
-			std::vector<U>::iterator lower_it, upper_it;
-			bool lower_is_start , upper_is_end;
+		// Unsigned U, in which offsets from the start of the bitmap wrap like the values do
+		using UU = std::make_unsigned_t<U>;
+
+		// Endpoints searched in Eytzinger order from `search_threshold` on; see `search()`
+		static constexpr std::size_t search_threshold = 64;
+		static constexpr std::size_t search_group = 16;
+		// Levels of descendants that share a cache line, prefetched k * search_prefetch
+		static constexpr std::size_t search_prefetch = std::max<std::size_t>(64 / sizeof(U), 2);
+
+		/**
+		 * The bitmap, the rank index and the search layout, which small interval sets never need, so they stay out of the object.
+		 * Allocated by `adapt()` once the map switches to a bitmap or reaches `search_threshold` endpoints, and kept until destroyed.
+		 */
+		struct Side {
+			std::vector<uint64_t, Rebind<uint64_t>> bits;  // Bitmap mode: bit i is the value base + i
+			U base{};
+			std::size_t span = 0;   // Values covered by bits
+			std::size_t runs = 0;   // Intervals in the bitmap
+			bool bitmap = false;
+
+			// Values before each interval, or each bitmap word, and one past the last; see `index()`
+			std::vector<std::size_t, Rebind<std::size_t>> prefix;
+			// Endpoints in Eytzinger order, from index 1; see `search()`
+			std::vector<U, Alloc> search;
+			std::vector<uint8_t, Rebind<uint8_t>> odd;  // Whether node k is at an odd index of _data, i.e. an end
+
+			// Whether prefix and search are current: set with release order once built under `building`, read with acquire order
+			std::atomic<bool> indexed{false}, searchable{false};
+			std::mutex building;
+
+			explicit Side(const Alloc& alloc) : bits(alloc), prefix(alloc), search(alloc), odd(alloc) {}
+			// Copies the bitmap only; the copy builds its own index and layout, so a copy never reads one being built
+			Side& operator=(const Side& other) {
+				bits = other.bits;
+				base = other.base;
+				span = other.span;
+				runs = other.runs;
+				bitmap = other.bitmap;
+				indexed.store(false, std::memory_order_relaxed);
+				searchable.store(false, std::memory_order_relaxed);
+				return *this;
+			}
 		};
+		using SideTraits = std::allocator_traits<Rebind<Side>>;
+
+		std::size_t _count = 0;   // Values covered
+		Side* _side = nullptr;    // Only read by the const queries, which may fill in its index and layout
+
+		// The order of U, as unsigned; for the deltas of `encode`
+		static constexpr UU biased(const U value) {
+			if constexpr (std::is_signed_v<U>) return UU(UU(value) ^ (UU(1) << (8 * sizeof(U) - 1)));
+			else return UU(value);
+		}
+		static constexpr U unbiased(const UU value) { return U(std::is_signed_v<U> ? UU(value ^ (UU(1) << (8 * sizeof(U) - 1))) : value); }
+
+		// Small magnitudes to small unsigned values: 0, -1, 1, -2...
+		static constexpr UU zigzag(const U value) {
+			if constexpr (std::is_signed_v<U>) return UU(UU(UU(value) << 1) ^ UU(value < 0 ? ~UU(0) : UU(0)));
+			else return UU(value);
+		}
+		static constexpr U unzigzag(const UU value) {
+			if constexpr (std::is_signed_v<U>) return U(UU(value >> 1) ^ UU(UU(0) - UU(value & 1)));
+			else return U(value);
+		}
+
+		static void write_varint(std::vector<uint8_t>& out, uint64_t value) {
+			for (; value >= 0x80; value >>= 7) out.push_back(uint8_t(value | 0x80));
+			out.push_back(uint8_t(value));
+		}
+
+		// Decoding errors leave the map empty
+		void fail(const char* message) { clear(); throw std::runtime_error(message); }
+
+		// The varint at bytes[read], advancing read past it
+		uint64_t read_varint(std::span<const uint8_t> bytes, std::size_t& read) {
+			uint64_t value = 0;
+			for (int shift = 0; read < bytes.size(); shift += 7) {
+				const uint8_t byte = bytes[read++];
+				if (shift == 63 && byte > 1) break;
+				value |= uint64_t(byte & 0x7f) << shift;
+				if (!(byte & 0x80)) return value;
+			}
+			fail("unlock_map encoding should end with complete varints of up to 64 bits");
+			return 0;
+		}
+		UU narrow_varint(const uint64_t value) {
+			if (value > std::numeric_limits<UU>::max()) fail("unlock_map encoding should stay within the range of T");
+			return UU(value);
+		}
+
+		// The end position of the iterators: past the endpoints, or past the bitmap
+		std::size_t limit() const { return bitmap() ? _side->span : _data.size(); }
+
+		// Values in [lower_value, upper_value)
+		static constexpr std::size_t distance(const U lower_value, const U upper_value) { return std::size_t(UU(UU(upper_value) - UU(lower_value))); }
+
+		// Replaces the endpoints, moving them where the storage is a std::vector
+		void assign(std::vector<U>&& values) {
+			if constexpr (std::is_same_v<Storage, std::vector<U>>) _data = std::move(values);
+			else _data.assign(values.begin(), values.end());
+		}
+
+		// Writes the intervals of the bitmap to out
+		template <typename V>
+		void write_intervals(V& out) const {
+			out.clear();
+			out.reserve(2 * _side->runs);
+			for (std::size_t start = next_bit(0, true); start < _side->span; ) {
+				const std::size_t end = next_bit(start, false);
+				out.insert(out.end(), {value_of(start), U(value_of(end - 1) + 1)});
+				start = next_bit(end, true);
+			}
+		}
+
+		// Rebuilds the prefix sums for rank and select, if changed since; once, for any number of concurrent queries
+		void index() const {
+			if (!_side || _side->indexed.load(std::memory_order_acquire)) return;
+			std::lock_guard lock(_side->building);
+			if (_side->indexed.load(std::memory_order_relaxed)) return;
+			_side->prefix.clear();
+			_side->prefix.push_back(0);
+			if (bitmap())
+				for (const uint64_t word : _side->bits) _side->prefix.push_back(_side->prefix.back() + std::size_t(std::popcount(word)));
+			else
+				for (std::size_t i = 0; i + 1 < _data.size(); i += 2) _side->prefix.push_back(_side->prefix.back() + distance(_data[i], _data[i + 1]));
+			_side->indexed.store(true, std::memory_order_release);
+		}
+
+		// Rebuilds the Eytzinger layout for at least `search_threshold` endpoints, if changed since; as `index()`. O(n)
+		void search() const {
+			if (!_side || bitmap() || _data.size() < search_threshold || _side->searchable.load(std::memory_order_acquire)) return;
+			std::lock_guard lock(_side->building);
+			if (_side->searchable.load(std::memory_order_relaxed)) return;
+			_side->search.resize(_data.size() + 1);
+			_side->odd.assign(_data.size() + 1, 0);  // Node 0: no endpoint above, past the end
+			layout(1, 0);
+			_side->searchable.store(true, std::memory_order_release);
+		}
+
+		// Fills the subtree of node k in order from _data[i] on, returning the next i
+		std::size_t layout(const std::size_t k, std::size_t i) const {
+			if (k > _data.size()) return i;
+			i = layout(2 * k, i);
+			_side->search[k] = _data[i];
+			_side->odd[k] = uint8_t(i & 1);
+			return layout(2 * k + 1, i + 1);
+		}
 
 		/**
-		 * Find the range (Unsafe)
-		 * O(log(n))
+		 * Checks up to `search_group` items on the layout, one level for each per round (Unsafe)
+		 * Every descent takes the same bit_width(n) rounds; those past a leaf hold still. The first endpoint above the item
+		 * is then the node after removing the trailing right turns; the item is inside if that is an end.
 		 */
-		Range find_range(const U lower_value, const U upper_value) {
+		void search_batch(const T* items, bool* results, const std::size_t count) const {
+			const U* const tree = _side->search.data();
+			const std::size_t n = _data.size();
+			std::size_t k[search_group];
+			std::fill_n(k, count, std::size_t(1));
+			for (int level = std::bit_width(n); level > 0; --level)
+				for (std::size_t j = 0; j < count; ++j) {
+					__builtin_prefetch(tree + std::min(k[j] * search_prefetch, n));
+					const std::size_t next = 2 * k[j] + std::size_t(tree[std::min(k[j], n)] <= U(items[j]));
+					k[j] = (k[j] <= n) ? next : k[j];
+				}
+			for (std::size_t j = 0; j < count; ++j) results[j] = _side->odd[k[j] >> (std::countr_one(k[j]) + 1)];
+		}
 
-			// Last element not lesser than lower_value
-			auto lower_it = std::upper_bound(_data.begin(), _data.end(), lower_value)-1;
+		// Counts the values from scratch. O(n)
+		void recount() {
+			_count = 0;
+			if (bitmap())
+				for (const uint64_t word : _side->bits) _count += std::size_t(std::popcount(word));
+			else
+				for (std::size_t i = 0; i + 1 < _data.size(); i += 2) _count += distance(_data[i], _data[i + 1]);
+		}
 
-			// First element not greater than upper_value
-			auto upper_it = std::lower_bound(lower_it, _data.end(), upper_value);
+		static constexpr std::size_t interval_bytes(const std::size_t intervals) { return 2 * intervals * sizeof(U); }
+		// Bytes of a bitmap from `first` to `last`, saturating for spans no bitmap could hold
+		static constexpr std::size_t bitmap_bytes(const U first, const U last) {
+			const UU extent = UU(UU(last) - UU(first));
+			return (uint64_t(extent) >= (uint64_t(1) << 40)) ? SIZE_MAX : 8 * (std::size_t(extent >> 6) + 1);
+		}
+
+		constexpr std::size_t offset_of(const U value) const { return std::size_t(UU(UU(value) - UU(_side->base))); }
+		constexpr U value_of(const std::size_t offset) const { return U(UU(UU(_side->base) + UU(offset))); }
+		constexpr bool bit(const std::size_t offset) const { return (offset < _side->span) && ((_side->bits[offset >> 6] >> (offset & 63)) & 1); }
 
-			// Check if the iterators are at starts or ends of intervals based on index evenness
-			bool lower_is_start = !((lower_it - _data.begin()) & 1);
-			bool upper_is_end = ((upper_it - _data.begin()) & 1);
+		// The first offset from `offset` on whose bit is `value`, or the span
+		std::size_t next_bit(std::size_t offset, const bool value) const {
+			while (offset < _side->span) {
+				const uint64_t word = (value ? _side->bits[offset >> 6] : ~_side->bits[offset >> 6]) >> (offset & 63);
+				if (word) return std::min(_side->span, offset + std::size_t(std::countr_zero(word)));
+				offset = (offset | 63) + 1;
+			}
+			return _side->span;
+		}
 
-			// Case of lower touching other interval
-			if (!lower_is_start && (lower_value == *lower_it)) {
-				--lower_it; lower_is_start=true;
+		// Sets the bits of offsets [first, last] to `value`, counting the values and intervals changed
+		void fill(const std::size_t first, const std::size_t last, const bool value) {
+			// Only the bits from first to last + 1 can start or stop starting an interval
+			const std::size_t low = first >> 6, high = std::min((last + 1) >> 6, _side->bits.size() - 1);
+			_side->runs -= starts(low, high);
+			for (std::size_t word = first >> 6; word <= (last >> 6); ++word) {
+				uint64_t mask = ~uint64_t(0);
+				if (word == (first >> 6)) mask &= ~uint64_t(0) << (first & 63);
+				if (word == (last >> 6)) mask &= ~uint64_t(0) >> (63 - (last & 63));
+				const uint64_t updated = value ? (_side->bits[word] | mask) : (_side->bits[word] & ~mask);
+				_count = _count + std::size_t(std::popcount(updated)) - std::size_t(std::popcount(_side->bits[word]));
+				_side->bits[word] = updated;
 			}
+			_side->runs += starts(low, high);
+		}
 
-			return Range{lower_it, upper_it, lower_is_start, upper_is_end};
+		// Intervals starting in the words [first, last]: bits set without their lower neighbour
+		std::size_t starts(const std::size_t first, const std::size_t last) const {
+			std::size_t runs = 0;
+			uint64_t carry = (first > 0) ? (_side->bits[first - 1] >> 63) : 0;
+			for (std::size_t word = first; word <= last; ++word) {
+				runs += std::size_t(std::popcount(_side->bits[word] & ~((_side->bits[word] << 1) | carry)));
+				carry = _side->bits[word] >> 63;
+			}
+			return runs;
 		}
 
+		// Intervals in the bitmap
+		std::size_t count_runs() const { return _side->bits.empty() ? 0 : starts(0, _side->bits.size() - 1); }
+
 		/**
-		 * Insertion logic (Unsafe)
-		 * O(1)
+		 * After every change: drops the rank index and the search layout, allocates the side block once it is needed,
+		 * and switches representation when the other one is smaller (Unsafe)
+		 * O(1), or O(n) when switching
 		 */
-		void insertion_logic(const U lower_value, const U upper_value, Range range) {
+		void adapt() {
+			if (_side) {
+				_side->indexed.store(false, std::memory_order_relaxed);
+				_side->searchable.store(false, std::memory_order_relaxed);
+			}
+			else if (_data.size() >= search_threshold) make_side();
+			if (bitmap()) {
+				if (2 * interval_bytes(_side->runs) < 8 * _side->bits.size()) to_intervals();
+			}
+			else if (!_data.empty() && bitmap_bytes(_data.front(), U(_data.back() - 1)) < interval_bytes(_data.size() / 2))
+				to_bitmap(_data.front(), U(_data.back() - 1));
+		}
+
+		// Allocates an empty side block from the allocator of _data
+		void make_side() {
+			Rebind<Side> alloc(get_allocator());
+			Side* side = SideTraits::allocate(alloc, 1);
+			try { SideTraits::construct(alloc, side, get_allocator()); }
+			catch (...) { SideTraits::deallocate(alloc, side, 1); throw; }
+			_side = side;
+		}
+		void copy_side(const Side& other) {
+			make_side();
+			*_side = other;
+		}
+		void release() {
+			if (!_side) return;
+			Rebind<Side> alloc(get_allocator());
+			SideTraits::destroy(alloc, _side);
+			SideTraits::deallocate(alloc, _side, 1);
+			_side = nullptr;
+		}
+
+		// Moves the values into a bitmap from `first` to `last`, which should cover them
+		void to_bitmap(const U first, const U last) {
+			if (!_side) make_side();
+			Storage values(get_allocator());
+			if (bitmap()) write_intervals(values);
+			else values = std::move(_data);
+			_side->base = first;
+			_side->span = std::size_t(UU(UU(last) - UU(first))) + 1;
+			_side->bits.assign((_side->span + 63) >> 6, 0);
+			_count = 0;  // Counted again by the fills
+			_side->runs = 0;
+			for (std::size_t i = 0; i+1 < values.size(); i += 2)
+				if (values[i] != values[i+1]) fill(offset_of(values[i]), offset_of(U(values[i+1] - 1)), true);
+			_data.clear();
+			_side->bitmap = true;
+		}
 
-			// Case of upper touching other interval
-			if (!range.upper_is_end && range.upper_it != _data.end() && (upper_value == *range.upper_it)) {
-				++range.upper_it; range.upper_is_end=true;
+		void to_intervals() {
+			write_intervals(_data);
+			_side->bits.clear();
+			_side->span = 0;
+			_side->runs = 0;
+			_side->bitmap = false;
+		}
+
+		/**
+		 * Widens the bitmap in place to cover [first, last], which may already be covered (Unsafe)
+		 * Upward it grows into the capacity of the words. Downward it moves the words up, with as many words again of headroom
+		 * below while the bitmap stays under the switch back to intervals, so inserts past either end are amortized O(1).
+		 * O(n) only when the whole words below run out at the bottom of the range of U: then it is rebuilt.
+		 */
+		void grow(const U first, const U last) {
+			if (last > value_of(_side->span - 1)) {
+				_side->span += distance(value_of(_side->span - 1), last);
+				_side->bits.resize((_side->span + 63) >> 6);
 			}
+			if (first < _side->base) {
+				const std::size_t needed = (distance(first, _side->base) + 63) >> 6;
+				const std::size_t room = distance(std::numeric_limits<U>::min(), _side->base) >> 6;
+				if (needed > room) return to_bitmap(first, value_of(_side->span - 1));
+				const std::size_t allowed = interval_bytes(_side->runs) / 4;  // Words, see adapt()
+				const std::size_t headroom = std::min({_side->bits.size(), room - needed, (allowed > _side->bits.size() + needed) ? allowed - _side->bits.size() - needed : 0});
+				const std::size_t words = needed + headroom;
+				_side->bits.insert(_side->bits.begin(), words, 0);
+				_side->base = U(UU(UU(_side->base) - UU(64 * words)));
+				_side->span += 64 * words;
+			}
+		}
 
-			// Case of whole interval being inside empty region
-			if ((range.upper_it - range.lower_it == 1) && !range.lower_is_start) {
-				_data.insert(range.upper_it, {lower_value, upper_value});
-				return;
+		/**
+		 * Bitmap insertion (Unsafe)
+		 * O(1) for one value inside the bitmap or next to it, amortized; O(k / 64) for a range of k values
+		 */
+		void bitmap_insert(const U value) {
+			const std::size_t offset = offset_of(value);
+			if (offset >= _side->span) return bitmap_insert(value, value);
+			if (bit(offset)) return;
+			// Joins the intervals on either side
+			_side->runs = _side->runs + 1 - std::size_t(offset > 0 && bit(offset - 1)) - std::size_t(bit(offset + 1));
+			_side->bits[offset >> 6] |= uint64_t(1) << (offset & 63);
+			++_count;
+		}
+
+		void bitmap_insert(const U lower_value, const U upper_value) {
+			if (offset_of(lower_value) >= _side->span || offset_of(upper_value) >= _side->span) {
+				const U first = std::min(_side->base, lower_value), last = std::max(value_of(_side->span - 1), upper_value);
+				// Only grow while the bitmap stays smaller than the intervals would be
+				if (bitmap_bytes(first, last) >= interval_bytes(_side->runs + 1)) {
+					to_intervals();
+					return insert(T(lower_value), T(upper_value));
+				}
+				grow(first, last);
 			}
+			fill(offset_of(lower_value), offset_of(upper_value), true);
+		}
 
-			// Force alignment
-			range.lower_it += !range.lower_is_start;
-			range.upper_it -= !range.upper_is_end;
+		/**
+		 * Bitmap erasure (Unsafe)
+		 * O(1) for one value, O(k / 64) for a range of k values
+		 */
+		void bitmap_erase(const U value) {
+			const std::size_t offset = offset_of(value);
+			if (!bit(offset)) return;
+			// Splits the interval around it
+			_side->runs = _side->runs + std::size_t(offset > 0 && bit(offset - 1)) + std::size_t(bit(offset + 1)) - 1;
+			_side->bits[offset >> 6] &= ~(uint64_t(1) << (offset & 63));
+			--_count;
+		}
 
-			// Modify values
-			*range.lower_it = std::min(*range.lower_it, lower_value);
-			*range.upper_it = std::max(*range.upper_it, upper_value);
+		void bitmap_erase(const U lower_value, const U upper_value) {
+			const U first = std::max(_side->base, lower_value), last = std::min(value_of(_side->span - 1), upper_value);
+			if (first > last) return;
+			fill(offset_of(first), offset_of(last), false);
+		}
 
-			// Erase any gaps in the interval
-			if (range.upper_it - range.lower_it > 1) _data.erase(range.lower_it+1, range.upper_it);
+		/**
+		 * Sweep over the endpoints of a and b in order, tracking whether each value is inside either set (Unsafe)
+		 * Calls step(value, in_a, in_b) after every distinct endpoint; stops early if it returns false.
+		 * O(n+m)
+		 */
+		template <typename Step>
+		static void sweep(const U* a, const std::size_t na, const U* b, const std::size_t nb, Step&& step) {
+			std::size_t i=0, j=0;
+			bool in_a=false, in_b=false;
+			while (i<na || j<nb) {
+				const U value = (j>=nb || (i<na && a[i] < b[j])) ? a[i] : b[j];
+				// Equal endpoints toggle twice, so touching and empty intervals fall out
+				for (; i<na && a[i] == value; ++i) in_a = !in_a;
+				for (; j<nb && b[j] == value; ++j) in_b = !in_b;
+				if (!step(value, in_a, in_b)) return;
+			}
+		}
+
+		// The endpoints, copied into `scratch` from a bitmap
+		std::span<const U> endpoints(Storage& scratch) const {
+			if (!bitmap()) return {_data.data(), _data.size()};
+			write_intervals(scratch);
+			return {scratch.data(), scratch.size()};
+		}
+
+		/**
+		 * Writes the endpoints of op(a, b) to out, which should have room for na + nb (Unsafe)
+		 * Returns the number written. Never more than have been read, so out may trail the unread part of a.
+		 * O(n+m)
+		 */
+		template <typename Op>
+		static std::size_t merge(const U* a, const std::size_t na, const U* b, const std::size_t nb, U* out, Op op) {
+			std::size_t written = 0;
+			bool inside = false;
+			sweep(a, na, b, nb, [&](const U value, const bool in_a, const bool in_b) {
+				if (bool(op(uint64_t(in_a), uint64_t(in_b)) & 1) != inside) { out[written++] = value; inside = !inside; }
+				return true;
+			});
+			return written;
+		}
+
+		// The 64 bits from bit `start` on, zero outside the bitmap
+		static uint64_t bits_at(std::span<const uint64_t> bits, const int64_t start) {
+			const int64_t word = (start >= 0) ? (start >> 6) : -((63 - start) >> 6);
+			const int shift = int(start - word * 64);
+			auto at = [&](const int64_t i) { return (i >= 0 && i < int64_t(bits.size())) ? bits[std::size_t(i)] : uint64_t(0); };
+			return shift ? ((at(word) >> shift) | (at(word + 1) << (64 - shift))) : at(word);
 		}
 
 		/**
-		 * Erasure logic (Unsafe)
-		 * O(1)
+		 * op(a, b) of two bitmaps, word by word over the window covering both (Unsafe)
+		 * O(n+m)
 		 */
-		void erasure_logic(const U lower_value, const U upper_value, Range range) {
+		template <typename Op>
+		static unlock_map bitmap_merged(const unlock_map& a, const unlock_map& b, Op op) {
+			unlock_map result(a.get_allocator());
+			result.make_side();
+			const U first = std::min(a._side->base, b._side->base), last = std::max(a.value_of(a._side->span - 1), b.value_of(b._side->span - 1));
+			result._side->base = first;
+			result._side->span = std::size_t(UU(UU(last) - UU(first))) + 1;
+			result._side->bits.resize((result._side->span + 63) >> 6);
+			// Bit i of the result is bit i - shift of the operand
+			const int64_t shift_a = int64_t(UU(UU(a._side->base) - UU(first))), shift_b = int64_t(UU(UU(b._side->base) - UU(first)));
+			for (std::size_t w = 0; w < result._side->bits.size(); ++w)
+				result._side->bits[w] = uint64_t(op(bits_at(a._side->bits, int64_t(64 * w) - shift_a), bits_at(b._side->bits, int64_t(64 * w) - shift_b)));
+			// Bits past the span stay clear
+			if (result._side->span & 63) result._side->bits.back() &= ~uint64_t(0) >> (64 - (result._side->span & 63));
+			result._side->runs = result.count_runs();
+			result._side->bitmap = true;
+			result.recount();
+			result.adapt();
+			return result;
+		}
 
-			// Case of upper touching other interval
-			if (!range.upper_is_end && range.upper_it != _data.end() && (upper_value == *range.upper_it)) {
-				++range.upper_it; range.upper_is_end=true;
+		// op(a, b) into a new map
+		template <typename Op>
+		static unlock_map merged(const unlock_map& a, const unlock_map& b, Op op) {
+			if (a.bitmap() && b.bitmap()) return bitmap_merged(a, b, op);
+			Storage scratch_a(a.get_allocator()), scratch_b(a.get_allocator());
+			const std::span<const U> ea = a.endpoints(scratch_a), eb = b.endpoints(scratch_b);
+			unlock_map result(a.get_allocator());
+			result._data.resize(ea.size() + eb.size());
+			result._data.resize(merge(ea.data(), ea.size(), eb.data(), eb.size(), result._data.data(), op));
+			result.recount();
+			result.adapt();
+			return result;
+		}
+
+		/**
+		 * *this = op(*this, other), merged in place (Unsafe)
+		 * The endpoints of *this move to the back of _data, and the output is written from the front.
+		 * O(n+m)
+		 */
+		template <typename Op>
+		unlock_map& combine(const unlock_map& other, Op op) {
+			if (bitmap() && other.bitmap()) return *this = bitmap_merged(*this, other, op);
+			Storage scratch(get_allocator());
+			if (&other == this) {
+				scratch.assign(_data.begin(), _data.end());
+				return combine(std::span<const U>(scratch.data(), scratch.size()), op);
 			}
+			return combine(other.endpoints(scratch), op);
+		}
 
-			// Case of whole interval being inside empty region
-			if ((range.upper_it - range.lower_it == 1) && range.lower_is_start) {
-				_data.insert(range.upper_it, {lower_value, upper_value});
+		// *this = op(*this, endpoints), merged in place (Unsafe)
+		template <typename Op>
+		unlock_map& combine(std::span<const U> b, Op op) {
+			if (bitmap()) to_intervals();
+
+			const std::size_t n = _data.size(), m = b.size();
+			_data.resize(n + m);
+			std::move_backward(_data.begin(), _data.begin() + n, _data.end());
+			_data.resize(merge(_data.data() + m, n, b.data(), m, _data.data(), op));
+			recount();
+			adapt();
+			return *this;
+		}
+
+		// The endpoints of the runs of the values, sorted and coalesced
+		static std::vector<U> runs_of(std::span<const T> items) {
+			std::vector<U> values(items.size());
+			std::transform(items.begin(), items.end(), values.begin(), [](const T item) { return U(item); });
+			std::sort(values.begin(), values.end());
+			std::vector<U> result;
+			for (std::size_t i = 0; i < values.size(); ) {
+				const U start = values[i];
+				U end = U(start + 1);
+				// Duplicates, and the value after the end, extend the run
+				for (++i; i < values.size() && (values[i] == end || values[i] == U(end - 1)); ++i)
+					if (values[i] == end) end = U(end + 1);
+				result.insert(result.end(), {start, end});
+			}
+			return result;
+		}
+
+		// The endpoints of the ranges [first, second], sorted and coalesced where they overlap or touch
+		static std::vector<U> runs_of(std::span<const std::pair<T, T>> ranges) {
+			std::vector<std::pair<U, U>> intervals;
+			intervals.reserve(ranges.size());
+			for (const auto& [first, last] : ranges)
+				if (!(last < first)) intervals.emplace_back(U(first), U(U(last) + 1));
+			std::sort(intervals.begin(), intervals.end());
+			std::vector<U> result;
+			for (const auto& [start, end] : intervals) {
+				if (!result.empty() && start <= result.back()) result.back() = std::max(result.back(), end);
+				else result.insert(result.end(), {start, end});
+			}
+			return result;
+		}
+
+		// Inserts sorted, coalesced runs, see `insert_batch`
+		void insert_runs(const std::vector<U>& runs) {
+			if (bitmap() && !runs.empty()) {
+				const U first = std::min(_side->base, runs.front()), last = std::max(value_of(_side->span - 1), U(runs.back() - 1));
+				if (bitmap_bytes(first, last) < interval_bytes(_side->runs + runs.size() / 2)) {
+					grow(first, last);
+					for (std::size_t i = 0; i + 1 < runs.size(); i += 2) fill(offset_of(runs[i]), offset_of(U(runs[i + 1] - 1)), true);
+					return adapt();
+				}
+			}
+			combine(std::span<const U>(runs), [](auto a, auto b) { return a | b; });
+		}
+
+		// Erases sorted, coalesced runs, see `erase_batch`
+		void erase_runs(const std::vector<U>& runs) {
+			if (!bitmap()) {
+				combine(std::span<const U>(runs), [](auto a, auto b) { return a & ~b; });
 				return;
 			}
+			for (std::size_t i = 0; i + 1 < runs.size(); i += 2) bitmap_erase(runs[i], U(runs[i + 1] - 1));
+			adapt();
+		}
+
+		// Whether pred(in this, in other) holds for any value
+		template <typename Pred>
+		bool any(const unlock_map& other, Pred pred) const {
+			Storage scratch_a(get_allocator()), scratch_b(get_allocator());
+			const std::span<const U> a = endpoints(scratch_a), b = other.endpoints(scratch_b);
+			bool found = false;
+			sweep(a.data(), a.size(), b.data(), b.size(), [&](const U, const bool in_a, const bool in_b) {
+				found = pred(in_a, in_b);
+				return !found;
+			});
+			return found;
+		}
+
+		/**
+		 * Replace the endpoints in [first, last) by the given ones (Unsafe)
+		 * O(n) for the move of the tail
+		 */
+		void splice(const std::size_t first, const std::size_t last, std::initializer_list<U> values) {
+			const auto begin = _data.begin() + first;
+			const std::size_t kept = std::min(last - first, values.size());
+			std::copy_n(values.begin(), kept, begin);
+			if (kept < last - first) _data.erase(begin + kept, _data.begin() + last);
+			else _data.insert(begin + kept, values.begin() + kept, values.end());
+		}
+
+		/**
+		 * Values of [lower_value, upper_value) in the set, walking the endpoints [first, last) within it (Unsafe)
+		 * O(last - first), the endpoints about to be spliced out
+		 */
+		std::size_t covered(std::size_t first, const std::size_t last, bool inside, const U lower_value, const U upper_value) const {
+			std::size_t sum = 0;
+			U position = lower_value;
+			for (; first < last; ++first, inside = !inside) {
+				if (inside) sum += distance(position, _data[first]);
+				position = _data[first];
+			}
+			if (inside) sum += distance(position, upper_value);
+			return sum;
+		}
+
+		/**
+		 * Insertion logic for [lower_value, upper_value)
+		 * O(log(n))
+		 */
+		void insertion_logic(const U lower_value, const U upper_value) {
+
+			// Endpoints within [lower_value, upper_value], touching ones included, merge into the new interval
+			const std::size_t first = std::lower_bound(_data.begin(), _data.end(), lower_value) - _data.begin();
+			const std::size_t last = std::upper_bound(_data.begin() + first, _data.end(), upper_value) - _data.begin();
+
+			// An odd index is the end of an interval reaching over the value
+			const bool lower_inside = first & 1;
+			const bool upper_inside = last & 1;
+			_count += distance(lower_value, upper_value) - covered(first, last, lower_inside, lower_value, upper_value);
+
+			if (lower_inside && upper_inside) splice(first, last, {});
+			else if (lower_inside) splice(first, last, {upper_value});
+			else if (upper_inside) splice(first, last, {lower_value});
+			else splice(first, last, {lower_value, upper_value});
+		}
+
+		/**
+		 * Erasure logic for [lower_value, upper_value)
+		 * O(log(n))
+		 */
+		void erasure_logic(const U lower_value, const U upper_value) {
 
-			// Force alignment
-			range.lower_it += range.lower_is_start;
-			range.upper_it -= range.upper_is_end;
+			// Endpoints strictly within (lower_value, upper_value) are removed
+			std::size_t first = std::upper_bound(_data.begin(), _data.end(), lower_value) - _data.begin();
+			std::size_t last = std::lower_bound(_data.begin() + first, _data.end(), upper_value) - _data.begin();
 
-			// Modify values
-			*range.lower_it = std::min(*range.lower_it, lower_value);
-			*range.upper_it = std::max(*range.upper_it, upper_value);
+			// An odd index is the end of an interval reaching over the value; cut it there, unless that leaves it empty
+			bool lower_inside = first & 1;
+			bool upper_inside = last & 1;
+			_count -= covered(first, last, lower_inside, lower_value, upper_value);
+			if (lower_inside && _data[first-1] == lower_value) { --first; lower_inside = false; }
+			if (upper_inside && _data[last] == upper_value) { ++last; upper_inside = false; }
 
-			// Erase any gaps in the interval
-			if (range.upper_it - range.lower_it > 1) _data.erase(range.lower_it+1, range.upper_it);
+			if (lower_inside && upper_inside) splice(first, last, {lower_value, upper_value});
+			else if (lower_inside) splice(first, last, {lower_value});
+			else if (upper_inside) splice(first, last, {upper_value});
+			else splice(first, last, {});
 		}
 
 
 	};
 
 
+	// unlock_map with a polymorphic allocator, e.g. over an arena
+	namespace pmr {
+		template <typename T, std::size_t N = 0>
+		using unlock_map = dattatypes::unlock_map<T, N, std::pmr::polymorphic_allocator<std::underlying_type_t<T>>>;
+	}; // namespace pmr
 
 }; // namespace dattatypes
@@ -0,0 +1 @@
+#include "column_file.hpp"
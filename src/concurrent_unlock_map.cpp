@@ -0,0 +1 @@
+#include "concurrent_unlock_map.hpp"
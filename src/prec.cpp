@@ -1,2 +1,13 @@
 #include "prec.hpp"
 #include "prec_utils.hpp"
+#include "prec_batch.hpp"
+#include "prec_linalg.hpp"
+#include "prec_complex.hpp"
+#include "prec_fft.hpp"
+#include "prec_quat.hpp"
+#include "prec_random.hpp"
+#include "prec_text.hpp"
+#include "prec_reduce.hpp"
+#include "prec_filter.hpp"
+#include "prec_divisor.hpp"
+#include "prec_lut.hpp"
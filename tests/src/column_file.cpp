@@ -0,0 +1,84 @@
+#include <iostream>
+#include <vector>
+#include <random>
+#include <string>
+#include <algorithm>
+#include <cstdio>
+
+#include "debug.hpp"
+#include "column_file.hpp"
+
+static constexpr auto src = "column_file:TEST";
+using namespace std;
+using namespace dattatypes;
+
+enum class Permission : uint16_t { NONE = 0, READ = 1, WRITE = 2, EXECUTE = 4 };
+
+
+// Testing
+int main() {
+    LOG_INFO("=== Beginning Tests for column_file ===");
+
+    int num=0;
+    mt19937_64 rng(15);
+    const string path = "column_file_test.cols";
+
+    vector<prec32> prices(100003);
+    for (auto& p : prices) p._data = int32_t(rng());
+    vector<unit8> weights(77);
+    for (auto& w : weights) w._data = int8_t(rng());
+    vector<Flags<Permission>> permissions(5000);
+    for (auto& p : permissions) p = Permission(rng() & 7);
+
+    LOG_WARN("Test {} - Streaming write in chunks", ++num);
+    {
+        ColumnWriter writer(path);
+        writer.column<prec32>("price");
+        for (size_t first = 0; first < prices.size(); first += 4096)
+            writer.append<prec32>(span(prices).subspan(first, std::min<size_t>(4096, prices.size() - first)));
+        writer.column<unit8>("weight");
+        writer.append<unit8>(weights);
+        writer.column<Flags<Permission>>("permission");
+        writer.append<Flags<Permission>>(span(permissions).first(1000));
+        writer.append<Flags<Permission>>(span(permissions).subspan(1000));
+        writer.column<prec16>("empty");
+    }
+
+    LOG_WARN("Test {} - Mapped views", ++num);
+    ColumnFile file(path);
+    runtime_assert(file.columns().size(), 4, "columns");
+    const auto read_prices = file.prec<prec32>("price");
+    const auto read_weights = file.prec<unit8>("weight");
+    const auto read_permissions = file.flags<Permission>("permission");
+    runtime_assert(std::ranges::equal(read_prices, prices), true, "price values");
+    runtime_assert(std::ranges::equal(read_weights, weights), true, "weight values");
+    runtime_assert(std::ranges::equal(read_permissions, permissions, {}, &Flags<Permission>::underlying, &Flags<Permission>::underlying), true, "permission values");
+    runtime_assert(file.prec<prec16>("empty").size(), 0, "empty column");
+    runtime_assert((reinterpret_cast<uintptr_t>(read_weights.data()) % column_alignment), 0, "aligned column");
+    runtime_assert(file.prec<saturating<prec32>>("price").size(), prices.size(), "another overflow policy");
+    ColumnFile moved = std::move(file);
+    runtime_assert((moved.prec<prec32>("price").data() == read_prices.data()), true, "moved without copying");
+
+    LOG_WARN("Test {} - Errors", ++num);
+    bool threw = false;
+    try { moved.prec<u_prec32>("price"); } catch (const runtime_error&) { threw = true; }
+    runtime_assert(threw, true, "read with another type");
+    threw = false;
+    try { moved.prec<prec32>("missing"); } catch (const runtime_error&) { threw = true; }
+    runtime_assert(threw, true, "read a missing column");
+    threw = false;
+    try {
+        ColumnWriter writer(path + ".bad");
+        writer.column<prec32>("price");
+        writer.append<prec16>(vector<prec16>(3));
+    } catch (const runtime_error&) { threw = true; }
+    runtime_assert(threw, true, "append another type");
+    threw = false;
+    if (FILE* truncated = fopen((path + ".bad").c_str(), "wb")) { fputs("DTCOLS", truncated); fclose(truncated); }
+    try { ColumnFile bad(path + ".bad"); } catch (const runtime_error&) { threw = true; }
+    runtime_assert(threw, true, "read a truncated file");
+
+    remove(path.c_str());
+    remove((path + ".bad").c_str());
+    return 0;
+}
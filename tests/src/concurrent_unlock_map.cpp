@@ -0,0 +1,107 @@
+#include <iostream>
+#include <string>
+#include <vector>
+#include <thread>
+#include <atomic>
+
+#include "debug.hpp"
+#include "concurrent_unlock_map.hpp"
+
+static constexpr auto src = "concurrent_unlock_map:TEST";
+using namespace std;
+using namespace dattatypes;
+
+
+enum class Item : int32_t {};
+
+
+// Testing
+int main() {
+    LOG_INFO("=== Beginning Tests for concurrent_unlock_map ===");
+
+    int num=0;
+
+    LOG_WARN("Test {} - Single thread", ++num);
+    concurrent_unlock_map<Item> unlocks;
+    runtime_assert(unlocks.empty(), true, "empty");
+    unlocks.insert(Item(5));
+    unlocks.insert(Item(10), Item(19));
+    unlocks.erase(Item(12));
+    runtime_assert((unlocks.check(Item(5)) && unlocks.check(Item(10)) && !unlocks.check(Item(12))), true, "check");
+    runtime_assert(unlocks.size(), 10, "size");
+    unlocks.update([](auto& map) { map.erase(Item(5)); map.insert(Item(6)); });
+    runtime_assert((unlocks.load().intervals() == vector<int32_t>{6, 7, 10, 12, 13, 20}), true, "update");
+    runtime_assert(unlocks.retired(), 0, "nothing held, all freed");
+
+    LOG_WARN("Test {} - Snapshots", ++num);
+    {
+        const auto before = unlocks.snapshot();
+        unlocks.clear();
+        runtime_assert((before->check(Item(6)) && before->size() == 10), true, "snapshot unchanged by writes");
+        runtime_assert(unlocks.empty(), true, "new readers see the write");
+        runtime_assert((unlocks.retired() >= 1), true, "held version kept");
+        const auto after = unlocks.snapshot();
+        runtime_assert((after->empty() && before->rank(Item(11)) == 2), true, "both versions readable");
+    }
+    unlocks.reclaim();
+    runtime_assert(unlocks.retired(), 0, "freed once released");
+
+    LOG_WARN("Test {} - Readers against a writer", ++num);
+    // Every version is a run of 100 values [k, k + 100) and one value at 10000 + k; readers verify that on snapshots
+    concurrent_unlock_map<Item> shared;
+    shared.update([](auto& map) { map.insert(Item(0), Item(99)); map.insert(Item(10000)); });
+    atomic<bool> done{false};
+    atomic<size_t> reads{0}, torn{0};
+    vector<thread> readers;
+    const size_t reader_count = std::max(4u, thread::hardware_concurrency());
+    for (size_t r = 0; r < reader_count; ++r)
+        readers.emplace_back([&, r] {
+            size_t local = 0, bad = 0;
+            for (int32_t i = int32_t(r); !done.load(memory_order_relaxed) || local < 1000; ++i, ++local) {
+                const auto version = shared.snapshot();
+                const int32_t k = int32_t(version->select(0));
+                bad += (version->size() != 101) + !version->check(Item(k + 99)) + version->check(Item(k + 100));
+                bad += !version->check(Item(10000 + k)) + (int32_t(version->select(100)) != 10000 + k);
+                bad += shared.check(Item(i % 20000)) && shared.size() != 101;
+            }
+            reads += local;
+            torn += bad;
+        });
+    for (int32_t k = 1; k <= 2000; ++k) {
+        shared.update([k](auto& map) {
+            map.erase(Item(k - 1));
+            map.insert(Item(k + 99));
+            map.erase(Item(10000 + k - 1));
+            map.insert(Item(10000 + k));
+        });
+        if (k % 64 == 0) this_thread::yield();
+    }
+    done = true;
+    for (auto& reader : readers) reader.join();
+    LOG_INFO("{} readers, {} snapshots read", reader_count, reads.load());
+    runtime_assert(torn.load(), 0, "no torn or freed versions");
+    runtime_assert(int32_t(shared.snapshot()->select(0)), 2000, "last version");
+    shared.reclaim();
+    runtime_assert(shared.retired(), 0, "all retired versions freed");
+
+    LOG_WARN("Test {} - More snapshots than reader slots", ++num);
+    {
+        const size_t slots = unlocks.reader_slots();
+        unlocks.insert(Item(1));
+        vector<concurrent_unlock_map<Item>::Snapshot> held;
+        for (size_t i = 0; i < 2 * slots + 1; ++i) held.push_back(unlocks.snapshot());
+        runtime_assert((unlocks.reader_slots() >= 2 * slots + 1), true, "tables appended");
+        unlocks.insert(Item(2));
+        runtime_assert((held.back()->size() == 1 && unlocks.size() == 2 && unlocks.retired() == 1), true, "all pinned");
+        held.clear();
+        unlocks.reclaim();
+        runtime_assert(unlocks.retired(), 0, "freed once released");
+        const size_t grown = unlocks.reader_slots();
+        for (size_t i = 0; i < 2 * slots + 1; ++i) held.push_back(unlocks.snapshot());
+        runtime_assert(unlocks.reader_slots(), grown, "freed slots reused");
+    }
+
+
+    LOG_INFO("=== All tests for concurrent_unlock_map passed! ===\n\n");
+    return 0;
+}
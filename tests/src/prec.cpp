@@ -1,5 +1,8 @@
 
 #include <iostream>
+#include <random>
+#include <cmath>
+#include <string>
 
 #include "debug.hpp"
 #include "prec_utils.hpp"
@@ -9,6 +12,92 @@ using namespace std;
 using namespace dattatypes;
 
 
+// Radians of a raw angle, reduced to [-pi, pi] before scaling to keep the reference exact
+template <PrecType Angle>
+long double radians(const Angle angle) {
+    constexpr int bits = 8 * sizeof(typename Angle::value_type);
+    long double turns = ldexpl((long double)angle._data, 1 - bits);
+    return (turns - nearbyintl(turns)) * 2 * acosl(-1.0L);
+}
+
+// Largest error of sincos in ULP, against libm in long double
+template <PrecType Angle, PrecType Slope = Angle>
+long double sincos_max_ulp(size_t samples, mt19937_64& rng) {
+    long double max_error = 0;
+    for (size_t i = 0; i < samples; ++i) {
+        Angle angle;
+        angle._data = typename Angle::value_type(rng());
+        const auto [s, c] = sincos<Slope>(angle);
+        const long double rad = radians(angle), limit = numeric_limits<typename Slope::value_type>::max();
+        const long double s_ref = min(ldexpl(sinl(rad), -Slope::_n), limit), c_ref = min(ldexpl(cosl(rad), -Slope::_n), limit);
+        max_error = max({max_error, fabsl(s._data - s_ref), fabsl(c._data - c_ref)});
+    }
+    return max_error;
+}
+
+// Largest error of atan2, asin and acos in ULP, against libm in long double
+template <PrecType T>
+long double inverse_max_ulp(size_t samples, mt19937_64& rng) {
+    using V = typename T::value_type;
+    constexpr int bits = 8 * sizeof(V);
+    const long double scale = ldexpl(1.0L, bits - 2) / acosl(-1.0L);
+    long double max_error = 0;
+    for (size_t i = 0; i < samples; ++i) {
+        T y, x, s;
+        y._data = V(rng()); x._data = V(rng()); s._data = V(rng()) / 2; // s in [-0.5, 0.5)
+        const long double v = ldexpl((long double)s._data, T::_n);
+        max_error = max({max_error,
+            fabsl(atan2(y, x)._data - atan2l((long double)y._data, (long double)x._data) * scale),
+            fabsl(asin(s)._data - asinl(v) * scale),
+            fabsl(acos(s)._data - acosl(v) * scale)});
+    }
+    return max_error;
+}
+
+// Check that sqrt returns the floor of the exact root, and that rsqrt rounds to nearest
+template <PrecType T>
+void check_roots(const string& name, size_t samples, mt19937_64& rng) {
+    using V = typename T::value_type;
+    bool floors = true;
+    long double max_error = 0;
+    for (size_t i = 0; i < samples; ++i) {
+        T value;
+        value._data = V(rng() >> (rng() % (8 * sizeof(V)))); // Spread over all magnitudes
+        if (value._data <= 0) continue;
+        const long double real = ldexpl((long double)value._data, T::_n);
+        const long double root = ldexpl(sqrtl(real), -T::_n), inverse = ldexpl(1 / sqrtl(real), -T::_n);
+        floors &= (sqrt(value)._data <= root) && (sqrt(value)._data + 1 > root);
+        if (inverse < numeric_limits<V>::max())
+            max_error = max(max_error, fabsl(rsqrt(value)._data - inverse));
+    }
+    runtime_assert(floors, true, "sqrt<" + name + ">");
+    runtime_assert(max_error <= 0.5, true, "rsqrt<" + name + ">");
+}
+
+// Largest error of exp2, log2, exp, log and pow in ULP over [lo, hi], against libm in long double
+template <PrecType T>
+long double exp_log_max_ulp(size_t samples, long double lo, long double hi, mt19937_64& rng) {
+    using V = typename T::value_type;
+    const long double limit_lo = numeric_limits<V>::min(), limit_hi = numeric_limits<V>::max();
+    const auto ulp_error = [&](const T result, const long double exact) {
+        return fabsl(result._data - clamp(ldexpl(exact, -T::_n), limit_lo, limit_hi));
+    };
+    uniform_real_distribution<long double> dist(lo, hi);
+    const T exponent(1.7);
+    long double max_error = 0;
+    for (size_t i = 0; i < samples; ++i) {
+        T x;
+        x._data = V(llroundl(ldexpl(dist(rng), -T::_n)));
+        const long double v = ldexpl((long double)x._data, T::_n);
+        max_error = max({max_error, ulp_error(exp2(x), exp2l(v)), ulp_error(exp(x), expl(v))});
+        if (x._data > 0)
+            max_error = max({max_error, ulp_error(log2(x), log2l(v)), ulp_error(log(x), logl(v)),
+                             ulp_error(pow(x, exponent), powl(v, (long double)double(exponent)))});
+    }
+    return max_error;
+}
+
+
 // Testing
 int main() {
     LOG_INFO("=== Beginning Tests for Prec ===");
@@ -74,10 +163,152 @@ int main() {
     static_assert(!(prec8(5.3).approx(5)), "Approximation failed step 3");
     static_assert(!(prec8(5).fapprox(5.3)), "Approximation failed step 4");
 
+    // Rounding of negative products, integer only
+    static_assert(prec32(-1000.5) * prec32(3000.25) == prec32(-3001750.125), "Negative product failed");
+    static_assert(int(prec16(-2.75)) == -2, "Negative conversion failed");
+    static_assert(unit32(-0.25)._data == -(1 << 29) && u_unit32(0.5)._data == (1u << 31), "Full-width unit scaling failed");
+
+    // 64-bit products, wrapping
+    static_assert(unit64(0.5) * unit64(0.5) == unit64(0.25), "64-bit multiplication failed step 1");
+    static_assert(unit64(-0.5) * unit64(0.75) == unit64(-0.375), "64-bit multiplication failed step 2");
+    static_assert(u_unit64(0.5) * u_unit64(0.5) == u_unit64(0.25), "64-bit multiplication failed step 3");
+    static_assert(angle64(0.5) * angle64(0.5) == angle64(0.25), "64-bit multiplication failed step 4");
+    static_assert(prob64(1.5) * prob64(0.5) == prob64(0.75), "64-bit multiplication failed step 5");
+    static_assert(prec64(1e5) * prec64(1e5) == prec64(1e10), "64-bit multiplication failed step 6");
+    static_assert(u_prec64(3e6) * u_prec64(-2e6 + 3e6) == u_prec64(3e12), "64-bit multiplication failed step 7");
+    static_assert((prec64(1e8) * prec64(2e6))._data == int64_t(uint64_t(2e14) << 16), "64-bit multiplication wrap failed");
+    {
+        using floor32 = Prec<int32_t, -8, Rounding::floor>;
+        using nearest32 = Prec<int32_t, -8, Rounding::nearest>;
+        constexpr auto raw = []<PrecType P>(P, int32_t data) { P p; p._data = data; return p; };
+        static_assert((raw(prec32(), -192) * raw(prec32(), 1))._data == 0, "Rounding toward zero failed");
+        static_assert((raw(floor32(), -192) * raw(floor32(), 1))._data == -1, "Rounding toward floor failed");
+        static_assert((raw(nearest32(), -192) * raw(nearest32(), 1))._data == -1, "Rounding to nearest failed step 1");
+        static_assert((raw(nearest32(), -128) * raw(nearest32(), 1))._data == 0, "Rounding to nearest failed step 2");
+        static_assert(int(floor32(-2.75)) == -3, "Floor conversion failed");
+        static_assert(int(nearest32(-2.75)) == -3, "Nearest conversion failed");
+    }
+
+    // Exponentials and logarithms
+    static_assert(exp2(prec32(3)) == prec32(8), "Exp2 failed step 1");
+    static_assert(exp2(prec32(-2)) == prec32(0.25), "Exp2 failed step 2");
+    static_assert(exp2(prec16(100))._data == INT16_MAX, "Exp2 saturation failed");
+    static_assert(log2(prec32(1024)) == prec32(10), "Log2 failed step 1");
+    static_assert(log2(unit32(0.5)) == unit32(-1), "Log2 failed step 2");
+    static_assert(log2(prec16(0))._data == INT16_MIN, "Log2 of zero failed");
+    static_assert(exp(prec32(0)) == prec32(1), "Exp failed");
+    static_assert(log(prec32(1)) == prec32(0), "Log failed");
+    static_assert(pow(prec32(2), prec32(10)) == prec32(1024), "Pow failed step 1");
+    static_assert(pow(prec64(81), prec64(0.25)) == prec64(3), "Pow failed step 2");
+    static_assert(pow(prec32(0), prec32(2)) == prec32(0), "Pow failed step 3");
+    static_assert(lerp(prec32(2), prec32(4), unit16(0.5)) == prec32(3), "Lerp failed step 1");
+    static_assert(lerp(prec32(-8), prec32(8), u_unit8(0.25)) == prec32(-4), "Lerp failed step 2");
+    static_assert(lerp(prec64(-1000.0), prec64(1000.0), u_unit64(0.75)) == prec64(500), "Lerp failed step 3");
+    static_assert(lerp(u_prec64(0), u_prec64(1e9), prob64(1.5)) == u_prec64(1.5e9), "Lerp failed step 4");
+    static_assert(lerp(prec64(-4e9), prec64(4e9), prob64(0.25)) == prec64(-2e9), "Lerp failed step 5");
+
+    // Overflow policies
+    static_assert(prec8(31) + prec8(1) == prec8(-32), "Wrapping sum failed");
+    static_assert(saturating<prec8>(31) + saturating<prec8>(1) == saturating<prec8>(31.75), "Saturating sum failed");
+    static_assert(saturating<prec8>(-31) - saturating<prec8>(2) == saturating<prec8>(-32), "Saturating difference failed");
+    static_assert(saturating<u_prec16>(1) - saturating<u_prec16>(2) == saturating<u_prec16>(0), "Saturating unsigned difference failed");
+    static_assert((saturating<prec32>(-8000000) * saturating<prec32>(3))._data == INT32_MIN, "Saturating product failed step 1");
+    static_assert((saturating<unit32>(-1) * saturating<unit32>(-1))._data == INT32_MAX, "Saturating product failed step 2");
+    static_assert((saturating<prec64>(1e14) * saturating<prec64>(1e14))._data == INT64_MAX, "Saturating product failed step 3");
+    static_assert(-saturating<prec16>(-2048) == saturating<prec16>(2047.9375), "Saturating negation failed");
+    static_assert(saturating<prec8>(100)._data == INT8_MAX, "Saturating construction failed");
+    static_assert((saturating<prec32>(8000000) + 1e9)._data == INT32_MAX, "Saturating float sum failed");
+    static_assert((saturating<prec32>(8000000) + 1e30)._data == INT32_MAX, "Saturating float sum failed past int64");
+    static_assert(saturating<u_prec16>(1) - 2.0 == saturating<u_prec16>(0), "Saturating unsigned float difference failed");
+    static_assert((saturating<prec8>(20) * 10.0)._data == INT8_MAX, "Saturating float product failed");
+    static_assert((saturating<prec64>(-1e14) * 1e10)._data == INT64_MIN, "Saturating float product failed step 2");
+    static_assert((saturating<prec8>(20) / 0.01)._data == INT8_MAX, "Saturating float quotient failed");
+    static_assert(saturating<prec8>(1e300)._data == INT8_MAX, "Saturating float construction failed");
+    static_assert((prec8(31) + 1.0) == prec8(-32), "Wrapping float sum failed");
+    static_assert(u_unit64(0.75)._data == 0xC000000000000000 && (u_unit64(0.5) + 0.25) == 0.75, "Unsigned 64-bit float conversion failed");
+
     // Square Root
     static_assert(sqrt(prec32(81)) == prec32(9), "Square Root failed step 1");
     constexpr int x = 834;
     static_assert(sqrt(prec32(x*x)) == prec32(x), "Square Root failed step 2");
+    static_assert(sqrt(prec8(2.25)) == prec8(1.5), "Square Root failed step 3");
+    static_assert(sqrt(u_prec16(169)) == u_prec16(13), "Square Root failed step 4");
+    static_assert(sqrt(prec64(1 << 20)) == prec64(1 << 10), "Square Root failed step 5");
+    static_assert(sqrt(unit16(0.25)) == unit16(0.5), "Square Root failed step 6");
+    static_assert(rsqrt(prec32(4)) == prec32(0.5), "Reciprocal Square Root failed step 1");
+    static_assert(rsqrt(u_prec64(0.0625)) == u_prec64(4), "Reciprocal Square Root failed step 2");
+    static_assert(hypot(prec32(3), prec32(-4)) == prec32(5), "Hypotenuse failed step 1");
+    static_assert(hypot(prec16(-5), prec16(12)) == prec16(13), "Hypotenuse failed step 2");
+
+    // Trigonometry (angles count half turns)
+    static_assert(sin(angle32(0.0)) == angle32(0.0), "Sine failed step 1");
+    static_assert(sin(angle32(0.5)) == angle32(1.0), "Sine failed step 2");
+    static_assert(sin(angle16(-0.5)) == angle16(-1.0), "Sine failed step 3");
+    static_assert(sin(angle8(1.5)) == angle8(-1.0), "Sine failed step 4");
+    static_assert(cos(angle32(1.0)) == angle32(-1.0), "Cosine failed step 1");
+    static_assert(cos(angle64(0.0)) == angle64(1.0), "Cosine failed step 2");
+    static_assert(cos(angle16(0.5)) == angle16(0.0), "Cosine failed step 3");
+    static_assert(sin(angle32(-1.75)) == sin(angle32(0.25)), "Sine wrap-around failed");
+    static_assert(sin<unit16>(angle16(0.5))._data == 32767, "Sine saturation failed");
+    static_assert(atan2(prec32(1), prec32(1)) == angle32(0.25), "Atan2 failed step 1");
+    static_assert(atan2(prec32(0), prec32(-3)) == angle32(1.0), "Atan2 failed step 2");
+    static_assert(atan2(prec32(-2), prec32(0)) == angle32(-0.5), "Atan2 failed step 3");
+    static_assert(asin(unit32(0.0)) == angle32(0.0), "Asin failed");
+    static_assert(acos(unit16(0.0)) == angle16(0.5), "Acos failed");
+
+    int num=0;
+    mt19937_64 rng(7);
+
+    LOG_WARN("Test {} - Sine and cosine error in ULP", ++num);
+    runtime_assert(sincos_max_ulp<angle8>(1 << 8, rng) <= 1, true, "sincos<angle8>");
+    runtime_assert(sincos_max_ulp<angle16>(1 << 16, rng) <= 1, true, "sincos<angle16>");
+    runtime_assert(sincos_max_ulp<angle32>(1 << 18, rng) <= 1, true, "sincos<angle32>");
+    runtime_assert((sincos_max_ulp<angle32, unit32>(1 << 18, rng) <= 1), true, "sincos<angle32, unit32>");
+    runtime_assert(sincos_max_ulp<angle64>(1 << 16, rng) <= 2, true, "sincos<angle64>");
+
+    LOG_WARN("Test {} - Atan2, asin and acos error in ULP", ++num);
+    runtime_assert(inverse_max_ulp<unit8>(1 << 12, rng) <= 1, true, "inverse<unit8>");
+    runtime_assert(inverse_max_ulp<unit16>(1 << 16, rng) <= 1, true, "inverse<unit16>");
+    runtime_assert(inverse_max_ulp<unit32>(1 << 16, rng) <= 1, true, "inverse<unit32>");
+    runtime_assert(inverse_max_ulp<unit64>(1 << 14, rng) <= 2, true, "inverse<unit64>");
+
+    LOG_WARN("Test {} - Exp2, log2, exp, log and pow error in ULP", ++num);
+    runtime_assert(exp_log_max_ulp<prec8>(1 << 12, -8, 5, rng) <= 1, true, "exp_log<prec8>");
+    runtime_assert(exp_log_max_ulp<prec16>(1 << 16, -16, 10, rng) <= 1, true, "exp_log<prec16>");
+    runtime_assert(exp_log_max_ulp<prec32>(1 << 16, -30, 15, rng) <= 1, true, "exp_log<prec32>");
+    runtime_assert(exp_log_max_ulp<prec64>(1 << 14, -40, 30, rng) <= 1, true, "exp_log<prec64>");
+    runtime_assert(exp_log_max_ulp<unit32>(1 << 16, -1, 0.99, rng) <= 1, true, "exp_log<unit32>");
+    runtime_assert(exp_log_max_ulp<unit64>(1 << 14, -1, 0.99, rng) <= 1, true, "exp_log<unit64>");
+    runtime_assert(exp_log_max_ulp<u_prec32>(1 << 16, 0, 15, rng) <= 1, true, "exp_log<u_prec32>");
+
+    LOG_WARN("Test {} - Square root is exact and reciprocal square root rounds to nearest", ++num);
+    check_roots<prec8>("prec8", 1 << 16, rng);
+    check_roots<prec16>("prec16", 1 << 16, rng);
+    check_roots<prec32>("prec32", 1 << 16, rng);
+    check_roots<prec64>("prec64", 1 << 16, rng);
+    check_roots<u_prec32>("u_prec32", 1 << 16, rng);
+    check_roots<u_prec64>("u_prec64", 1 << 16, rng);
+    check_roots<unit32>("unit32", 1 << 16, rng);
+
+    LOG_WARN("Test {} - Checked arithmetic traps in debug builds", ++num);
+    bool trapped = false;
+    try { const auto sum = checked<prec32>(8000000) + checked<prec32>(8000000); (void)sum; } catch (const overflow_error&) { trapped = true; }
+#ifdef NDEBUG
+    runtime_assert(trapped, false, "trapped");
+#else
+    runtime_assert(trapped, true, "trapped");
+#endif
+    int float_traps = 0;
+    try { const auto sum = checked<prec32>(8000000) + 1e6; (void)sum; } catch (const overflow_error&) { ++float_traps; }
+    try { const auto sum = checked<prec32>(0) + 1e30; (void)sum; } catch (const overflow_error&) { ++float_traps; }
+    try { auto product = checked<prec32>(8000000); product *= 1e6; } catch (const overflow_error&) { ++float_traps; }
+    try { const auto quotient = checked<u_prec16>(100) / -1.0; (void)quotient; } catch (const overflow_error&) { ++float_traps; }
+    try { const checked<prec16> constructed(1e300); (void)constructed; } catch (const overflow_error&) { ++float_traps; }
+#ifdef NDEBUG
+    runtime_assert(float_traps, 0, "float operators trapped");
+#else
+    runtime_assert(float_traps, 5, "float operators trapped");
+#endif
 
     LOG_INFO("=== All tests for Prec passed! ===\n\n");
     return 0;
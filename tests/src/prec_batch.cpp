@@ -0,0 +1,181 @@
+#include <iostream>
+#include <vector>
+#include <random>
+#include <string>
+
+#include "debug.hpp"
+#include "prec_batch.hpp"
+
+static constexpr auto src = "prec_batch:TEST";
+using namespace std;
+using namespace dattatypes;
+
+
+// Random raw values, bounded so the scalar reference operators never overflow a signed type.
+template <PrecType P>
+vector<P> random_precs(size_t n, mt19937_64& rng, bool nonzero = false) {
+    using T = typename P::value_type;
+    constexpr int bits = 8 * sizeof(T);
+    constexpr int shift = (bits == 8 && is_unsigned_v<T>) ? 8 : (bits <= 16) ? bits - 1 : bits / 2 - 1;
+    constexpr int64_t bound = int64_t(1) << shift;
+    uniform_int_distribution<int64_t> dist(is_signed_v<T> ? -bound : 0, bound - 1);
+
+    vector<P> values(n);
+    for (auto& value : values) {
+        do value._data = T(dist(rng)); while (nonzero && value._data == 0);
+    }
+    return values;
+}
+
+template <PrecType P>
+size_t mismatches(const vector<P>& batch, const vector<P>& scalar) {
+    size_t count = 0;
+    for (size_t i = 0; i < batch.size(); ++i)
+        count += (batch[i]._data != scalar[i]._data);
+    return count;
+}
+
+// Compare every batch operation against the scalar operators
+template <PrecType P>
+void check_against_scalar(const string& name, mt19937_64& rng) {
+    const size_t n = 1000 + 7; // Leaves a scalar tail for every register width
+    const auto a = random_precs<P>(n, rng), b = random_precs<P>(n, rng, true), c = random_precs<P>(n, rng);
+    const P lo = a[0] < a[1] ? a[0] : a[1], hi = a[0] < a[1] ? a[1] : a[0];
+    vector<P> batch(n), scalar(n);
+
+    add<P>(a, b, batch);
+    for (size_t i = 0; i < n; ++i) scalar[i] = a[i] + b[i];
+    runtime_assert(mismatches(batch, scalar), 0, "add<" + name + ">");
+
+    add<P>(a, b[0], batch);
+    for (size_t i = 0; i < n; ++i) scalar[i] = a[i] + b[0];
+    runtime_assert(mismatches(batch, scalar), 0, "add<" + name + "> of one value");
+
+    sub<P>(a, b, batch);
+    for (size_t i = 0; i < n; ++i) scalar[i] = a[i] - b[i];
+    runtime_assert(mismatches(batch, scalar), 0, "sub<" + name + ">");
+
+    mul<P>(a, b, batch);
+    for (size_t i = 0; i < n; ++i) scalar[i] = a[i] * b[i];
+    runtime_assert(mismatches(batch, scalar), 0, "mul<" + name + ">");
+
+    div<P>(a, b, batch);
+    for (size_t i = 0; i < n; ++i) scalar[i] = a[i] / b[i];
+    runtime_assert(mismatches(batch, scalar), 0, "div<" + name + ">");
+
+    fma<P>(a, b, c, batch);
+    for (size_t i = 0; i < n; ++i) scalar[i] = a[i] * b[i] + c[i];
+    runtime_assert(mismatches(batch, scalar), 0, "fma<" + name + ">");
+
+    clamp<P>(a, lo, hi, batch);
+    for (size_t i = 0; i < n; ++i) scalar[i] = (a[i] < lo) ? lo : ((a[i] > hi) ? hi : a[i]);
+    runtime_assert(mismatches(batch, scalar), 0, "clamp<" + name + ">");
+}
+
+// Compare the overflowing batch operations against the scalar operators, over the full raw range
+template <PrecType P>
+void check_overflow_against_scalar(const string& name, mt19937_64& rng) {
+    using T = typename P::value_type;
+    const size_t n = 1000 + 7;
+    vector<P> a(n), b(n), c(n), batch(n), scalar(n);
+    for (size_t i = 0; i < n; ++i) { a[i]._data = T(rng()); b[i]._data = T(rng()); c[i]._data = T(rng()); }
+
+    add<P>(a, b, batch);
+    for (size_t i = 0; i < n; ++i) scalar[i] = a[i] + b[i];
+    runtime_assert(mismatches(batch, scalar), 0, "add<" + name + ">");
+
+    add<P>(a, b[0], batch);
+    for (size_t i = 0; i < n; ++i) scalar[i] = a[i] + b[0];
+    runtime_assert(mismatches(batch, scalar), 0, "add<" + name + "> of one value");
+
+    sub<P>(a, b, batch);
+    for (size_t i = 0; i < n; ++i) scalar[i] = a[i] - b[i];
+    runtime_assert(mismatches(batch, scalar), 0, "sub<" + name + ">");
+
+    mul<P>(a, b, batch);
+    for (size_t i = 0; i < n; ++i) scalar[i] = a[i] * b[i];
+    runtime_assert(mismatches(batch, scalar), 0, "mul<" + name + ">");
+
+    fma<P>(a, b, c, batch);
+    for (size_t i = 0; i < n; ++i) scalar[i] = a[i] * b[i] + c[i];
+    runtime_assert(mismatches(batch, scalar), 0, "fma<" + name + ">");
+}
+
+
+// Testing
+int main() {
+    LOG_INFO("=== Beginning Tests for prec_batch ===");
+
+    int num=0;
+    mt19937_64 rng(42);
+
+    LOG_WARN("Test {} - Batch matches scalar for signed types", ++num);
+    check_against_scalar<prec8>("prec8", rng);
+    check_against_scalar<prec16>("prec16", rng);
+    check_against_scalar<prec32>("prec32", rng);
+    check_against_scalar<prec64>("prec64", rng);
+    check_against_scalar<unit8>("unit8", rng);
+    check_against_scalar<unit16>("unit16", rng);
+    check_against_scalar<unit32>("unit32", rng);
+    check_against_scalar<angle32>("angle32", rng);
+
+    LOG_WARN("Test {} - Batch matches scalar for unsigned types", ++num);
+    check_against_scalar<u_prec8>("u_prec8", rng);
+    check_against_scalar<u_prec16>("u_prec16", rng);
+    check_against_scalar<u_prec32>("u_prec32", rng);
+    check_against_scalar<u_prec64>("u_prec64", rng);
+    check_against_scalar<u_unit8>("u_unit8", rng);
+    check_against_scalar<u_unit16>("u_unit16", rng);
+    check_against_scalar<prob32>("prob32", rng);
+
+    LOG_WARN("Test {} - Batch matches scalar for every rounding", ++num);
+    check_against_scalar<Prec<int16_t, -4, Rounding::floor>>("floor16", rng);
+    check_against_scalar<Prec<int32_t, -8, Rounding::nearest>>("nearest32", rng);
+    check_against_scalar<Prec<int64_t, -16, Rounding::nearest>>("nearest64", rng);
+
+    LOG_WARN("Test {} - Batch matches scalar when overflowing", ++num);
+    check_overflow_against_scalar<prec16>("prec16", rng);
+    check_overflow_against_scalar<saturating<prec8>>("saturating<prec8>", rng);
+    check_overflow_against_scalar<saturating<prec16>>("saturating<prec16>", rng);
+    check_overflow_against_scalar<saturating<prec32>>("saturating<prec32>", rng);
+    check_overflow_against_scalar<saturating<prec64>>("saturating<prec64>", rng);
+    check_overflow_against_scalar<saturating<u_prec16>>("saturating<u_prec16>", rng);
+    check_overflow_against_scalar<saturating<u_prec32>>("saturating<u_prec32>", rng);
+    check_overflow_against_scalar<saturating<unit32>>("saturating<unit32>", rng);
+
+    LOG_WARN("Test {} - In-place batch", ++num);
+    vector<prec32> values = {prec32(1.5), prec32(-2), prec32(0.25)};
+    mul<prec32>(values, values, values);
+    runtime_assert(double(values[0]), 2.25, "1.5 * 1.5");
+    runtime_assert(double(values[1]), 4.0, "-2 * -2");
+    runtime_assert(double(values[2]), 0.0625, "0.25 * 0.25");
+
+    LOG_WARN("Test {} - Batch roots", ++num);
+    vector<prec32> roots(3), legs = {prec32(3), prec32(5), prec32(8)};
+    sqrt<prec32>(values, roots);
+    runtime_assert(double(roots[0]), 1.5, "sqrt(2.25)");
+    rsqrt<prec32>(values, roots);
+    runtime_assert(double(roots[2]), 4.0, "rsqrt(0.0625)");
+    hypot<prec32>(legs, vector<prec32>{prec32(4), prec32(12), prec32(15)}, roots);
+    runtime_assert(double(roots[1]), 13.0, "hypot(5, 12)");
+    runtime_assert(double(roots[2]), 17.0, "hypot(8, 15)");
+
+    LOG_WARN("Test {} - Batch exponentials", ++num);
+    vector<prec32> powers(3);
+    exp2<prec32, prec32>(legs, powers);
+    runtime_assert(double(powers[0]), 8.0, "exp2(3)");
+    log2<prec32, prec32>(powers, powers);
+    runtime_assert(double(powers[2]), 8.0, "log2(2^8)");
+    pow<prec32, prec32, prec32>(legs, vector<prec32>{prec32(2), prec32(0.5), prec32(1)}, powers);
+    runtime_assert(double(powers[0]), 9.0, "pow(3, 2)");
+    lerp<prec32, unit16>(legs, vector<prec32>{prec32(5), prec32(7), prec32(0)}, vector<unit16>(3, unit16(0.5)), powers);
+    runtime_assert(double(powers[1]), 6.0, "lerp(5, 7, 0.5)");
+
+    LOG_WARN("Test {} - Mismatched sizes throw", ++num);
+    bool threw = false;
+    try { add<prec32>(values, vector<prec32>(2), values); } catch (const runtime_error&) { threw = true; }
+    runtime_assert(threw, true, "threw");
+
+    LOG_INFO("=== All tests for prec_batch passed! ===\n\n");
+    return 0;
+}
@@ -0,0 +1,115 @@
+#include <iostream>
+#include <vector>
+#include <random>
+#include <string>
+#include <ratio>
+
+#include "debug.hpp"
+#include "prec_divisor.hpp"
+
+static constexpr auto src = "prec_divisor:TEST";
+using namespace std;
+using namespace dattatypes;
+
+
+// Every value of 8 and 16-bit types, random values and the extremes of wider ones
+template <PrecType P>
+vector<P> test_values(mt19937_64& rng) {
+    using T = typename P::value_type;
+    vector<P> values;
+    if constexpr (sizeof(T) <= 2)
+        for (int64_t v = numeric_limits<T>::min(); v <= numeric_limits<T>::max(); ++v) values.emplace_back(P()), values.back()._data = T(v);
+    else {
+        values.resize(100003);
+        for (auto& v : values) v._data = T(rng() >> (rng() % (8 * sizeof(T))));
+        for (const T extreme : {numeric_limits<T>::min(), T(numeric_limits<T>::min() + 1), T(0), T(1), numeric_limits<T>::max(), T(numeric_limits<T>::max() - 1)})
+            values.emplace_back(P()), values.back()._data = extreme;
+    }
+    return values;
+}
+
+// div_by<C> against the operator, in scalar and batch
+template <auto C, PrecType P>
+size_t check_div_by(const vector<P>& values) {
+    vector<P> out(values.size());
+    div_by<C, P>(values, out);
+    size_t mismatches = 0;
+    for (size_t i = 0; i < values.size(); ++i) {
+        if (std::cmp_equal(C, -1) && values[i]._data == numeric_limits<typename P::value_type>::min())
+            continue;  // Overflows, and is undefined for the operator on int and wider
+        const P expected = values[i] / C;
+        mismatches += (div_by<C>(values[i]) != expected) + (out[i] != expected);
+    }
+    return mismatches;
+}
+
+template <PrecType P, auto... C>
+void check_divisors(const string& name, mt19937_64& rng) {
+    const vector<P> values = test_values<P>(rng);
+    const size_t mismatches = (check_div_by<C>(values) + ...);
+    runtime_assert(mismatches, 0, "div_by for " + name);
+}
+
+// mul_by<R> against the exact product and quotient in 128 bits, narrowed by the type
+template <typename R, PrecType P>
+size_t check_mul_by(const vector<P>& values) {
+    using T = typename P::value_type;
+    vector<P> out(values.size());
+    mul_by<R, P>(values, out);
+    size_t mismatches = 0;
+    for (size_t i = 0; i < values.size(); ++i) {
+        const detail::int128_t exact = detail::int128_t(values[i]._data) * R::num / R::den;
+        P expected;
+        expected._data = P::narrow(std::conditional_t<std::is_signed_v<T>, detail::int128_t, detail::uint128_t>(exact));
+        mismatches += (mul_by<R>(values[i]) != expected) + (out[i] != expected);
+    }
+    return mismatches;
+}
+
+template <PrecType P, typename... R>
+void check_ratios(const string& name, mt19937_64& rng) {
+    const vector<P> values = test_values<P>(rng);
+    const size_t mismatches = (check_mul_by<R>(values) + ...);
+    runtime_assert(mismatches, 0, "mul_by for " + name);
+}
+
+
+// Testing
+int main() {
+    LOG_INFO("=== Beginning Tests for prec_divisor ===");
+
+    int num=0;
+    mt19937_64 rng(16);
+
+    LOG_WARN("Test {} - div_by is the operator", ++num);
+    check_divisors<prec8, 1, 2, 3, 5, 7, 10, 60, 64, 100, 127, -1, -3, -7, -64, -128>("prec8", rng);
+    check_divisors<u_prec8, 1, 3, 7, 10, 64, 100, 255>("u_prec8", rng);
+    check_divisors<prec16, 1, 3, 5, 7, 10, 60, 641, 1000, 1024, 32767, -1, -3, -7, -1000, -32768>("prec16", rng);
+    check_divisors<u_unit16, 1, 3, 7, 10, 60, 641, 1000, 1024, 65535>("u_unit16", rng);
+    check_divisors<prec32, 1, 3, 7, 10, 60, 641, 1000000, 65536, 2147483647, -1, -7, -1000000, int32_t(-2147483647 - 1)>("prec32", rng);
+    check_divisors<u_prec32, 1, 3, 7, 10, 60, 641, 1000000, 65536, 4294967295u>("u_prec32", rng);
+    check_divisors<prec64, 1, 3, 7, 10, 60, 641, 1000000007, int64_t(1) << 40, INT64_MAX, -1, -7, -1000000007>("prec64", rng);
+    check_divisors<u_prec64, 1, 3, 7, 10, 60, 641, 1000000007, uint64_t(1) << 40, UINT64_MAX>("u_prec64", rng);
+    check_divisors<saturating<unit16>, 3, -5>("saturating<unit16>", rng);
+
+    LOG_WARN("Test {} - mul_by is exact", ++num);
+    check_ratios<prec8, ratio<1, 3>, ratio<2, 3>, ratio<-5, 7>, ratio<100, 1>, ratio<3, 64>>("prec8", rng);
+    check_ratios<u_prec16, ratio<1, 3>, ratio<7, 10>, ratio<60, 1000>, ratio<255, 2>>("u_prec16", rng);
+    check_ratios<saturating<prec16>, ratio<5, 3>, ratio<-99, 7>>("saturating<prec16>", rng);
+    check_ratios<prec32, ratio<1, 3>, ratio<-7, 10>, ratio<60, 1000>, ratio<1000003, 1000033>>("prec32", rng);
+    check_ratios<u_unit32, ratio<1, 60>, ratio<2147483647, 2147483646>>("u_unit32", rng);
+    check_ratios<saturating<prec32>, ratio<3, 2>, ratio<-1000, 3>>("saturating<prec32>", rng);
+    check_ratios<prec64, ratio<1, 3>, ratio<-7, 10>, ratio<1000003, 1000033>>("prec64", rng);
+    check_ratios<u_prec64, ratio<1, 60>, ratio<5, 4>>("u_prec64", rng);
+
+    LOG_WARN("Test {} - reciprocal", ++num);
+    runtime_assert(prec32::reciprocal<3>()._data, 85, "prec32 1/3 truncated");
+    runtime_assert((Prec<int32_t, -8, Rounding::nearest>::reciprocal<3>()._data), 85, "prec32 1/3 to nearest");
+    runtime_assert((Prec<int32_t, -8, Rounding::nearest>::reciprocal<-3>()._data), -85, "prec32 -1/3 to nearest");
+    runtime_assert((Prec<int32_t, -8, Rounding::floor>::reciprocal<-3>()._data), -86, "prec32 -1/3 floored");
+    runtime_assert((Prec<int32_t, -8, Rounding::nearest>::reciprocal<512>()._data), 1, "prec32 1/512 ties up");
+    runtime_assert(u_unit64::reciprocal<3>()._data, UINT64_MAX / 3, "u_unit64 1/3");
+    runtime_assert(saturating<unit16>::reciprocal<1>()._data, INT16_MAX, "unit16 1/1 saturates");
+    runtime_assert((Prec<int32_t, 4>::reciprocal<1>()._data), 0, "1 / 1 in steps of 16");
+    return 0;
+}
@@ -0,0 +1,133 @@
+#include <iostream>
+#include <vector>
+#include <random>
+#include <string>
+#include <cmath>
+#include <complex>
+#include <numbers>
+
+#include "debug.hpp"
+#include "prec_fft.hpp"
+
+static constexpr auto src = "prec_fft:TEST";
+using namespace std;
+using namespace dattatypes;
+
+template <PrecType P> using cplx = dattatypes::complex<P>;
+
+
+// Fused complex arithmetic in constant evaluation
+static_assert(cplx<prec32>(1, 2) * cplx<prec32>(3, -1) == cplx<prec32>(5, 5));
+static_assert(cplx<prec32>(1.5, -2) + cplx<prec32>(0.5, 1) == cplx<prec32>(2, -1));
+static_assert(conj(cplx<prec32>(1, 2)) == cplx<prec32>(1, -2));
+static_assert(norm(cplx<prec32>(3, -4)) == prec32(25));
+static_assert(abs(cplx<prec32>(3, -4)) == prec32(5));
+static_assert(dattatypes::polar(angle32(0.5)) == cplx<angle32>(0, 1));
+// Rounded once: 1/256 * 1/2 - (-1/256 * 1/2) is 1/256, where the Prec operators would give 0
+static_assert((cplx<prec32>(0.00390625, -0.00390625) * cplx<prec32>(0.5, 0.5)).real() == prec32(0.00390625));
+
+
+// Reference DFT in double, on the raw values
+template <PrecType P>
+vector<std::complex<double>> reference_dft(const vector<cplx<P>>& x, const bool inverse) {
+    const size_t n = x.size();
+    vector<std::complex<double>> out(n);
+    for (size_t k = 0; k < n; ++k) {
+        std::complex<double> sum = 0;
+        for (size_t j = 0; j < n; ++j) {
+            const double angle = (inverse ? 2 : -2) * std::numbers::pi * double((j * k) % n) / double(n);
+            sum += std::complex<double>(double(x[j]._re._data), double(x[j]._im._data)) * std::polar(1.0, angle);
+        }
+        out[k] = inverse ? sum / double(n) : sum;
+    }
+    return out;
+}
+
+template <PrecType P>
+vector<cplx<P>> random_signal(size_t n, mt19937_64& rng) {
+    using T = typename P::value_type;
+    // Magnitudes up to 1.0 of the raw range
+    uniform_real_distribution<double> radius(0.0, 1.0), angle(0.0, 2 * std::numbers::pi);
+    vector<cplx<P>> x(n);
+    for (auto& z : x) {
+        const auto c = std::polar(radius(rng) * double(numeric_limits<T>::max()), angle(rng));
+        z._re._data = T(c.real());
+        z._im._data = T(c.imag());
+    }
+    return x;
+}
+
+// Largest error against the double DFT, in units of the last place of the per-stage scaled output
+template <PrecType P>
+double fft_error(size_t n, FFTScaling scaling, bool inverse, mt19937_64& rng) {
+    vector<cplx<P>> x = random_signal<P>(n, rng);
+    const auto expected = reference_dft<P>(x, inverse);
+
+    const FFT<P> fft(n, scaling);
+    const int exponent = inverse ? fft.inverse(x) : fft.forward(x);
+    double worst = 0;
+    for (size_t k = 0; k < n; ++k) {
+        const std::complex<double> got(std::ldexp(double(x[k]._re._data), exponent), std::ldexp(double(x[k]._im._data), exponent));
+        worst = max(worst, std::abs(got - expected[k]));
+    }
+    return inverse ? worst : worst / double(n);
+}
+
+template <PrecType P>
+void check_fft(const string& name, mt19937_64& rng, double max_ulp) {
+    for (size_t n : {1, 2, 4, 8, 32, 64, 512, 1024}) {
+        const double forward = fft_error<P>(n, FFTScaling::per_stage, false, rng);
+        const double inverse = fft_error<P>(n, FFTScaling::per_stage, true, rng);
+        const double floating = fft_error<P>(n, FFTScaling::block_floating, false, rng);
+        runtime_assert((forward <= max_ulp && inverse <= max_ulp && floating <= max_ulp), true,
+                       "FFT<" + name + "> of " + to_string(n) + " within " + to_string(max_ulp) + " ULP");
+    }
+}
+
+
+// Testing
+int main() {
+    LOG_INFO("=== Beginning Tests for prec_fft ===");
+
+    int num=0;
+    mt19937_64 rng(3);
+
+    LOG_WARN("Test {} - Complex arithmetic", ++num);
+    cplx<unit32> a(0.5, -0.25), b(0.25, 0.5);
+    runtime_assert(double((a * b).real()), 0.25, "(a * b).real");
+    runtime_assert(double((a * b).imag()), 0.1875, "(a * b).imag");
+    runtime_assert(double(abs(cplx<prec64>(5, 12))), 13.0, "abs(5 + 12i)");
+
+    LOG_WARN("Test {} - FFT matches the double DFT", ++num);
+    check_fft<unit16>("unit16", rng, 2.0);
+    check_fft<unit32>("unit32", rng, 2.0);
+
+    LOG_WARN("Test {} - Impulse and constant", ++num);
+    const FFT<unit32> fft(16);
+    vector<cplx<unit32>> impulse(16);
+    impulse[0] = cplx<unit32>(0.5);
+    runtime_assert(fft.forward(impulse), 4, "forward exponent");
+    size_t flat = 0;
+    for (const auto& z : impulse) flat += (z == cplx<unit32>(0.03125));
+    runtime_assert(flat, size_t(16), "impulse transforms to a constant");
+    runtime_assert(fft.inverse(impulse), 0, "inverse exponent");
+    runtime_assert(double(impulse[0].real()), 0.03125, "inverse of the constant");
+
+    LOG_WARN("Test {} - Round trip", ++num);
+    vector<cplx<unit32>> signal = random_signal<unit32>(256, rng), original = signal;
+    const FFT<unit32> floating(256, FFTScaling::block_floating);
+    const int e1 = floating.forward(signal);
+    const int e2 = floating.inverse(signal);
+    int64_t worst = 0;
+    for (size_t i = 0; i < signal.size(); ++i) {
+        const int64_t back = int64_t(std::ldexp(double(signal[i]._re._data), e1 + e2));
+        worst = max(worst, std::abs(back - int64_t(original[i]._re._data)));
+    }
+    runtime_assert(worst <= (int64_t(1) << 8), true, "block floating round trip");
+
+    LOG_WARN("Test {} - Errors", ++num);
+    bool threw = false;
+    try { FFT<unit16> bad(12); } catch (const std::runtime_error&) { threw = true; }
+    runtime_assert(threw, true, "size not a power of two threw");
+    return 0;
+}
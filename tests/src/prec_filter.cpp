@@ -0,0 +1,162 @@
+#include <iostream>
+#include <vector>
+#include <random>
+#include <string>
+#include <cmath>
+#include <numbers>
+
+#include "debug.hpp"
+#include "prec_filter.hpp"
+
+static constexpr auto src = "prec_filter:TEST";
+using namespace std;
+using namespace dattatypes;
+
+using q30 = Prec<int32_t, -30>;
+
+
+template <PrecType P>
+vector<P> random_values(const size_t n, mt19937_64& rng, const int bits = 8 * sizeof(typename P::value_type)) {
+    vector<P> values(n);
+    for (auto& v : values) v._data = typename P::value_type(int64_t(rng()) >> (64 - bits));
+    return values;
+}
+
+// y[i] = sum_k h[k] x[i - k], exact, then rounded to nearest and saturated
+template <PrecType P, PrecType C>
+vector<P> convolve(const vector<P>& x, const vector<C>& h) {
+    using T = typename P::value_type;
+    vector<P> y(x.size());
+    for (size_t i = 0; i < x.size(); ++i) {
+        detail::int128_t sum = 0;
+        for (size_t k = 0; k < h.size() && k <= i; ++k) sum += detail::int128_t(h[k]._data) * x[i - k]._data;
+        sum = (sum + (detail::int128_t(1) << (-C::_n - 1))) >> -C::_n;
+        y[i]._data = T(std::clamp<detail::int128_t>(sum, numeric_limits<T>::min(), numeric_limits<T>::max()));
+    }
+    return y;
+}
+
+// Feeds `x` through `process` in blocks of random sizes, collecting the outputs
+template <typename Process>
+void in_blocks(const size_t n, mt19937_64& rng, Process&& process) {
+    uniform_int_distribution<size_t> size(0, 3000);
+    for (size_t first = 0; first < n; ) {
+        const size_t count = std::min(size(rng), n - first);
+        process(first, count);
+        first += count;
+    }
+}
+
+// A FIR against the exact convolution, in one call and in blocks
+template <PrecType P, PrecType C>
+void check_fir(const string& name, const vector<C>& taps, mt19937_64& rng) {
+    const vector<P> x = random_values<P>(10000, rng);
+    const vector<P> expected = convolve(x, taps);
+    FIR<P, C> whole(taps), blocks(taps);
+    vector<P> y(x.size()), z(x.size());
+    whole.process(x, y);
+    in_blocks(x.size(), rng, [&](size_t first, size_t count) {
+        blocks.process(span(x).subspan(first, count), span(z).subspan(first, count));
+    });
+    runtime_assert((y == expected && z == expected), true, "FIR<" + name + ">");
+}
+
+
+// Testing
+int main() {
+    LOG_INFO("=== Beginning Tests for prec_filter ===");
+
+    int num=0;
+    mt19937_64 rng(13);
+
+    LOG_WARN("Test {} - FIR is the exact convolution, rounded once", ++num);
+    check_fir<unit16, unit16>("unit16, small taps", random_values<unit16>(64, rng, 10), rng);      // 32-bit sums
+    check_fir<unit16, unit16>("unit16, large taps", random_values<unit16>(64, rng), rng);          // 64-bit sums
+    check_fir<unit16, q30>("unit16, q30", random_values<q30>(31, rng), rng);
+    check_fir<unit32, unit32>("unit32, small taps", random_values<unit32>(17, rng, 24), rng);
+    check_fir<unit32, unit32>("unit32, large taps", random_values<unit32>(17, rng), rng);          // 128-bit sums
+    check_fir<prec16, unit8>("prec16, unit8", random_values<unit8>(5, rng), rng);
+
+    LOG_WARN("Test {} - Decimator and Interpolator", ++num);
+    const vector<unit16> taps = random_values<unit16>(48, rng, 11), x = random_values<unit16>(10000, rng);
+    const vector<unit16> filtered = convolve(x, taps);
+    for (size_t factor : {1, 3, 4}) {
+        Decimator<unit16> decimator(factor, taps);
+        vector<unit16> y(decimator.outputs(x.size())), z;
+        runtime_assert(decimator.process(x, y), y.size(), "decimator outputs");
+        decimator.reset();
+        in_blocks(x.size(), rng, [&](size_t first, size_t count) {
+            vector<unit16> part(decimator.outputs(count));
+            decimator.process(span(x).subspan(first, count), part);
+            z.insert(z.end(), part.begin(), part.end());
+        });
+        size_t mismatches = (z != y);
+        for (size_t j = 0; j < y.size(); ++j) mismatches += (y[j] != filtered[j * factor]);
+        runtime_assert(mismatches, 0, "Decimator by " + to_string(factor));
+
+        Interpolator<unit16> interpolator(factor, taps);
+        vector<unit16> stuffed(x.size() * factor), up(x.size() * factor);
+        for (size_t i = 0; i < x.size(); ++i) stuffed[i * factor] = x[i];
+        interpolator.process(x, up);
+        runtime_assert((up == convolve(stuffed, taps)), true, "Interpolator by " + to_string(factor));
+    }
+
+    LOG_WARN("Test {} - Biquad cascade against double", ++num);
+    // Two low-pass sections at an eighth of the sample rate, Q = 0.707, quantized to q30
+    const double w = std::numbers::pi / 4, alpha = std::sin(w) / (2 * 0.7071), a0 = 1 + alpha;
+    const double b[3] = {(1 - std::cos(w)) / 2 / a0, (1 - std::cos(w)) / a0, (1 - std::cos(w)) / 2 / a0};
+    const double a[2] = {-2 * std::cos(w) / a0, (1 - alpha) / a0};
+    const BiquadSection<q30> section = {q30(b[0]), q30(b[1]), q30(b[2]), q30(a[0]), q30(a[1])};
+    const vector<BiquadSection<q30>> sections(2, section);
+    Biquad<unit16, q30> biquad(sections), chunked(sections);
+    vector<unit16> signal(10000);
+    for (size_t i = 0; i < signal.size(); ++i) signal[i] = unit16(0.45 * std::sin(0.05 * i) + 0.45 * std::sin(2.5 * i));
+    vector<unit16> y(signal.size()), z(signal.size());
+    biquad.process(signal, y);
+    in_blocks(signal.size(), rng, [&](size_t first, size_t count) {
+        chunked.process(span(signal).subspan(first, count), span(z).subspan(first, count));
+    });
+    runtime_assert((y == z), true, "Biquad in blocks");
+    // The same cascade in double, with the quantized coefficients
+    const double qb[3] = {double(section.b0._data) / (1 << 30), double(section.b1._data) / (1 << 30), double(section.b2._data) / (1 << 30)};
+    const double qa[2] = {double(section.a1._data) / (1 << 30), double(section.a2._data) / (1 << 30)};
+    vector<double> d(signal.size());
+    for (size_t i = 0; i < signal.size(); ++i) d[i] = std::ldexp(double(signal[i]._data), -15);
+    for (int s = 0; s < 2; ++s) {
+        double x1 = 0, x2 = 0, y1 = 0, y2 = 0;
+        for (auto& v : d) {
+            const double out = qb[0] * v + qb[1] * x1 + qb[2] * x2 - qa[0] * y1 - qa[1] * y2;
+            x2 = x1; x1 = v; y2 = y1; y1 = out; v = out;
+        }
+    }
+    double worst = 0;
+    for (size_t i = 0; i < d.size(); ++i) worst = max(worst, std::abs(std::ldexp(double(y[i]._data), -15) - d[i]) * 32768);
+    runtime_assert((worst < 4), true, "Biquad within 4 ULP of double");
+
+    LOG_WARN("Test {} - Chained in blocks", ++num);
+    FIR<unit16> fir(taps), fir2(taps);
+    Decimator<unit16> decimator(2, taps), decimator2(2, taps);
+    Biquad<unit16, q30> iir(sections), iir2(sections);
+    vector<unit16> stage1(x.size()), stage2(decimator.outputs(x.size())), chained;
+    fir.process(x, stage1);
+    decimator.process(stage1, stage2);
+    iir.process(stage2, stage2);
+    in_blocks(x.size(), rng, [&](size_t first, size_t count) {
+        vector<unit16> part(count);
+        fir2.process(span(x).subspan(first, count), part);
+        vector<unit16> down(decimator2.outputs(count));
+        decimator2.process(part, down);
+        iir2.process(down, down);
+        chained.insert(chained.end(), down.begin(), down.end());
+    });
+    runtime_assert((chained == stage2), true, "FIR, Decimator and Biquad");
+
+    LOG_WARN("Test {} - Errors", ++num);
+    bool threw = false;
+    try { FIR<unit16> empty(vector<unit16>{}); } catch (const runtime_error&) { threw = true; }
+    runtime_assert(threw, true, "FIR without taps");
+    threw = false;
+    try { Decimator<unit16> none(0, taps); } catch (const runtime_error&) { threw = true; }
+    runtime_assert(threw, true, "Decimator by 0");
+    return 0;
+}
@@ -0,0 +1,136 @@
+#include <iostream>
+#include <vector>
+#include <random>
+#include <string>
+#include <cmath>
+
+#include "debug.hpp"
+#include "prec_linalg.hpp"
+
+static constexpr auto src = "prec_linalg:TEST";
+using namespace std;
+using namespace dattatypes;
+
+
+// Vectors and matrices in constant evaluation
+static_assert(dot(Vec3<prec32>(1, 2, 3), Vec3<prec32>(4, -5, 6)) == prec32(12));
+static_assert(cross(Vec3<prec32>(1, 0, 0), Vec3<prec32>(0, 1, 0)) == Vec3<prec32>(0, 0, 1));
+static_assert(length(Vec3<prec32>(2, 3, 6)) == prec32(7));
+static_assert(length(Vec2<prec64>(3, -4)) == prec64(5));
+static_assert(normalize(Vec2<prec32>(3, 4)) == Vec2<prec32>(0.6015625, 0.80078125));
+static_assert(normalize<unit32>(Vec2<prec32>(0, -2)) == Vec2<unit32>(0, -1));
+static_assert(normalize(Vec3<prec32>()) == Vec3<prec32>());
+static_assert(Mat3<prec32>::identity() * Vec3<prec32>(1.5, -2, 3) == Vec3<prec32>(1.5, -2, 3));
+static_assert(Mat3<prec32>(Vec3<prec32>(0, -1, 0), Vec3<prec32>(1, 0, 0), Vec3<prec32>(0, 0, 1)).transpose()
+              * Vec3<prec32>(1, 2, 3) == Vec3<prec32>(2, -1, 3));
+static_assert(Mat4<prec32>(Vec4<prec32>(1, 0, 0, 10), Vec4<prec32>(0, 1, 0, 20), Vec4<prec32>(0, 0, 1, 30), Vec4<prec32>(0, 0, 0, 1))
+              * Mat4<prec32>::identity() == Mat4<prec32>(Vec4<prec32>(1, 0, 0, 10), Vec4<prec32>(0, 1, 0, 20), Vec4<prec32>(0, 0, 1, 30), Vec4<prec32>(0, 0, 0, 1)));
+// Rounded once: 3 * (1/256 * 1/2) is 3/512, which truncates to 1/256 rather than 3 * 0
+static_assert(dot(Vec3<prec32>(0.00390625, 0.00390625, 0.00390625), Vec3<prec32>(0.5, 0.5, 0.5)) == prec32(0.00390625));
+
+// Unit types cannot hold 1.0: identity saturates below it, and translations stay exact
+static_assert(Mat3<unit32>::identity()[1][1]._data == INT32_MAX && Mat3<unit32>::identity()[1][0] == unit32(0));
+static_assert(Mat3<unit32>::identity() * Vec3<unit32>(0.5, -0.25, 0) == Vec3<unit32>(0.5 - 0x1p-31, -0.25 + 0x1p-31, 0));
+static_assert(transform_point(Mat4<unit32>(Vec4<unit32>(0, 0, 0, 0.25), Vec4<unit32>(0, 0, 0, -0.5),
+                                           Vec4<unit32>(0, 0, 0, 0.125), Vec4<unit32>(0, 0, 0, 0)), Vec3<unit32>(0.5, 0.5, 0.5))
+              == Vec3<unit32>(0.25, -0.5, 0.125));
+static_assert(transform_point(Mat4<unit32>::identity(), Vec3<unit32>(0, 0, -0.75)) == Vec3<unit32>(0, 0, -0.75 + 0x1p-31));
+
+
+template <PrecType P>
+Mat<P, 4> random_affine(mt19937_64& rng) {
+    uniform_real_distribution<double> entry(-1.0, 1.0), offset(-100.0, 100.0);
+    Mat<P, 4> m = Mat<P, 4>::identity();
+    for (size_t i = 0; i < 3; ++i) {
+        for (size_t j = 0; j < 3; ++j) m[i][j] = P(entry(rng));
+        m[i][3] = P(offset(rng));
+    }
+    return m;
+}
+
+// Bulk transforms of SoAVec3 against the scalar matrix products
+template <PrecType P>
+void check_soa_against_scalar(const string& name, mt19937_64& rng) {
+    using T = typename P::value_type;
+    constexpr size_t n = 1027;
+    uniform_int_distribution<int64_t> dist(is_signed_v<T> ? -(int64_t(1) << 20) : 0, int64_t(1) << 20);
+
+    SoAVec3<P> soa;
+    vector<Vec3<P>> scalar;
+    for (size_t i = 0; i < n; ++i) {
+        Vec3<P> v;
+        for (size_t c = 0; c < 3; ++c) v[c]._data = T(dist(rng));
+        soa.push_back(v);
+        scalar.push_back(v);
+    }
+
+    const Mat4<P> affine = random_affine<P>(rng);
+    Mat3<P> linear;
+    for (size_t i = 0; i < 3; ++i)
+        for (size_t j = 0; j < 3; ++j) linear[i][j] = affine[i][j];
+    const Vec3<P> offset(P(0.5), P(1), P(2));
+
+    soa.transform(linear);
+    soa.transform(affine);
+    soa.translate(offset);
+    for (auto& v : scalar) v = transform_point(affine, linear * v) + offset;
+
+    size_t mismatches = 0;
+    for (size_t i = 0; i < n; ++i) mismatches += (soa[i] != scalar[i]);
+    runtime_assert(mismatches, 0, "SoAVec3<" + name + ">");
+}
+
+// Largest error of normalize in units of the last place of R, against double on the raw values
+template <PrecType P, PrecType R>
+double normalize_max_ulp(mt19937_64& rng) {
+    uniform_real_distribution<double> dist(-1000.0, 1000.0);
+    double worst = 0;
+    for (int i = 0; i < 10000; ++i) {
+        const Vec3<P> v(P(dist(rng)), P(dist(rng)), P(dist(rng)));
+        const double x = double(v[0]._data), y = double(v[1]._data), z = double(v[2]._data);
+        const double len = std::sqrt(x*x + y*y + z*z);
+        if (len == 0) continue;
+        const Vec3<R> unit = normalize<R>(v);
+        for (size_t c = 0; c < 3; ++c)
+            worst = max(worst, std::abs(double(unit[c]._data) - std::ldexp(double(v[c]._data) / len, -R::_n)));
+    }
+    return worst;
+}
+
+
+// Testing
+int main() {
+    LOG_INFO("=== Beginning Tests for prec_linalg ===");
+
+    int num=0;
+    mt19937_64 rng(7);
+
+    LOG_WARN("Test {} - Vector arithmetic", ++num);
+    Vec3<prec32> a(1.5, -2, 0.25), b(0.5, 4, -8);
+    runtime_assert(double((a + b).y()), 2.0, "(a + b).y");
+    runtime_assert(double((a - b).z()), 8.25, "(a - b).z");
+    runtime_assert(double((a * prec32(2)).x()), 3.0, "(a * 2).x");
+    runtime_assert(double(dot(a, b)), -9.25, "dot(a, b)");
+    runtime_assert(double(cross(a, b).x()), 15.0, "cross(a, b).x");
+    runtime_assert(double(length(Vec4<prec64>(1, 1, 1, 1))), 2.0, "length");
+
+    LOG_WARN("Test {} - normalize is within half an ULP", ++num);
+    runtime_assert((normalize_max_ulp<prec32, prec32>(rng) <= 0.5 + 1e-9), true, "normalize<prec32>");
+    runtime_assert((normalize_max_ulp<prec32, unit32>(rng) <= 0.5 + 1e-6), true, "normalize<unit32>(prec32)");
+    runtime_assert((normalize_max_ulp<prec64, unit32>(rng) <= 0.5 + 1e-6), true, "normalize<unit32>(prec64)");
+
+    LOG_WARN("Test {} - SoAVec3 bulk transforms match scalar", ++num);
+    check_soa_against_scalar<prec32>("prec32", rng);
+    check_soa_against_scalar<prec64>("prec64", rng);
+    check_soa_against_scalar<Prec<int32_t, -12, Rounding::nearest>>("nearest32", rng);
+    check_soa_against_scalar<saturating<prec32>>("saturating<prec32>", rng);
+    check_soa_against_scalar<Prec<int16_t, -4, Rounding::floor>>("floor16", rng);
+
+    LOG_WARN("Test {} - SoAVec3 container", ++num);
+    SoAVec3<prec32> soa(2);
+    soa.set(1, Vec3<prec32>(1, 2, 3));
+    runtime_assert(soa.size(), size_t(2), "size");
+    runtime_assert(double(soa[1].z()), 3.0, "soa[1].z");
+    runtime_assert(double(soa.y[1]), 2.0, "soa.y[1]");
+    return 0;
+}
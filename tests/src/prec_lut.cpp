@@ -0,0 +1,83 @@
+#include <iostream>
+#include <vector>
+#include <random>
+#include <string>
+
+#include "debug.hpp"
+#include "prec_lut.hpp"
+
+static constexpr auto src = "prec_lut:TEST";
+using namespace std;
+using namespace dattatypes;
+
+
+constexpr double smoothstep(double x) { return x * x * (3 - 2 * x); }
+constexpr double ease_out(double x) { return 1 - (1 - x) * (1 - x) * (1 - x) * (1 - x); }
+constexpr double square(double x) { return x * x; }
+constexpr double cubic(double x) { return x * x * x / 16384; }
+// A sigmoid with a Taylor series exp, constexpr unlike std::exp
+constexpr double sigmoid(double x) {
+    double term = 1, sum = 1;
+    for (int k = 1; k < 40; ++k) sum += (term *= -x / k);
+    return 1 / (1 + sum);
+}
+
+// Tabulated at compile time
+static constexpr auto smooth_lut = make_lut<u_unit16, u_unit16, 8>(smoothstep);
+static constexpr auto ease_lut = make_lut<u_unit16, u_unit16, 6, Interpolation::quadratic>(ease_out);
+static constexpr auto sigmoid_lut = make_lut<Prec<int16_t, -12>, u_unit16, 10>(sigmoid);
+static constexpr auto cubic_lut = make_lut<Prec<int32_t, -24>, Prec<int32_t, -24>, 10, Interpolation::quadratic>(cubic);
+
+// Exact at the table entries, and computed at compile time
+static_assert(smooth_lut(u_unit16(0.5))._data == 32768);
+static_assert(make_lut<u_unit8, u_unit8, 8>([](double x) { return 1 - x; }).max_error() <= 0.5);
+
+
+// The batch form against the scalar form, over every input of In
+template <typename L, PrecType In, PrecType Out>
+size_t batch_mismatches(const L& lut) {
+    vector<In> in(size_t(1) << (8 * sizeof(typename In::value_type)));
+    for (size_t i = 0; i < in.size(); ++i) in[i]._data = typename In::value_type(i);
+    vector<Out> out(in.size());
+    lut(in, out);
+    size_t mismatches = 0;
+    for (size_t i = 0; i < in.size(); ++i) mismatches += (out[i] != lut(in[i]));
+    return mismatches;
+}
+
+
+// Testing
+int main() {
+    LOG_INFO("=== Beginning Tests for prec_lut ===");
+
+    int num=0;
+
+    LOG_WARN("Test {} - Entries", ++num);
+    runtime_assert(smooth_lut(u_unit16(0.0))._data, 0, "smoothstep(0)");
+    runtime_assert(smooth_lut(u_unit16(0.25))._data, uint16_t(smoothstep(0.25) * 65536 + 0.5), "smoothstep(0.25)");
+    runtime_assert(sigmoid_lut(Prec<int16_t, -12>(0.0))._data, 32768, "sigmoid(0)");
+    runtime_assert(sigmoid_lut(Prec<int16_t, -12>(7.5))._data, uint16_t(sigmoid(7.5) * 65536 + 0.5), "sigmoid(7.5)");
+    runtime_assert((make_lut<u_unit16, u_unit8, 4>([](double x) { return 2 * x; })(u_unit16(0.75))._data), 255, "saturates");
+
+    LOG_WARN("Test {} - Maximum error", ++num);
+    const double smooth_error = smooth_lut.max_error(), ease_error = ease_lut.max_error();
+    const double sigmoid_error = sigmoid_lut.max_error(), cubic_error = cubic_lut.max_error();
+    LOG_INFO("smoothstep {} ulp, ease-out {} ulp, sigmoid {} ulp, cubic {} ulp", smooth_error, ease_error, sigmoid_error, cubic_error);
+    runtime_assert(smooth_error < 1.5, true, "smoothstep within 1.5 ulp");
+    runtime_assert(ease_error < 1.5, true, "quadratic ease-out within 1.5 ulp");
+    runtime_assert(sigmoid_error < 1.5, true, "sigmoid within 1.5 ulp");
+    runtime_assert(cubic_error < 8, true, "32-bit quadratic cubic within 8 ulp");
+    runtime_assert((make_lut<u_unit16, u_unit16, 4>(smoothstep).max_error() > smooth_error), true, "fewer entries, larger error");
+    runtime_assert((make_lut<u_unit16, u_unit16, 4, Interpolation::quadratic>(square).max_error() < 1), true,
+                   "quadratic is exact for quadratic segments");
+
+    LOG_WARN("Test {} - Batch", ++num);
+    runtime_assert((batch_mismatches<decltype(smooth_lut), u_unit16, u_unit16>(smooth_lut)), 0, "linear batch");
+    runtime_assert((batch_mismatches<decltype(ease_lut), u_unit16, u_unit16>(ease_lut)), 0, "quadratic batch");
+    runtime_assert((batch_mismatches<decltype(sigmoid_lut), Prec<int16_t, -12>, u_unit16>(sigmoid_lut)), 0, "signed input batch");
+    bool threw = false;
+    try { vector<u_unit16> in(3), out(2); smooth_lut(in, out); }
+    catch (const std::runtime_error&) { threw = true; }
+    runtime_assert(threw, true, "mismatched sizes throw");
+    return 0;
+}
@@ -0,0 +1,141 @@
+#include <iostream>
+#include <vector>
+#include <random>
+#include <string>
+#include <cmath>
+#include <numbers>
+
+#include "debug.hpp"
+#include "prec_quat.hpp"
+
+static constexpr auto src = "prec_quat:TEST";
+using namespace std;
+using namespace dattatypes;
+
+
+// Quaternion algebra in constant evaluation
+static_assert(quat<prec32>(0, 1, 0, 0) * quat<prec32>(0, 0, 1, 0) == quat<prec32>(0, 0, 0, 1)); // i j = k
+static_assert(quat<prec32>(0, 0, 1, 0) * quat<prec32>(0, 1, 0, 0) == quat<prec32>(0, 0, 0, -1)); // j i = -k
+static_assert(quat<prec32>(1, 2, 3, 4) * conj(quat<prec32>(1, 2, 3, 4)) == quat<prec32>(30, 0, 0, 0));
+static_assert(dot(quat<prec32>(1, 2, 3, 4), quat<prec32>(1, 1, 1, 1)) == prec32(10));
+static_assert(normalize(quat<prec32>(0, 0, 3, 4)) == quat<prec32>(0, 0, 0.6015625, 0.80078125));
+static_assert(quat<unit32>::identity().w()._data == INT32_MAX);
+static_assert(rotate(quat<prec32>::identity(), Vec3<prec32>(1.5, -2, 3)) == Vec3<prec32>(1.5, -2, 3));
+static_assert(rotate(quat<prec32>(0, 0, 0, 1), Vec3<prec32>(1, 2, 3)) == Vec3<prec32>(-1, -2, 3)); // Half turn about z
+
+
+template <PrecType Q>
+quat<Q> random_rotation(mt19937_64& rng) {
+    normal_distribution<double> dist;
+    double q[4], norm = 0;
+    for (auto& c : q) { c = dist(rng); norm += c * c; }
+    norm = std::sqrt(norm);
+    return quat<Q>(Q(q[0] / norm), Q(q[1] / norm), Q(q[2] / norm), Q(q[3] / norm));
+}
+
+// Raw values of a Prec as double, without the float precision of its conversion operator
+template <PrecType P>
+double exact(const P& value) { return std::ldexp(double(value._data), P::_n); }
+
+// Largest error of rotate against q v q* in double, in units of the last place of P
+template <PrecType P, PrecType Q>
+double rotate_max_ulp(mt19937_64& rng) {
+    uniform_real_distribution<double> dist(-1000.0, 1000.0);
+    double worst = 0;
+    for (int i = 0; i < 2000; ++i) {
+        const quat<Q> q = random_rotation<Q>(rng);
+        const Vec3<P> v(P(dist(rng)), P(dist(rng)), P(dist(rng)));
+        const double w = exact(q.w()), x = exact(q.x()), y = exact(q.y()), z = exact(q.z());
+        const double m[3][3] = {
+            {1 - 2*(y*y + z*z), 2*(x*y - w*z),     2*(x*z + w*y)},
+            {2*(x*y + w*z),     1 - 2*(x*x + z*z), 2*(y*z - w*x)},
+            {2*(x*z - w*y),     2*(y*z + w*x),     1 - 2*(x*x + y*y)},
+        };
+        const Vec3<P> r = rotate(q, v);
+        for (size_t row = 0; row < 3; ++row) {
+            const double expected = m[row][0] * exact(v[0]) + m[row][1] * exact(v[1]) + m[row][2] * exact(v[2]);
+            worst = max(worst, std::abs(exact(r[row]) - expected) * std::ldexp(1.0, -P::_n));
+        }
+    }
+    return worst;
+}
+
+// Batch rotations of spans and SoAVec3 against the single rotation
+template <PrecType P>
+void check_batch_against_scalar(const string& name, mt19937_64& rng) {
+    using T = typename P::value_type;
+    constexpr size_t n = 1029;
+    uniform_int_distribution<int64_t> dist(-(int64_t(1) << 20), int64_t(1) << 20);
+    const quat<unit32> q = random_rotation<unit32>(rng);
+
+    vector<Vec3<P>> points(n), scalar(n);
+    SoAVec3<P> soa;
+    for (size_t i = 0; i < n; ++i) {
+        for (size_t c = 0; c < 3; ++c) points[i][c]._data = T(dist(rng));
+        soa.push_back(points[i]);
+        scalar[i] = rotate(q, points[i]);
+    }
+    rotate<P>(q, points, points);
+    rotate(q, soa);
+
+    size_t mismatches = 0;
+    for (size_t i = 0; i < n; ++i) mismatches += (points[i] != scalar[i]) + (soa[i] != scalar[i]);
+    runtime_assert(mismatches, 0, "batch rotate<" + name + ">");
+}
+
+// Largest component error of slerp against the spherical interpolation in double
+double slerp_max_error(mt19937_64& rng) {
+    double worst = 0;
+    for (int i = 0; i < 1000; ++i) {
+        const quat<unit32> a = random_rotation<unit32>(rng), b = random_rotation<unit32>(rng);
+        const unit32 t = unit32(double(i % 8) / 8.0);
+        double d = 0;
+        for (size_t c = 0; c < 4; ++c) d += exact(a._data[c]) * exact(b._data[c]);
+        const double sign = (d < 0) ? -1.0 : 1.0, theta = std::acos(std::min(1.0, std::abs(d)));
+        const quat<unit32> s = slerp(a, b, t);
+        for (size_t c = 0; c < 4; ++c) {
+            const double expected = (std::sin((1 - exact(t)) * theta) * exact(a._data[c]) + std::sin(exact(t) * theta) * sign * exact(b._data[c])) / std::sin(theta);
+            worst = max(worst, std::abs(expected - exact(s._data[c])));
+        }
+    }
+    return worst;
+}
+
+
+// Testing
+int main() {
+    LOG_INFO("=== Beginning Tests for prec_quat ===");
+
+    int num=0;
+    mt19937_64 rng(11);
+
+    LOG_WARN("Test {} - Axis-angle rotations", ++num);
+    const quat<unit32> quarter = from_axis_angle<unit32>(Vec3<prec32>(0, 0, 1), angle32(0.5));
+    const Vec3<prec32> turned = rotate(quarter, Vec3<prec32>(1, 0, 0));
+    runtime_assert((std::abs(exact(turned.x())) <= 0.00390625 && std::abs(exact(turned.y()) - 1.0) <= 0.00390625), true, "quarter turn about z");
+    runtime_assert((std::abs(exact(quarter.w()) - std::sqrt(0.5)) < 1e-9), true, "cos(pi/4)");
+
+    LOG_WARN("Test {} - rotate truncates within an ULP", ++num);
+    runtime_assert((rotate_max_ulp<prec32, unit32>(rng) <= 1.0625), true, "rotate<prec32>(quat<unit32>)");
+    runtime_assert((rotate_max_ulp<prec64, unit32>(rng) <= 1.0625), true, "rotate<prec64>(quat<unit32>)");
+
+    LOG_WARN("Test {} - Batch rotations match scalar", ++num);
+    check_batch_against_scalar<prec32>("prec32", rng);
+    check_batch_against_scalar<Prec<int32_t, -12, Rounding::nearest>>("nearest32", rng);
+    check_batch_against_scalar<saturating<prec32>>("saturating<prec32>", rng);
+    check_batch_against_scalar<prec16>("prec16", rng);
+    check_batch_against_scalar<prec64>("prec64", rng);
+
+    LOG_WARN("Test {} - Interpolation", ++num);
+    const quat<unit32> a = random_rotation<unit32>(rng), b = random_rotation<unit32>(rng);
+    const quat<unit32> start = slerp(a, b, unit32(0)), halfway = slerp(a, b, unit32(0.5)), nhalfway = nlerp(a, b, unit32(0.5));
+    double start_error = 0, halfway_error = 0;
+    for (size_t c = 0; c < 4; ++c) {
+        start_error = max(start_error, std::abs(exact(start._data[c]) - exact(a._data[c])));
+        halfway_error = max(halfway_error, std::abs(exact(halfway._data[c]) - exact(nhalfway._data[c])));
+    }
+    runtime_assert((start_error < 1e-8), true, "slerp(a, b, 0) = a");
+    runtime_assert((halfway_error < 1e-8), true, "slerp(a, b, 0.5) = nlerp(a, b, 0.5)");
+    runtime_assert((slerp_max_error(rng) < 1e-8), true, "slerp against double");
+    return 0;
+}
@@ -0,0 +1,128 @@
+#include <iostream>
+#include <vector>
+#include <string>
+#include <cmath>
+
+#include "debug.hpp"
+#include "prec_random.hpp"
+
+static constexpr auto src = "prec_random:TEST";
+using namespace std;
+using namespace dattatypes;
+
+
+// Known-answer tests of Philox4x32-10, from the Random123 distribution: counter (index, stream), key (seed)
+static_assert(Philox(0, 0).block(0) == Philox::block_type{0x6627e8d5, 0xe169c58d, 0xbc57ac4c, 0x9b00dbd8});
+static_assert(Philox(~uint64_t(0), ~uint64_t(0)).block(~uint64_t(0)) == Philox::block_type{0x408f276d, 0x41c83b0e, 0xa20bc7c6, 0x6d5451fd});
+static_assert(Philox(0x299f31d0a4093822, 0x0370734413198a2e).block(0x85a308d3243f6a88) == Philox::block_type{0xd16cfe09, 0x94fdcceb, 0x5001e420, 0x24126ea1});
+// Sequential words walk the blocks in order
+static_assert([] { Philox gen(7); gen.seek(5); return gen(); }() == Philox(7).block(1)[1]);
+
+
+// The SIMD `fill` against word-by-word generation, from unaligned positions
+bool fill_matches_scalar() {
+    for (uint64_t start : {0, 1, 3, 4, 1000003}) {
+        for (size_t n : {0, 1, 7, 64, 129, 1000}) {
+            Philox bulk(42, 3), single(42, 3);
+            bulk.seek(start);
+            single.seek(start);
+            vector<uint32_t> words(n);
+            bulk.fill(words);
+            for (size_t i = 0; i < n; ++i) if (words[i] != single()) return false;
+            if (bulk.position() != single.position()) return false;
+        }
+    }
+    return true;
+}
+
+template <PrecType P>
+double mean(const vector<P>& values) {
+    double sum = 0;
+    for (const auto& v : values) sum += std::ldexp(double(v._data), P::_n);
+    return sum / double(values.size());
+}
+
+template <PrecType P>
+double variance(const vector<P>& values) {
+    const double m = mean(values);
+    double sum = 0;
+    for (const auto& v : values) sum += (std::ldexp(double(v._data), P::_n) - m) * (std::ldexp(double(v._data), P::_n) - m);
+    return sum / double(values.size());
+}
+
+
+// Testing
+int main() {
+    LOG_INFO("=== Beginning Tests for prec_random ===");
+
+    int num=0;
+    constexpr size_t n = 1 << 18;
+
+    LOG_WARN("Test {} - Bulk fill matches the scalar sequence", ++num);
+    runtime_assert(fill_matches_scalar(), true, "fill");
+
+    LOG_WARN("Test {} - Streams reproduce and differ", ++num);
+    Philox a(1, 0), b(1, 0), c = Philox(1).stream(1);
+    vector<prob32> xa(64), xb(64), xc(64);
+    uniform<prob32>(a, xa);
+    uniform<prob32>(b, xb);
+    uniform<prob32>(c, xc);
+    size_t same = 0, collisions = 0;
+    for (size_t i = 0; i < 64; ++i) { same += (xa[i] == xb[i]); collisions += (xa[i] == xc[i]); }
+    runtime_assert(same, size_t(64), "same seed and stream");
+    runtime_assert(collisions, size_t(0), "other stream");
+    Philox d(1, 0);
+    d.discard(10);
+    runtime_assert(uniform<prob32>(d)._data, xa[10]._data, "discard");
+
+    LOG_WARN("Test {} - Uniform", ++num);
+    Philox gen(2024);
+    vector<u_unit32> p(n);
+    uniform<u_unit32>(gen, p);
+    runtime_assert((std::abs(mean(p) - 0.5) < 0.005), true, "uniform<u_unit32> mean");
+    runtime_assert((std::abs(variance(p) - 1.0 / 12) < 0.002), true, "uniform<u_unit32> variance");
+    vector<prob32> q(n);
+    uniform<prob32>(gen, q, prob32(0), prob32(1));
+    runtime_assert((std::abs(mean(q) - 0.5) < 0.005), true, "uniform<prob32> in [0, 1) mean");
+    vector<unit16> u(n);
+    uniform<unit16>(gen, u);
+    runtime_assert((std::abs(mean(u)) < 0.01), true, "uniform<unit16> mean");
+    vector<prec64> r(n);
+    uniform<prec64>(gen, r, prec64(-3), prec64(5));
+    bool in_range = true;
+    for (const auto& v : r) in_range &= (v >= prec64(-3) && v < prec64(5));
+    runtime_assert(in_range, true, "uniform<prec64> in [-3, 5)");
+    runtime_assert((std::abs(mean(r) - 1.0) < 0.05), true, "uniform<prec64> mean");
+    vector<u_prec16> small(n);
+    uniform<u_prec16>(gen, small, u_prec16(10), u_prec16(12));
+    runtime_assert((std::abs(mean(small) - 10.96875) < 0.01), true, "uniform<u_prec16> in [10, 12) mean");
+
+    LOG_WARN("Test {} - Bernoulli", ++num);
+    vector<uint8_t> trials(n);
+    bernoulli(gen, prob32(0.3), trials);
+    size_t hits = 0;
+    for (auto t : trials) hits += t;
+    runtime_assert((std::abs(double(hits) / n - 0.3) < 0.005), true, "bernoulli(0.3)");
+    bernoulli(gen, prob32(), trials);
+    hits = 0;
+    for (auto t : trials) hits += t;
+    runtime_assert(hits, size_t(0), "bernoulli(0)");
+    bernoulli(gen, prob16(1), trials);
+    hits = 0;
+    for (auto t : trials) hits += t;
+    runtime_assert(hits, n, "bernoulli(1)");
+
+    LOG_WARN("Test {} - Normal", ++num);
+    vector<Prec<int32_t, -16>> z(n);
+    normal<Prec<int32_t, -16>>(gen, z);
+    runtime_assert((std::abs(mean(z)) < 0.01), true, "normal mean");
+    runtime_assert((std::abs(variance(z) - 1.0) < 0.01), true, "normal variance");
+    size_t within = 0;
+    for (const auto& v : z) within += (std::abs(std::ldexp(double(v._data), -16)) < 1.0);
+    runtime_assert((std::abs(double(within) / n - 0.6827) < 0.01), true, "normal within one sigma");
+    vector<prec32> shifted(n);
+    normal<prec32>(gen, shifted, prec32(100), prec32(4));
+    runtime_assert((std::abs(mean(shifted) - 100.0) < 0.05), true, "normal(100, 4) mean");
+    runtime_assert((std::abs(std::sqrt(variance(shifted)) - 4.0) < 0.05), true, "normal(100, 4) stddev");
+    return 0;
+}
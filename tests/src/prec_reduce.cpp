@@ -0,0 +1,104 @@
+#include <iostream>
+#include <vector>
+#include <random>
+#include <string>
+#include <cmath>
+
+#include "debug.hpp"
+#include "prec_reduce.hpp"
+
+static constexpr auto src = "prec_reduce:TEST";
+using namespace std;
+using namespace dattatypes;
+
+
+// Random raw values over the whole range of T, or of 40 bits for 64-bit types, whose sums of products must fit 128 bits
+template <PrecType P>
+vector<P> random_values(const size_t n, mt19937_64& rng) {
+    using T = typename P::value_type;
+    vector<P> values(n);
+    for (auto& v : values) v._data = (sizeof(T) == 8) ? T(int64_t(rng()) >> 24) : T(rng());
+    return values;
+}
+
+// Every reduction with 1 to 7 threads, and the histogram, against plain loops over 128-bit integers
+template <PrecType P>
+void check_reductions(const string& name, mt19937_64& rng) {
+    using T = typename P::value_type;
+    using R = detail::reduce_t<P>;
+    const size_t n = 5 * reduce_grain + 13;
+    const vector<P> a = random_values<P>(n, rng), b = random_values<P>(n, rng);
+
+    R exact_sum = 0, exact_dot = 0;
+    T lo = a[0]._data, hi = a[0]._data;
+    for (size_t i = 0; i < n; ++i) {
+        exact_sum += a[i]._data;
+        exact_dot += R(a[i]._data) * R(b[i]._data);
+        lo = std::min(lo, a[i]._data);
+        hi = std::max(hi, a[i]._data);
+    }
+    const P expected_sum = detail::from_fixed<P>(detail::int128_t(exact_sum), -P::_n);
+    const P expected_dot = detail::from_fixed<P>(detail::int128_t(exact_dot), -2 * P::_n);
+    const P expected_mean = detail::from_fixed<P>(detail::round_div(detail::int128_t(exact_sum), detail::int128_t(n)), -P::_n);
+
+    size_t mismatches = 0;
+    for (size_t threads = 1; threads <= 7; ++threads) {
+        mismatches += (sum<P>(a, threads) != expected_sum);
+        mismatches += (dot<P>(a, b, threads) != expected_dot);
+        mismatches += (mean<P>(a, threads) != expected_mean);
+        mismatches += (min<P>(a, threads)._data != lo);
+        mismatches += (max<P>(a, threads)._data != hi);
+    }
+    runtime_assert(mismatches, 0, "reductions of " + name);
+
+    // Bins of a quarter of the range, counted against a plain loop
+    P qlo, qhi;
+    qlo._data = T(lo / 2);
+    qhi._data = T(hi / 2);
+    vector<uint64_t> expected(7), counts(7), threaded(7);
+    using W = detail::uint128_t;
+    for (const auto& v : a)
+        if (v._data >= qlo._data && v._data < qhi._data)
+            ++expected[size_t(W(v._data - qlo._data) * 7 / W(qhi._data - qlo._data))];
+    histogram(a, qlo, qhi, counts, 1);
+    histogram(a, qlo, qhi, threaded, 5);
+    runtime_assert((counts == expected && threaded == expected), true, "histogram of " + name);
+}
+
+
+// Testing
+int main() {
+    LOG_INFO("=== Beginning Tests for prec_reduce ===");
+
+    int num=0;
+    mt19937_64 rng(3);
+
+    LOG_WARN("Test {} - Sums do not overflow", ++num);
+    const vector<prec32> large(100000, prec32(8000000));
+    runtime_assert(sum<prec32>(large)._data, INT32_MAX, "sum<prec32> saturates");
+    runtime_assert((sum<prec32, prec64>(large) == prec64(int64_t(800000000000))), true, "sum<prec32, prec64>");
+    runtime_assert((mean<prec32>(large) == prec32(8000000)), true, "mean of a sum past 32 bits");
+    const vector<prec32> thirds = {prec32(1), prec32(1), prec32(0.00390625)};
+    runtime_assert(mean<prec32>(thirds)._data, 171, "mean rounds to nearest"); // 513 / 3
+    runtime_assert((mean<prec32, prec64>(thirds)._data), int64_t(43776), "mean into a finer type"); // 513 * 256 / 3
+    const vector<unit32> halves(8, unit32(0.5));
+    runtime_assert((dot<unit32, prec32>(halves, halves) == prec32(2)), true, "dot<unit32, prec32>");
+
+    LOG_WARN("Test {} - Identical for every thread count", ++num);
+    check_reductions<prec8>("prec8", rng);
+    check_reductions<u_prec16>("u_prec16", rng);
+    check_reductions<prec32>("prec32", rng);
+    check_reductions<u_unit32>("u_unit32", rng);
+    check_reductions<prec64>("prec64", rng);
+    check_reductions<u_prec64>("u_prec64", rng);
+
+    LOG_WARN("Test {} - Errors", ++num);
+    bool threw = false;
+    try { mean<prec32>(vector<prec32>{}); } catch (const runtime_error&) { threw = true; }
+    runtime_assert(threw, true, "mean of nothing");
+    threw = false;
+    vector<uint64_t> counts(4);
+    try { histogram(large, prec32(1), prec32(1), counts); } catch (const runtime_error&) { threw = true; }
+    runtime_assert(threw, true, "histogram of an empty range");
+    return 0;
+}
@@ -0,0 +1,164 @@
+#include <iostream>
+#include <sstream>
+#include <vector>
+#include <random>
+#include <string>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+
+#include "debug.hpp"
+#include "prec_text.hpp"
+
+static constexpr auto src = "prec_text:TEST";
+using namespace std;
+using namespace dattatypes;
+
+
+// Text of a value, shortest or with `precision` decimals
+template <PrecType P>
+constexpr string text(const P value, const int precision = -1) {
+    char buffer[160];
+    const auto result = (precision < 0) ? to_chars(buffer, buffer + sizeof(buffer), value) : to_chars(buffer, buffer + sizeof(buffer), value, precision);
+    return string(buffer, result.ptr);
+}
+
+// Raw value parsed from the whole of `text`, or -1 on any error
+template <PrecType P>
+constexpr int64_t raw(const string_view text) {
+    P value;
+    const auto [end, error] = from_chars(text.data(), text.data() + text.size(), value);
+    return (error == errc() && end == text.data() + text.size()) ? int64_t(value._data) : -1;
+}
+
+template <PrecType P>
+constexpr P from_raw(const typename P::value_type data) { P value; value._data = data; return value; }
+
+// Shortest output
+static_assert(text(from_raw<prec32>(26)) == "0.1");            // 0.1015625
+static_assert(text(from_raw<prec32>(-804)) == "-3.14");         // -3.140625
+static_assert(text(prec32(-5)) == "-5");
+static_assert(text(from_raw<prec8>(-128)) == "-32");
+static_assert(text(from_raw<unit32>(INT32_MIN)) == "-1");
+static_assert(text(from_raw<u_unit8>(1)) == "0.004");           // 0.00390625
+static_assert(text(from_raw<u_unit64>(~uint64_t(0))) == "0.99999999999999999995");
+static_assert(text(from_raw<Prec<int16_t, 3>>(-5)) == "-40");
+// Fixed decimals, ties to even
+static_assert(text(from_raw<prec8>(1), 1) == "0.2");            // 0.25
+static_assert(text(from_raw<prec8>(3), 1) == "0.8");            // 0.75
+static_assert(text(from_raw<prec8>(-1), 0) == "-0");
+static_assert(text(from_raw<prec16>(-8), 0) == "-0");           // -0.5
+static_assert(text(from_raw<prec16>(-24), 0) == "-2");          // -1.5
+static_assert(text(from_raw<prec32>(255), 2) == "1.00");        // 0.99609375
+static_assert(text(from_raw<prec8>(5), 4) == "1.2500");
+static_assert(text(from_raw<Prec<int16_t, 3>>(1), 2) == "8.00");
+// Parsing, to nearest with ties to even
+static_assert(raw<prec32>("3.14") == 804);                      // 803.84
+static_assert(raw<prec8>("0.125") == 0 && raw<prec8>("0.375") == 2);
+static_assert(raw<prec8>("0.1250000000000000000001") == 1);     // Past 19 decimals
+static_assert(raw<prec8>("0.12500000000000000000000000") == 0);
+static_assert(raw<prec8>("-31.875") == -128 && raw<prec8>("-32.125") == -128 && raw<prec8>("-32.25") == -1);
+static_assert(raw<unit32>("-1") == INT32_MIN && raw<unit32>("1") == -1);
+static_assert(raw<prec16>(".5") == 8 && raw<prec16>("5.") == 80 && raw<prec16>("007") == 112);
+static_assert(raw<u_prec16>("-1") == -1 && raw<prec16>("") == -1 && raw<prec16>(".") == -1 && raw<prec16>("-") == -1);
+static_assert(raw<Prec<int16_t, 3>>("-20") == -2 && raw<Prec<int16_t, 3>>("-20.0001") == -3);
+
+
+// Every value read back from its text, shortest and with all decimals
+template <PrecType P>
+void check_round_trip(const string& name, mt19937_64& rng) {
+    using T = typename P::value_type;
+    size_t failures = 0;
+    for (int i = 0; i < 20000; ++i) {
+        const P value = from_raw<P>(T(rng()));
+        failures += (raw<P>(text(value)) != int64_t(value._data));
+        failures += (raw<P>(text(value, -P::_n)) != int64_t(value._data));
+    }
+    runtime_assert(failures, 0, "round trip of " + name);
+}
+
+// Against the double conversions, which are exact for these types
+bool matches_double(mt19937_64& rng) {
+    uniform_int_distribution<int32_t> dist(INT32_MIN, INT32_MAX);
+    char expected[64];
+    for (int i = 0; i < 20000; ++i) {
+        const prec32 value = from_raw<prec32>(dist(rng));
+        const double exact = std::ldexp(double(value._data), prec32::_n);
+        // Within half a unit of the last place
+        const string shortest = text(value);
+        if (std::nearbyint(std::strtod(shortest.c_str(), nullptr) * 256) != double(value._data)) return false;
+        // Fixed decimals, as printf
+        const int precision = i % 6;
+        snprintf(expected, sizeof(expected), "%.*f", precision, exact);
+        if (text(value, precision) != expected) return false;
+        // Parsing random decimals
+        snprintf(expected, sizeof(expected), "%.6f", exact + (i % 997) * 1e-6);
+        if (raw<prec32>(expected) != int64_t(std::nearbyint(std::strtod(expected, nullptr) * 256))) return false;
+    }
+    return true;
+}
+
+
+// Testing
+int main() {
+    LOG_INFO("=== Beginning Tests for prec_text ===");
+
+    int num=0;
+    mt19937_64 rng(5);
+
+    LOG_WARN("Test {} - Round trips", ++num);
+    check_round_trip<prec8>("prec8", rng);
+    check_round_trip<prec32>("prec32", rng);
+    check_round_trip<prec64>("prec64", rng);
+    check_round_trip<u_prec16>("u_prec16", rng);
+    check_round_trip<unit16>("unit16", rng);
+    check_round_trip<unit64>("unit64", rng);
+    check_round_trip<u_unit32>("u_unit32", rng);
+    check_round_trip<u_unit64>("u_unit64", rng);
+    check_round_trip<angle64>("angle64", rng);
+    check_round_trip<prob64>("prob64", rng);
+    check_round_trip<Prec<int32_t, 5>>("Prec<int32_t, 5>", rng);
+
+    LOG_WARN("Test {} - Agrees with the double conversions", ++num);
+    runtime_assert(matches_double(rng), true, "prec32 against strtod and printf");
+
+    LOG_WARN("Test {} - Errors", ++num);
+    char small[4];
+    runtime_assert((to_chars(small, small + sizeof(small), prec32(-12.5)).ec == errc::value_too_large), true, "to_chars into a small buffer");
+    runtime_assert((to_chars(small, small + sizeof(small), prec32(3.5), 3).ec == errc::value_too_large), true, "to_chars(precision) into a small buffer");
+    prec16 value(1);
+    const string bad = "x1", large = "4096.5", sign = "-2";
+    runtime_assert((from_chars(bad.data(), bad.data() + bad.size(), value).ec == errc::invalid_argument), true, "not a number");
+    runtime_assert((from_chars(large.data(), large.data() + large.size(), value).ec == errc::result_out_of_range), true, "out of range");
+    runtime_assert(value._data, 16, "value kept on error");
+    u_prec16 unsigned_value;
+    runtime_assert((from_chars(sign.data(), sign.data() + sign.size(), unsigned_value).ec == errc::invalid_argument), true, "sign of an unsigned type");
+
+    LOG_WARN("Test {} - Streams", ++num);
+    ostringstream os;
+    os << from_raw<prec32>(-804) << ' ' << from_raw<unit64>(INT64_MIN + 1);
+    runtime_assert(os.str(), string("-3.14 -0.9999999999999999999"), "operator<<");
+    // The longest texts fit max_chars
+    char longest[max_chars<unit64>];
+    runtime_assert(size_t(to_chars(longest, longest + sizeof(longest), from_raw<unit64>(INT64_MIN), 63).ptr - longest), max_chars<unit64>, "longest unit64");
+    runtime_assert((to_chars(longest, longest + max_chars<Prec<int64_t, 0>>, from_raw<Prec<int64_t, 0>>(INT64_MIN)).ec == errc()), true, "longest int64");
+    runtime_assert((to_chars(longest, longest + max_chars<Prec<int32_t, 5>>, from_raw<Prec<int32_t, 5>>(INT32_MIN), 0).ec == errc()), true, "longest Prec<int32_t, 5>");
+#ifdef __cpp_lib_format
+    runtime_assert(std::format("{} {:.3} {:.70}", prec32(-3.5), prec32(2.0625), u_prec8(1)).size(), size_t(4 + 1 + 5 + 1 + 72), "std::format");
+    runtime_assert(std::format("{:.2} {:.5}", Prec<int32_t, 5>(64), u_prec8(1.5)), string("64.00 1.50000"), "std::format past the fractional bits");
+#endif
+
+    LOG_WARN("Test {} - Columns", ++num);
+    const string csv = "time,level\r\n0.5, 12.25\r\n\r\n1.0,\t-3\r\n1.5,7.0078125\n";
+    vector<prec32> levels;
+    const size_t rows = parse_column<prec32>(string_view(csv).substr(csv.find('\n') + 1), levels, 1);
+    runtime_assert(rows, size_t(3), "rows");
+    runtime_assert((levels == vector<prec32>{prec32(12.25), prec32(-3), from_raw<prec32>(1794)}), true, "values");
+    bool threw = false;
+    try { parse_column<prec32>("1,2\n3,x\n", levels, 1); } catch (const runtime_error&) { threw = true; }
+    runtime_assert(threw, true, "malformed field");
+    threw = false;
+    try { parse_column<prec32>("1;2\n", levels, 1); } catch (const runtime_error&) { threw = true; }
+    runtime_assert(threw, true, "missing field");
+    return 0;
+}
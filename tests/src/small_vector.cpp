@@ -0,0 +1,106 @@
+#include <iostream>
+#include <string>
+#include <vector>
+#include <random>
+#include <memory_resource>
+
+#include "debug.hpp"
+#include "small_vector.hpp"
+
+static constexpr auto src = "small_vector:TEST";
+using namespace std;
+using namespace dattatypes;
+
+
+template <typename V>
+std::string vec2str(const V& vec) {
+    std::string result = "[";
+    for (size_t i = 0; i < vec.size(); ++i) {
+        result += std::to_string(int(vec[i]));
+        if (i != vec.size() - 1)
+            result += ", ";
+    }
+    result += "]";
+    return result;
+}
+
+
+// Testing
+int main() {
+    LOG_INFO("=== Beginning Tests for small_vector ===");
+
+    int num=0;
+
+    LOG_WARN("Test {} - Inline", ++num);
+    small_vector<int16_t, 4> vec;
+    runtime_assert((vec.empty() && vec.is_inline() && vec.capacity() == 4), true, "empty and inline");
+    vec.push_back(3);
+    vec.insert(vec.begin(), {1, 2});
+    vec.insert(vec.end(), 4);
+    runtime_assert(vec2str(vec), "[1, 2, 3, 4]", "push_back and insert");
+    runtime_assert(vec.is_inline(), true, "full, still inline");
+
+    LOG_WARN("Test {} - Spill and shrink", ++num);
+    vec.insert(vec.begin() + 2, {7, 8});
+    runtime_assert(vec2str(vec), "[1, 2, 7, 8, 3, 4]", "insert in the middle");
+    runtime_assert((!vec.is_inline() && vec.capacity() >= 6), true, "spilled");
+    vec.erase(vec.begin() + 1, vec.begin() + 4);
+    runtime_assert(vec2str(vec), "[1, 3, 4]", "erase");
+    vec.shrink_to_fit();
+    runtime_assert((vec.is_inline() && vec.capacity() == 4), true, "inline again");
+    vec.resize(6);
+    runtime_assert(vec2str(vec), "[1, 3, 4, 0, 0, 0]", "resize zeroes");
+
+    LOG_WARN("Test {} - Copy, move and swap", ++num);
+    const small_vector<int16_t, 4> heap = vec, fits{5, 6};
+    small_vector<int16_t, 4> moved = std::move(vec), inline_moved = fits;
+    runtime_assert((heap == moved && vec.empty()), true, "move from the heap");
+    small_vector<int16_t, 4> target = std::move(inline_moved);
+    runtime_assert((target == fits && target.is_inline() && target.data() != fits.data()), true, "move inline");
+    target.swap(moved);
+    runtime_assert((target == heap && moved == fits && moved.is_inline()), true, "swap");
+    moved = heap;
+    runtime_assert((moved == heap && moved.data() != heap.data()), true, "copy assignment");
+
+    LOG_WARN("Test {} - Allocators", ++num);
+    // Inline elements need no memory at all
+    dattatypes::pmr::small_vector<int32_t, 8> none(std::pmr::null_memory_resource());
+    for (int i = 0; i < 8; ++i) none.push_back(i);
+    runtime_assert(none.size(), 8, "inline without memory");
+    bool threw = false;
+    try { none.push_back(8); }
+    catch (const std::bad_alloc&) { threw = true; }
+    runtime_assert((threw && none.size() == 8), true, "spilling needs memory");
+    std::byte buffer[1024];
+    std::pmr::monotonic_buffer_resource arena(buffer, sizeof(buffer), std::pmr::null_memory_resource());
+    dattatypes::pmr::small_vector<int32_t, 2> arena_vec(&arena);
+    for (int i = 0; i < 100; ++i) arena_vec.push_back(i);
+    runtime_assert((arena_vec.back() == 99 && arena_vec.get_allocator().resource() == &arena), true, "spills into the arena");
+
+    LOG_WARN("Test {} - Random operations against std::vector", ++num);
+    mt19937 rng(22);
+    size_t mismatches = 0;
+    small_vector<uint8_t, 6> random;
+    vector<uint8_t> reference;
+    for (int op = 0; op < 5000; ++op) {
+        const size_t at = reference.empty() ? 0 : rng() % (reference.size() + 1);
+        const uint8_t values[3] = {uint8_t(rng()), uint8_t(rng()), uint8_t(rng())};
+        const size_t count = rng() % 4;
+        if (rng() % 2 && reference.size() < 40) {
+            random.insert(random.begin() + at, values, values + count);
+            reference.insert(reference.begin() + at, values, values + count);
+        }
+        else {
+            const size_t n = std::min(count, reference.size() - at);
+            random.erase(random.begin() + at, random.begin() + at + n);
+            reference.erase(reference.begin() + at, reference.begin() + at + n);
+        }
+        if (op % 97 == 0) random.shrink_to_fit();
+        mismatches += !std::equal(random.begin(), random.end(), reference.begin(), reference.end());
+    }
+    runtime_assert(mismatches, 0, "mismatches");
+
+
+    LOG_INFO("=== All tests for small_vector passed! ===\n\n");
+    return 0;
+}
@@ -1,6 +1,14 @@
 
 #include <iostream>
 #include <string>
+#include <vector>
+#include <random>
+#include <stdexcept>
+#include <memory_resource>
+#include <ranges>
+#include <limits>
+#include <thread>
+#include <atomic>
 
 #include "debug.hpp"
 #include "unlock_map.hpp"
@@ -21,6 +29,18 @@ enum class Number : int8_t {
     P_13, P_14, P_15, P_16, P_17, P_18
 };
 
+// The endpoints, the count and one pointer to the bitmap, rank index and search layout, allocated once needed
+static_assert(sizeof(unlock_map<Number>) == sizeof(std::vector<int8_t>) + 2 * sizeof(void*), "unlock_map footprint");
+static_assert(sizeof(unlock_map<Number, 8>) == sizeof(small_vector<int8_t, 8>) + 2 * sizeof(void*), "inline unlock_map footprint");
+
+// Counts the allocations passed on to the default resource
+struct CountingResource : std::pmr::memory_resource {
+    size_t allocations = 0;
+    void* do_allocate(size_t bytes, size_t alignment) override { ++allocations; return std::pmr::new_delete_resource()->allocate(bytes, alignment); }
+    void do_deallocate(void* p, size_t bytes, size_t alignment) override { std::pmr::new_delete_resource()->deallocate(p, bytes, alignment); }
+    bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override { return this == &other; }
+};
+
 std::string vec2str(const std::vector<int8_t>& vec) {
     std::string result = "[";
     for (size_t i = 0; i < vec.size(); ++i) {
@@ -119,12 +139,468 @@ int main() {
     runtime_assert(map._data.size(), 2, "datasize");
     runtime_assert(map.size(), 9, "size");
 
-    // LOG_WARN("Test {} - Range erase across upper", ++num);
-    // LOG_WARN("Test {} - Range erase across lower", ++num);
-    // LOG_WARN("Test {} - Single erase at upper", ++num);
-    // LOG_WARN("Test {} - Single erase at lower", ++num);
-    // LOG_WARN("Test {} - Single insert onto upper", ++num);
-    // LOG_WARN("Test {} - Single insert onto lower", ++num);
+    LOG_WARN("Test {} - Range erase across upper", ++num);
+    map.erase(Number::P_3, Number::P_8);
+    runtime_assert(vec2str(map._data), "[-4, 3]", "data");
+    runtime_assert(map.size(), 7, "size");
+
+    LOG_WARN("Test {} - Range erase across lower", ++num);
+    map.erase(Number::N_8, Number::N_3);
+    runtime_assert(vec2str(map._data), "[-2, 3]", "data");
+    runtime_assert(map.size(), 5, "size");
+
+    LOG_WARN("Test {} - Single erase at upper", ++num);
+    map.erase(Number::P_2);
+    runtime_assert(vec2str(map._data), "[-2, 2]", "data");
+    runtime_assert(map.size(), 4, "size");
+
+    LOG_WARN("Test {} - Single erase at lower", ++num);
+    map.erase(Number::N_2);
+    runtime_assert(vec2str(map._data), "[-1, 2]", "data");
+    runtime_assert(map.size(), 3, "size");
+
+    LOG_WARN("Test {} - Single insert onto upper", ++num);
+    map.insert(Number::P_2);
+    runtime_assert(vec2str(map._data), "[-1, 3]", "data");
+    runtime_assert(map.size(), 4, "size");
+
+    LOG_WARN("Test {} - Single insert onto lower", ++num);
+    map.insert(Number::N_2);
+    runtime_assert(vec2str(map._data), "[-2, 3]", "data");
+    runtime_assert(map.size(), 5, "size");
+
+    LOG_WARN("Test {} - Erase of a whole interval", ++num);
+    map.insert(Number::P_8, Number::P_9);
+    map.erase(Number::P_8, Number::P_9);
+    map.erase(Number::N_5, Number::N_2);
+    runtime_assert(vec2str(map._data), "[-1, 3]", "data");
+
+    LOG_WARN("Test {} - Bitmap when fragmented", ++num);
+    unlock_map<Number> fragmented;
+    for (int v = -18; v <= 18; v += 2) fragmented.insert(Number(v));
+    runtime_assert(fragmented.bitmap(), true, "bitmap()");
+    runtime_assert(fragmented.size(), 19, "size");
+    runtime_assert(fragmented.check(Number::N_18), true, "check(N_18)");
+    runtime_assert(fragmented.check(Number::N_17), false, "check(N_17)");
+    runtime_assert(fragmented.check(Number::P_18), true, "check(P_18)");
+    runtime_assert(fragmented.check(Number(100)), false, "check(100)");
+    fragmented.insert(Number::N_17, Number::P_17);
+    runtime_assert(fragmented.bitmap(), false, "intervals again once few");
+    runtime_assert(vec2str(fragmented._data), "[-18, 19]", "data");
+    for (int v = -17; v <= 17; v += 2) fragmented.erase(Number(v));
+    runtime_assert(fragmented.bitmap(), true, "bitmap again");
+    runtime_assert(vec2str(fragmented.intervals()).substr(0, 16), "[-18, -17, -16, ", "intervals()");
+
+    LOG_WARN("Test {} - Serialization as intervals", ++num);
+    struct Archive {
+        std::vector<int8_t> saved;
+        bool loading = false;
+        void operator()(std::vector<int8_t>& data) { if (loading) data = saved; else saved = data; }
+    } archive;
+    fragmented.serialize(archive);
+    runtime_assert(archive.saved.size(), 38, "saved intervals");
+    unlock_map<Number> loaded;
+    archive.loading = true;
+    loaded.serialize(archive);
+    runtime_assert(loaded.bitmap(), true, "loaded into a bitmap");
+    runtime_assert((loaded.intervals() == fragmented.intervals()), true, "loaded intervals");
+
+    LOG_WARN("Test {} - Random operations against a reference", ++num);
+    enum class Wide : int16_t {};
+    mt19937 rng(18);
+    size_t mismatches = 0, bitmap_steps = 0, steps = 0;
+    for (int range : {24, 600, 4000}) {
+        unlock_map<Wide> random;
+        vector<bool> reference(4100);
+        for (int op = 0; op < 3000; ++op, ++steps) {
+            const int a = int(rng() % range), b = std::min(4099, a + int(rng() % 40));
+            switch (rng() % 4) {
+                case 0: random.insert(Wide(a)); reference[a] = true; break;
+                case 1: random.erase(Wide(a)); reference[a] = false; break;
+                case 2: random.insert(Wide(a), Wide(b)); for (int i = a; i <= b; ++i) reference[i] = true; break;
+                default: random.erase(Wide(a), Wide(b)); for (int i = a; i <= b; ++i) reference[i] = false; break;
+            }
+            size_t count = 0;
+            for (int i = 0; i < 4100; i += 1 + op % 7) mismatches += (random.check(Wide(i)) != reference[i]);
+            for (const bool bit : reference) count += bit;
+            mismatches += (random.size() != count);
+            bitmap_steps += random.bitmap();
+        }
+    }
+    runtime_assert(mismatches, 0, "mismatches");
+    runtime_assert((bitmap_steps > 0 && bitmap_steps < steps), true, "both representations used");
+
+    LOG_WARN("Test {} - Fragmented loads grow the bitmap in place", ++num);
+    // Every insert lands just outside the bitmap; rebuilding it each time would allocate per insert
+    for (const int direction : {1, -1}) {
+        CountingResource growth;
+        dattatypes::pmr::unlock_map<Wide> loaded_map(&growth);
+        for (int i = 0; i < 10000; ++i) loaded_map.insert(Wide(direction * 3 * i));
+        runtime_assert((loaded_map.bitmap() && loaded_map.size() == 10000 && loaded_map.check(Wide(direction * 29997)) && !loaded_map.check(Wide(direction * 29996))), true, "fragmented load");
+        runtime_assert((growth.allocations < 64), true, "geometric growth, " + std::to_string(growth.allocations) + " allocations");
+    }
+
+
+    LOG_WARN("Test {} - Set algebra", ++num);
+    unlock_map<Number> unlocks(vector<int8_t>{-10, -5, 0, 4, 8, 12});
+    const unlock_map<Number> grants(vector<int8_t>{-6, -2, 4, 6, 11, 14});
+    const unlock_map<Number> revoked(vector<int8_t>{-8, 2});
+    runtime_assert(vec2str((unlocks | grants).intervals()), "[-10, -2, 0, 6, 8, 14]", "union");
+    runtime_assert(vec2str((unlocks & grants).intervals()), "[-6, -5, 11, 12]", "intersection");
+    runtime_assert(vec2str((unlocks - grants).intervals()), "[-10, -6, 0, 4, 8, 11]", "difference");
+    runtime_assert(vec2str((unlocks ^ grants).intervals()), "[-10, -6, -5, -2, 0, 6, 8, 11, 12, 14]", "symmetric difference");
+    runtime_assert(vec2str(((unlocks | grants) - revoked).intervals()), "[-10, -8, 2, 6, 8, 14]", "unlocks with grants minus revocations");
+    runtime_assert((unlocks | grants).includes(unlocks), true, "union includes");
+    runtime_assert(unlocks.includes(grants), false, "not includes");
+    runtime_assert(unlocks.includes(unlock_map<Number>()), true, "includes empty");
+    runtime_assert(unlocks.intersects(grants), true, "intersects");
+    runtime_assert(unlocks.intersects(unlock_map<Number>(vector<int8_t>{4, 8})), false, "touching does not intersect");
+    unlocks.reserve(32);
+    const int8_t* storage = unlocks._data.data();
+    unlocks |= grants;
+    runtime_assert(vec2str(unlocks._data), "[-10, -2, 0, 6, 8, 14]", "|=");
+    runtime_assert((unlocks._data.data() == storage), true, "|= in place");
+    unlocks ^= unlocks;
+    runtime_assert(unlocks.empty(), true, "x ^= x");
+
+    LOG_WARN("Test {} - Random set algebra against a reference", ++num);
+    mismatches = 0;
+    for (int trial = 0; trial < 200; ++trial) {
+        unlock_map<Wide> a, b;
+        vector<bool> in_a(512), in_b(512);
+        const int range = (trial & 1) ? 40 : 500;
+        for (int k = 0; k < 30; ++k) {
+            const int x = int(rng() % range), y = x + int(rng() % 12);
+            a.insert(Wide(x), Wide(y)); for (int i = x; i <= y; ++i) in_a[i] = true;
+            const int u = int(rng() % range), v = u + int(rng() % 12);
+            b.insert(Wide(u), Wide(v)); for (int i = u; i <= v; ++i) in_b[i] = true;
+        }
+        const unlock_map<Wide> both = a & b, either = a | b, only = a - b, one = a ^ b;
+        bool intersects = false, includes = true;
+        for (int i = 0; i < 512; ++i) {
+            mismatches += (both.check(Wide(i)) != (in_a[i] && in_b[i])) + (either.check(Wide(i)) != (in_a[i] || in_b[i]));
+            mismatches += (only.check(Wide(i)) != (in_a[i] && !in_b[i])) + (one.check(Wide(i)) != (in_a[i] != in_b[i]));
+            intersects |= in_a[i] && in_b[i];
+            includes &= in_a[i] || !in_b[i];
+        }
+        mismatches += (a.intersects(b) != intersects) + (a.includes(b) != includes) + !either.includes(a);
+    }
+    runtime_assert(mismatches, 0, "mismatches");
+
+
+    LOG_WARN("Test {} - Batch construction, insert and erase", ++num);
+    const vector<Number> saved{Number::P_5, Number::N_3, Number::P_4, Number::N_2, Number::P_5, Number::P_9, Number::N_4, Number::P_6};
+    const unlock_map<Number> profile = unlock_map<Number>::from_unsorted(saved);
+    runtime_assert(vec2str(profile.intervals()), "[-4, -1, 4, 7, 9, 10]", "from_unsorted");
+    unlock_map<Number> batch = profile;
+    batch.insert_batch(vector<Number>{Number::P_8, Number::P_7, Number::N_1, Number::N_10});
+    runtime_assert(vec2str(batch.intervals()), "[-10, -9, -4, 0, 4, 10]", "insert_batch");
+    batch.erase_batch(vector<Number>{Number::P_5, Number::N_10, Number::N_4, Number::P_9, Number::P_9});
+    runtime_assert(vec2str(batch.intervals()), "[-3, 0, 4, 5, 6, 9]", "erase_batch");
+    batch.insert_ranges(vector<pair<Number, Number>>{{Number::P_10, Number::P_12}, {Number::P_1, Number::P_5}, {Number::P_3, Number::ZERO}});
+    runtime_assert(vec2str(batch.intervals()), "[-3, 0, 1, 9, 10, 13]", "insert_ranges");
+    batch.erase_ranges(vector<pair<Number, Number>>{{Number::P_11, Number::P_18}, {Number::N_18, Number::N_2}, {Number::P_2, Number::P_3}});
+    runtime_assert(vec2str(batch.intervals()), "[-1, 0, 1, 2, 4, 9, 10, 11]", "erase_ranges");
+
+    LOG_WARN("Test {} - Random batches against a reference", ++num);
+    mismatches = 0;
+    for (int trial = 0; trial < 200; ++trial) {
+        const int range = (trial & 1) ? 60 : 3000;
+        vector<Wide> items(size_t(rng() % 300));
+        vector<bool> reference(3100);
+        for (auto& item : items) item = Wide(rng() % range), reference[size_t(item)] = true;
+        unlock_map<Wide> random = unlock_map<Wide>::from_unsorted(items);
+        vector<Wide> more(size_t(rng() % 100)), fewer(size_t(rng() % 100));
+        vector<pair<Wide, Wide>> ranges(size_t(rng() % 20)), holes(size_t(rng() % 20));
+        for (auto& item : more) item = Wide(rng() % range);
+        for (auto& item : fewer) item = Wide(rng() % range);
+        for (auto& [first, last] : ranges) first = Wide(rng() % range), last = Wide(int(first) + int(rng() % 10) - 2);
+        for (auto& [first, last] : holes) first = Wide(rng() % range), last = Wide(int(first) + int(rng() % 10) - 2);
+        random.insert_batch(more);
+        for (const auto item : more) reference[size_t(item)] = true;
+        random.insert_ranges(ranges);
+        for (const auto& [first, last] : ranges) for (int i = int(first); i <= int(last); ++i) reference[i] = true;
+        random.erase_batch(fewer);
+        for (const auto item : fewer) reference[size_t(item)] = false;
+        random.erase_ranges(holes);
+        for (const auto& [first, last] : holes) for (int i = int(first); i <= int(last); ++i) reference[i] = false;
+        size_t count = 0;
+        for (int i = 0; i < 3100; ++i) mismatches += (random.check(Wide(i)) != reference[i]), count += reference[i];
+        mismatches += (random.size() != count);
+    }
+    runtime_assert(mismatches, 0, "mismatches");
+
+    LOG_WARN("Test {} - Batches into a bitmap outside its window", ++num);
+    // A bitmap over [3000, 3600), then every third value below and above it, in random order
+    CountingResource window_growth;
+    dattatypes::pmr::unlock_map<Wide> windowed(&window_growth);
+    for (int v = 3000; v < 3600; v += 3) windowed.insert(Wide(v));
+    vector<Wide> outside;
+    for (int v = 0; v < 9000; v += 3) if (v < 3000 || v >= 3600) outside.push_back(Wide(v));
+    std::shuffle(outside.begin(), outside.end(), rng);
+    const size_t before_batch = window_growth.allocations;
+    windowed.insert_batch(outside);
+    runtime_assert((windowed.bitmap() && windowed.size() == 3000 && windowed.check(Wide(8997)) && !windowed.check(Wide(8998))), true, "insert_batch grows the bitmap");
+    runtime_assert((window_growth.allocations - before_batch <= 4), true, "grown once");
+    windowed.erase_batch(vector<Wide>{Wide(-30000), Wide(0), Wide(4500), Wide(30000)});
+    windowed.insert_ranges(vector<pair<Wide, Wide>>{{Wide(9001), Wide(9003)}});
+    runtime_assert((windowed.bitmap() && windowed.size() == 3001 && windowed.next_set(Wide(4500)) == Wide(4503) && windowed.next_set(Wide(8998)) == Wide(9001)), true, "erase_batch and insert_ranges");
+
+
+    LOG_WARN("Test {} - Rank, select and next", ++num);
+    const unlock_map<Number> ranked(vector<int8_t>{-10, -5, 0, 4, 8, 12});
+    runtime_assert(ranked.size(), 13, "size");
+    runtime_assert(ranked.rank(Number::N_18), 0, "rank below all");
+    runtime_assert(ranked.rank(Number::N_8), 2, "rank inside");
+    runtime_assert(ranked.rank(Number::N_1), 5, "rank in gap");
+    runtime_assert(ranked.rank(Number::P_18), 13, "rank above all");
+    runtime_assert(int(ranked.select(0)), -10, "select(0)");
+    runtime_assert(int(ranked.select(5)), 0, "select(5)");
+    runtime_assert(int(ranked.select(12)), 11, "select(12)");
+    bool threw = false;
+    try { ranked.select(13); }
+    catch (const std::runtime_error&) { threw = true; }
+    runtime_assert(threw, true, "select past size throws");
+    runtime_assert(int(*ranked.next_set(Number::N_4)), 0, "next_set in gap");
+    runtime_assert(int(*ranked.next_set(Number::P_2)), 2, "next_set inside");
+    runtime_assert(ranked.next_set(Number::P_12).has_value(), false, "next_set past all");
+    runtime_assert(int(*ranked.next_unset(Number::N_9)), -5, "next_unset inside");
+    runtime_assert(int(*ranked.next_unset(Number::P_5)), 5, "next_unset in gap");
+
+    LOG_WARN("Test {} - Random order statistics against a reference", ++num);
+    mismatches = 0;
+    for (int trial = 0; trial < 100; ++trial) {
+        const int range = (trial & 1) ? 60 : 3000;
+        vector<Wide> items(size_t(rng() % 600));
+        vector<bool> reference(3200);
+        for (auto& item : items) item = Wide(rng() % range), reference[size_t(item)] = true;
+        const unlock_map<Wide> random = unlock_map<Wide>::from_unsorted(items);
+        vector<int> values;
+        for (int i = 0; i < 3200; ++i) if (reference[i]) values.push_back(i);
+        for (size_t k = 0; k < values.size(); k += 1 + k % 5) mismatches += (int(random.select(k)) != values[k]);
+        size_t below = 0;
+        for (int i = 0; i < 3100; ++i) {
+            mismatches += (random.rank(Wide(i)) != below);
+            below += reference[i];
+            int set = i, unset = i;
+            while (set < 3200 && !reference[set]) ++set;
+            while (reference[unset]) ++unset;
+            const auto next = random.next_set(Wide(i));
+            mismatches += (set < 3200) ? (!next || int(*next) != set) : next.has_value();
+            mismatches += (int(*random.next_unset(Wide(i))) != unset);
+        }
+    }
+    runtime_assert(mismatches, 0, "mismatches");
+
+
+    LOG_WARN("Test {} - Batch checks against a reference", ++num);
+    mismatches = 0;
+    for (int trial = 0; trial < 40; ++trial) {
+        // Sparse intervals across negative and positive values, so the endpoints stay intervals above the search threshold
+        unlock_map<Wide> sparse;
+        vector<bool> reference(20000);
+        const int intervals = 1 + int(rng() % 400);
+        for (int i = 0; i < intervals; ++i) {
+            const int a = int(rng() % 19900), b = a + int(rng() % 6);
+            sparse.insert(Wide(a - 10000), Wide(b - 10000));
+            for (int v = a; v <= b; ++v) reference[v] = true;
+        }
+        vector<Wide> items(size_t(rng() % 1000));
+        for (auto& item : items) item = Wide(int(rng() % 20000) - 10000);
+        items.insert(items.end(), {Wide(-10000), Wide(9999), Wide(sparse.intervals().front()), Wide(sparse.intervals().back())});
+        vector<char> singles(items.size());
+        for (size_t i = 0; i < items.size(); ++i) singles[i] = sparse.check(items[i]);
+        bool results[1100];
+        sparse.check_batch(items, span<bool>(results, items.size()));
+        for (size_t i = 0; i < items.size(); ++i)
+            mismatches += (results[i] != reference[size_t(int(items[i]) + 10000)]) + (results[i] != bool(singles[i]));
+        // check through the layout, then after a change drops it
+        for (size_t i = 0; i < items.size(); ++i) mismatches += (sparse.check(items[i]) != results[i]);
+        sparse.erase(items[0]);
+        reference[size_t(int(items[0]) + 10000)] = false;
+        sparse.check_batch(items, span<bool>(results, items.size()));
+        for (size_t i = 0; i < items.size(); ++i) mismatches += (results[i] != reference[size_t(int(items[i]) + 10000)]);
+        mismatches += sparse.bitmap();
+    }
+    runtime_assert(mismatches, 0, "mismatches");
+    threw = false;
+    try { bool one[1]; ranked.check_batch(vector<Number>{Number::ZERO, Number::P_1}, one); }
+    catch (const std::runtime_error&) { threw = true; }
+    runtime_assert(threw, true, "mismatched sizes throw");
+
+    LOG_WARN("Test {} - Concurrent const queries", ++num);
+    // Readers check one by one while others build the search layout and rank index of the same unchanged map
+    unlock_map<Wide> shared_map;
+    vector<bool> shared_reference(20000);
+    for (int i = 0; i < 300; ++i) {
+        const int a = 40 * i + int(rng() % 20);
+        shared_map.insert(Wide(a - 10000), Wide(a - 10000 + 5));
+        for (int v = a; v <= a + 5; ++v) shared_reference[v] = true;
+    }
+    atomic<size_t> concurrent_mismatches{0};
+    for (int round = 0; round < 20; ++round) {
+        shared_map.erase(Wide(40 * round - 10000));  // Drops the layout and index
+        shared_reference[size_t(40 * round)] = false;
+        vector<thread> queries;
+        for (int t = 0; t < 4; ++t)
+            queries.emplace_back([&, t] {
+                size_t bad = 0;
+                vector<Wide> items(256);
+                for (size_t i = 0; i < items.size(); ++i) items[i] = Wide(int((i * 7919 + size_t(t) * 104729) % 20000) - 10000);
+                bool results[256];
+                if (t & 1) shared_map.check_batch(items, span<bool>(results, items.size()));
+                else (void)shared_map.rank(Wide(0));
+                for (size_t i = 0; i < items.size(); ++i) bad += (shared_map.check(items[i]) != shared_reference[size_t(int(items[i]) + 10000)]);
+                if (t & 1) for (size_t i = 0; i < items.size(); ++i) bad += (results[i] != shared_reference[size_t(int(items[i]) + 10000)]);
+                concurrent_mismatches += bad;
+            });
+        for (auto& query : queries) query.join();
+    }
+    runtime_assert(concurrent_mismatches.load(), size_t(0), "mismatches");
+
+
+    LOG_WARN("Test {} - Views", ++num);
+    string listed;
+    for (const auto [first, last] : ranked.covered_intervals()) listed += to_string(int(first)) + ".." + to_string(int(last)) + " ";
+    runtime_assert(listed, "-10..-6 0..3 8..11 ", "covered_intervals");
+    listed.clear();
+    for (const auto value : ranked.covered_values() | views::filter([](Number v) { return int(v) % 2 == 0; })) listed += to_string(int(value)) + " ";
+    runtime_assert(listed, "-10 -8 -6 0 2 8 10 ", "covered_values, filtered");
+    runtime_assert(size_t(ranges::distance(ranked.covered_values())), ranked.size(), "as many values as size()");
+    runtime_assert(ranges::empty(unlock_map<Number>().covered_values()), true, "empty view");
+    const unlock_map<Number> with_empty(vector<int8_t>{-3, -3, 1, 2, 4, 4});
+    runtime_assert(ranges::distance(with_empty.covered_intervals()), 1, "empty intervals skipped");
+    runtime_assert(int((*with_empty.covered_intervals().begin()).first), 1, "first non-empty interval");
+    mismatches = 0;
+    for (int trial = 0; trial < 100; ++trial) {
+        unlock_map<Wide> random;
+        for (int k = 0; k < 60; ++k) {
+            const int a = int(rng() % ((trial & 1) ? 200 : 5000)), b = a + int(rng() % 5);
+            if (rng() % 3) random.insert(Wide(a), Wide(b));
+            else random.erase(Wide(a), Wide(b));
+        }
+        vector<int16_t> endpoints, values;
+        for (const auto [first, last] : random.covered_intervals()) endpoints.insert(endpoints.end(), {int16_t(first), int16_t(int(last) + 1)});
+        for (int i = 0; i < 5010; ++i) if (random.check(Wide(i))) values.push_back(int16_t(i));
+        size_t i = 0;
+        for (const auto value : random.covered_values()) mismatches += (i >= values.size() || int16_t(value) != values[i++]);
+        mismatches += (endpoints != random.intervals()) + (i != values.size());
+    }
+    runtime_assert(mismatches, 0, "views against intervals() and check(), in both representations");
+
+    LOG_WARN("Test {} - Compact encoding", ++num);
+    const vector<uint8_t> encoded = ranked.encode();
+    runtime_assert(encoded.size(), 7, "1 + 2 bytes per close interval");
+    unlock_map<Number> decoded;
+    runtime_assert(decoded.decode(encoded), 7, "bytes read");
+    runtime_assert((decoded.intervals() == ranked.intervals() && decoded.size() == ranked.size()), true, "round trip");
+    enum class Big : int64_t {};
+    enum class Code : uint32_t {};
+    unlock_map<Big> extremes;
+    extremes.insert(Big(numeric_limits<int64_t>::min()), Big(numeric_limits<int64_t>::min() + 2));
+    extremes.insert(Big(-1), Big(1));
+    extremes.insert(Big(numeric_limits<int64_t>::max() - 1));
+    unlock_map<Big> extremes_decoded;
+    extremes_decoded.decode(extremes.encode());
+    runtime_assert((extremes_decoded.intervals() == extremes.intervals()), true, "64-bit extremes");
+    unlock_map<Code> codes;
+    for (uint32_t i = 0; i < 1000; ++i) codes.insert(Code(4000000000u + 7 * i), Code(4000000000u + 7 * i + 2));
+    vector<uint8_t> stream = codes.encode();
+    const size_t first_size = stream.size();
+    ranked.encode(stream);
+    runtime_assert((first_size < 2 * 1000 * 2 + 8), true, "under 2 bytes an endpoint, against 4");
+    unlock_map<Code> codes_decoded;
+    runtime_assert(codes_decoded.decode(stream), first_size, "stops after its own encoding");
+    decoded.decode(span<const uint8_t>(stream).subspan(first_size));
+    runtime_assert((codes_decoded.intervals() == codes.intervals() && decoded.intervals() == ranked.intervals()), true, "concatenated");
+    mismatches = 0;
+    for (int trial = 0; trial < 200; ++trial) {
+        unlock_map<Wide> random;
+        for (int k = 0; k < 40; ++k) {
+            const int a = int(rng() % 60000) - 30000, b = a + int(rng() % 40);
+            if (rng() % 4) random.insert(Wide(a), Wide(b));
+            else random.erase(Wide(a), Wide(b));
+        }
+        unlock_map<Wide> round_trip;
+        round_trip.insert(Wide(5));
+        mismatches += (round_trip.decode(random.encode()) != random.encode().size());
+        mismatches += (round_trip.intervals() != random.intervals()) + (round_trip.size() != random.size());
+    }
+    runtime_assert(mismatches, 0, "random round trips");
+    size_t rejected = 0;
+    for (const vector<uint8_t>& malformed : vector<vector<uint8_t>>{
+             {}, {2, 4, 1}, {1, 0x80}, {0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0x02}, {1, 2, 0x80, 0x02}, {2, 0, 0, 0x80, 0x01, 0}}) {
+        try { decoded.decode(malformed); }
+        catch (const std::runtime_error&) { rejected += decoded.empty(); }
+    }
+    runtime_assert(rejected, 6, "malformed encodings throw and leave the map empty");
+
+
+    LOG_WARN("Test {} - Inline storage", ++num);
+    unlock_map<Number, 4> small;
+    small.insert(Number::N_4, Number::N_1);
+    small.insert(Number::P_4, Number::P_6);
+    runtime_assert(small._data.is_inline(), true, "two intervals inline");
+    runtime_assert(vec2str(small.intervals()), "[-4, 0, 4, 7]", "inline intervals");
+    small.insert(Number::P_10);
+    runtime_assert(small._data.is_inline(), false, "spills on the third");
+    runtime_assert(vec2str(small.intervals()), "[-4, 0, 4, 7, 10, 11]", "spilled intervals");
+    small.erase(Number::P_10);
+    small.shrink_to_fit();
+    runtime_assert(small._data.is_inline(), true, "back inline once it fits");
+    unlock_map<Number, 4> moved = std::move(small);
+    const unlock_map<Number, 4> copied = moved;
+    runtime_assert((moved.intervals() == copied.intervals() && copied.check(Number::P_5)), true, "copy and move inline");
+    runtime_assert(vec2str((copied | unlock_map<Number, 4>(vector<int8_t>{-1, 4})).intervals()), "[-4, 7]", "inline set algebra");
+
+    LOG_WARN("Test {} - Allocators", ++num);
+    CountingResource counting;
+    dattatypes::pmr::unlock_map<Number, 8> counted(&counting);
+    counted.insert(Number::N_10, Number::N_8);
+    counted.insert(Number::ZERO);
+    counted.insert(Number::P_5, Number::P_9);
+    counted.erase(Number::P_7);
+    runtime_assert(counting.allocations, 0, "no allocation while inline");
+    runtime_assert((counted.get_allocator().resource() == &counting), true, "get_allocator");
+    counted.insert_batch(vector<Number>{Number::N_15, Number::P_15});
+    runtime_assert((counting.allocations > 0), true, "spills to the resource");
+    // A whole world in a fixed arena, which throws if it runs out
+    std::byte buffer[1 << 14];
+    mismatches = 0;
+    {
+        std::pmr::monotonic_buffer_resource arena(buffer, sizeof(buffer), std::pmr::null_memory_resource());
+        dattatypes::pmr::unlock_map<Wide> world(&arena), other(&arena);
+        unlock_map<Wide> reference;
+        for (int op = 0; op < 300; ++op) {
+            const int a = int(rng() % 500), b = a + int(rng() % 8);
+            if (rng() % 3) world.insert(Wide(a), Wide(b)), reference.insert(Wide(a), Wide(b));
+            else world.erase(Wide(a), Wide(b)), reference.erase(Wide(a), Wide(b));
+            if (op % 50 == 0) other.insert(Wide(a));
+        }
+        world -= other;
+        reference -= unlock_map<Wide>(other.intervals());
+        mismatches += (world.intervals() != reference.intervals()) + (world.size() != reference.size());
+        mismatches += (world.get_allocator().resource() != &arena);
+    }
+    runtime_assert(mismatches, 0, "arena world against the default allocator");
+
+    LOG_WARN("Test {} - Random inline operations against the default storage", ++num);
+    mismatches = 0;
+    for (int trial = 0; trial < 50; ++trial) {
+        unlock_map<Wide, 6> inline_map;
+        unlock_map<Wide> reference;
+        for (int op = 0; op < 200; ++op) {
+            const int a = int(rng() % ((trial & 1) ? 30 : 600)), b = a + int(rng() % 6);
+            switch (rng() % 4) {
+                case 0: inline_map.insert(Wide(a)), reference.insert(Wide(a)); break;
+                case 1: inline_map.erase(Wide(a)), reference.erase(Wide(a)); break;
+                case 2: inline_map.insert(Wide(a), Wide(b)), reference.insert(Wide(a), Wide(b)); break;
+                default: inline_map.erase(Wide(a), Wide(b)), reference.erase(Wide(a), Wide(b)); break;
+            }
+            mismatches += (inline_map.intervals() != reference.intervals()) + (inline_map.size() != reference.size());
+        }
+    }
+    runtime_assert(mismatches, 0, "mismatches");
 
 
     LOG_INFO("=== All tests for unlock_map passed! ===\n\n");